@@ -0,0 +1,224 @@
+#include "gc_core.h"
+
+#include <stdlib.h>
+
+// grows a gc_circuit gate by gate; any allocation failure or wire overflow
+// sets failed and later gates become no-ops
+typedef struct {
+    gc_circuit *c;
+    size_t      cap;
+    int         failed;
+} gc_builder;
+
+static int gc_builder_init(gc_builder *b, gc_wire_id n_inputs, gc_wire_id n_outputs) {
+    b->cap = 0;
+    b->failed = 0;
+    b->c = (gc_circuit *)calloc(1, sizeof(gc_circuit));
+    if (!b->c) {
+        return -1;
+    }
+
+    b->c->n_wires   = n_inputs;
+    b->c->n_inputs  = n_inputs;
+    b->c->n_outputs = n_outputs;
+    b->c->input_wires  = (gc_wire_id *)calloc(n_inputs, sizeof(gc_wire_id));
+    b->c->output_wires = (gc_wire_id *)calloc(n_outputs, sizeof(gc_wire_id));
+    if (!b->c->input_wires || !b->c->output_wires) {
+        gc_circuit_free(b->c);
+        b->c = NULL;
+        return -1;
+    }
+    for (gc_wire_id i = 0; i < n_inputs; ++i) {
+        b->c->input_wires[i] = i;
+    }
+    return 0;
+}
+
+static gc_circuit *gc_builder_finish(gc_builder *b) {
+    if (b->failed) {
+        gc_circuit_free(b->c);
+        return NULL;
+    }
+    return b->c;
+}
+
+static gc_wire_id gc_builder_gate(gc_builder *b, gc_gate_type type, gc_wire_id x, gc_wire_id y) {
+    gc_circuit *c = b->c;
+    if (b->failed) {
+        return 0;
+    }
+    if (c->n_wires == GC_WIRE_ID_MAX) {
+        b->failed = 1;
+        return 0;
+    }
+    if (c->n_gates == b->cap) {
+        size_t cap = b->cap ? 2 * b->cap : 64;
+        gc_gate *gates = (gc_gate *)realloc(c->gates, cap * sizeof(gc_gate));
+        if (!gates) {
+            b->failed = 1;
+            return 0;
+        }
+        c->gates = gates;
+        b->cap = cap;
+    }
+
+    gc_wire_id out = c->n_wires++;
+    c->gates[c->n_gates++] = (gc_gate){ x, (type == GC_GATE_NOT) ? 0 : y, out, type };
+    return out;
+}
+
+// reduces w[0..n) with a balanced tree of 2-input gates, n - 1 gates at
+// depth ceil(log2 n). w is used as scratch.
+static gc_wire_id gc_builder_tree(gc_builder *b, gc_gate_type type, gc_wire_id *w, size_t n) {
+    while (n > 1) {
+        size_t half = n / 2;
+        for (size_t i = 0; i < half; ++i) {
+            w[i] = gc_builder_gate(b, type, w[2 * i], w[2 * i + 1]);
+        }
+        if (n & 1u) {
+            w[half] = w[n - 1];
+        }
+        n = half + (n & 1u);
+    }
+    return w[0];
+}
+
+// AND over the XNORs of not_a[i] ^ b_i, b_i = b0 + i. the caller shares
+// NOT a across comparisons, so no per-comparison NOT gates are needed.
+static gc_wire_id gc_builder_eq(
+    gc_builder       *b,
+    const gc_wire_id *not_a,
+    gc_wire_id        b0,
+    gc_wire_id        k,
+    gc_wire_id       *scratch
+) {
+    for (gc_wire_id i = 0; i < k; ++i) {
+        scratch[i] = gc_builder_gate(b, GC_GATE_XOR, not_a[i], (gc_wire_id)(b0 + i));
+    }
+    return gc_builder_tree(b, GC_GATE_AND, scratch, k);
+}
+
+static int gc_builder_fits(size_t n_inputs) {
+    return n_inputs > 0 && n_inputs < GC_WIRE_ID_MAX;
+}
+
+gc_circuit *gc_circuit_eq(gc_wire_id k) {
+    return gc_circuit_member(k, 1, 1);
+}
+
+gc_circuit *gc_circuit_member(gc_wire_id k, gc_wire_id m, int distinct) {
+    if (k == 0 || m == 0 || !gc_builder_fits((size_t)k * ((size_t)m + 1))) {
+        return NULL;
+    }
+
+    gc_builder b;
+    if (gc_builder_init(&b, (gc_wire_id)(k * (m + 1)), 1) != 0) {
+        return NULL;
+    }
+    gc_wire_id *not_a = (gc_wire_id *)malloc((size_t)k * sizeof(gc_wire_id));
+    gc_wire_id *eqs   = (gc_wire_id *)malloc((size_t)m * sizeof(gc_wire_id));
+    gc_wire_id *tmp   = (gc_wire_id *)malloc((size_t)k * sizeof(gc_wire_id));
+    if (!not_a || !eqs || !tmp) {
+        b.failed = 1;
+    }
+
+    for (gc_wire_id i = 0; i < k && !b.failed; ++i) {
+        not_a[i] = gc_builder_gate(&b, GC_GATE_NOT, i, 0);
+    }
+    for (gc_wire_id j = 0; j < m && !b.failed; ++j) {
+        eqs[j] = gc_builder_eq(&b, not_a, (gc_wire_id)(k * (j + 1)), k, tmp);
+    }
+
+    gc_wire_id out = 0;
+    if (b.failed) {
+        // nothing to wire up
+    } else if (m == 1) {
+        out = eqs[0];
+    } else if (distinct) {
+        // at most one equality holds, so OR is XOR and costs nothing
+        out = gc_builder_tree(&b, GC_GATE_XOR, eqs, m);
+    } else {
+        // OR = NOT(AND(NOT ...)): the NOTs are free and keep the tree one
+        // AND deep per level
+        for (gc_wire_id j = 0; j < m; ++j) {
+            eqs[j] = gc_builder_gate(&b, GC_GATE_NOT, eqs[j], 0);
+        }
+        out = gc_builder_tree(&b, GC_GATE_AND, eqs, m);
+        out = gc_builder_gate(&b, GC_GATE_NOT, out, 0);
+    }
+    if (!b.failed) {
+        b.c->output_wires[0] = out;
+    }
+
+    free(not_a);
+    free(eqs);
+    free(tmp);
+    return gc_builder_finish(&b);
+}
+
+// x > y by a tree over bit ranges. a range carries (g, e) = (x > y on the
+// range, x == y on the range); joining hi and lo gives
+//   g = g_hi ^ (e_hi & g_lo)    (g_hi and e_hi never both hold)
+//   e = e_hi & e_lo
+// ranges at index 0 of a layer only ever join as lo, so their e is never
+// read and is not built.
+static gc_circuit *gc_circuit_compare(gc_wire_id k, int swap) {
+    if (k == 0 || !gc_builder_fits(2 * (size_t)k)) {
+        return NULL;
+    }
+
+    gc_builder b;
+    if (gc_builder_init(&b, (gc_wire_id)(2 * k), 1) != 0) {
+        return NULL;
+    }
+    gc_wire_id *g = (gc_wire_id *)malloc((size_t)k * sizeof(gc_wire_id));
+    gc_wire_id *e = (gc_wire_id *)malloc((size_t)k * sizeof(gc_wire_id));
+    if (!g || !e) {
+        b.failed = 1;
+    }
+
+    const gc_wire_id x0 = swap ? k : 0;
+    const gc_wire_id y0 = swap ? 0 : k;
+    for (gc_wire_id i = 0; i < k && !b.failed; ++i) {
+        gc_wire_id x = (gc_wire_id)(x0 + i), y = (gc_wire_id)(y0 + i);
+        g[i] = gc_builder_gate(&b, GC_GATE_AND, x,
+                               gc_builder_gate(&b, GC_GATE_NOT, y, 0));
+        if (i > 0) {
+            e[i] = gc_builder_gate(&b, GC_GATE_XOR,
+                                   gc_builder_gate(&b, GC_GATE_NOT, x, 0), y);
+        }
+    }
+
+    size_t n = b.failed ? 0 : k;
+    while (n > 1) {
+        size_t half = n / 2;
+        for (size_t j = 0; j < half; ++j) {
+            size_t lo = 2 * j, hi = 2 * j + 1;
+            gc_wire_id t = gc_builder_gate(&b, GC_GATE_AND, e[hi], g[lo]);
+            g[j] = gc_builder_gate(&b, GC_GATE_XOR, g[hi], t);
+            if (j > 0) {
+                e[j] = gc_builder_gate(&b, GC_GATE_AND, e[hi], e[lo]);
+            }
+        }
+        if (n & 1u) {
+            g[half] = g[n - 1];
+            e[half] = e[n - 1];
+        }
+        n = half + (n & 1u);
+    }
+    if (!b.failed) {
+        b.c->output_wires[0] = g[0];
+    }
+
+    free(g);
+    free(e);
+    return gc_builder_finish(&b);
+}
+
+gc_circuit *gc_circuit_gt(gc_wire_id k) {
+    return gc_circuit_compare(k, 0);
+}
+
+gc_circuit *gc_circuit_lt(gc_wire_id k) {
+    return gc_circuit_compare(k, 1);
+}
@@ -0,0 +1,298 @@
+// socketpair, MSG_NOSIGNAL and friends are POSIX, hidden by -std=c11
+#define _POSIX_C_SOURCE 200809L
+
+#include "gc_channel.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define GC_CHANNEL_MEM_DEFAULT (1u << 20)
+
+int gc_channel_send(gc_channel *ch, const void *buf, size_t len) {
+    if (!ch || !ch->send || (!buf && len)) {
+        return -1;
+    }
+    if (len == 0) {
+        return 0;
+    }
+    if (ch->send(ch->user, buf, len) != 0) {
+        return -4;
+    }
+    ch->bytes_sent += len;
+    return 0;
+}
+
+int gc_channel_recv(gc_channel *ch, void *buf, size_t len) {
+    if (!ch || !ch->recv || (!buf && len)) {
+        return -1;
+    }
+    if (len == 0) {
+        return 0;
+    }
+    if (ch->recv(ch->user, buf, len) != 0) {
+        return -4;
+    }
+    ch->bytes_received += len;
+    return 0;
+}
+
+void gc_channel_close(gc_channel *ch) {
+    if (!ch) return;
+    if (ch->close) {
+        ch->close(ch->user);
+    }
+    ch->send  = NULL;
+    ch->recv  = NULL;
+    ch->close = NULL;
+    ch->user  = NULL;
+}
+
+// ---- in-process ----
+
+// one direction of the pair
+typedef struct {
+    uint8_t *buf;
+    size_t   head;      // next byte to read
+    size_t   len;       // bytes buffered
+} gc_mem_ring;
+
+// shared by both ends. end e writes ring[e] and reads ring[1 - e]; the
+// link is freed when both ends have closed.
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  changed;
+    gc_mem_ring     ring[2];
+    size_t          cap;
+    int             open[2];
+} gc_mem_link;
+
+typedef struct {
+    gc_mem_link *link;
+    int          side;
+} gc_mem_end;
+
+static int gc_mem_send(void *user, const void *buf, size_t len) {
+    gc_mem_end *end = (gc_mem_end *)user;
+    gc_mem_link *l = end->link;
+    gc_mem_ring *r = &l->ring[end->side];
+    const uint8_t *p = (const uint8_t *)buf;
+
+    pthread_mutex_lock(&l->lock);
+    while (len > 0) {
+        while (r->len == l->cap && l->open[1 - end->side]) {
+            pthread_cond_wait(&l->changed, &l->lock);
+        }
+        if (!l->open[1 - end->side]) {
+            pthread_mutex_unlock(&l->lock);
+            return -4;
+        }
+        // the free space may wrap; copy up to the end of the buffer first
+        size_t tail = (r->head + r->len) % l->cap;
+        size_t n = l->cap - r->len;
+        if (n > l->cap - tail) {
+            n = l->cap - tail;
+        }
+        if (n > len) {
+            n = len;
+        }
+        memcpy(r->buf + tail, p, n);
+        r->len += n;
+        p += n;
+        len -= n;
+        pthread_cond_broadcast(&l->changed);
+    }
+    pthread_mutex_unlock(&l->lock);
+    return 0;
+}
+
+static int gc_mem_recv(void *user, void *buf, size_t len) {
+    gc_mem_end *end = (gc_mem_end *)user;
+    gc_mem_link *l = end->link;
+    gc_mem_ring *r = &l->ring[1 - end->side];
+    uint8_t *p = (uint8_t *)buf;
+
+    pthread_mutex_lock(&l->lock);
+    while (len > 0) {
+        while (r->len == 0 && l->open[1 - end->side]) {
+            pthread_cond_wait(&l->changed, &l->lock);
+        }
+        if (r->len == 0) {
+            pthread_mutex_unlock(&l->lock);
+            return -4;
+        }
+        size_t n = r->len;
+        if (n > l->cap - r->head) {
+            n = l->cap - r->head;
+        }
+        if (n > len) {
+            n = len;
+        }
+        memcpy(p, r->buf + r->head, n);
+        r->head = (r->head + n) % l->cap;
+        r->len -= n;
+        p += n;
+        len -= n;
+        pthread_cond_broadcast(&l->changed);
+    }
+    pthread_mutex_unlock(&l->lock);
+    return 0;
+}
+
+static void gc_mem_link_free(gc_mem_link *l) {
+    pthread_cond_destroy(&l->changed);
+    pthread_mutex_destroy(&l->lock);
+    free(l->ring[0].buf);
+    free(l->ring[1].buf);
+    free(l);
+}
+
+static void gc_mem_close(void *user) {
+    gc_mem_end *end = (gc_mem_end *)user;
+    gc_mem_link *l = end->link;
+
+    pthread_mutex_lock(&l->lock);
+    l->open[end->side] = 0;
+    const int last = !l->open[1 - end->side];
+    pthread_cond_broadcast(&l->changed);
+    pthread_mutex_unlock(&l->lock);
+
+    free(end);
+    if (last) {
+        gc_mem_link_free(l);
+    }
+}
+
+int gc_channel_mem_pair(gc_channel *a, gc_channel *b, size_t capacity) {
+    if (!a || !b) {
+        return -1;
+    }
+    memset(a, 0, sizeof(*a));
+    memset(b, 0, sizeof(*b));
+    if (capacity == 0) {
+        capacity = GC_CHANNEL_MEM_DEFAULT;
+    }
+
+    gc_mem_link *l = (gc_mem_link *)calloc(1, sizeof(gc_mem_link));
+    gc_mem_end *ends[2] = {
+        (gc_mem_end *)malloc(sizeof(gc_mem_end)),
+        (gc_mem_end *)malloc(sizeof(gc_mem_end)),
+    };
+    if (!l || !ends[0] || !ends[1]) {
+        goto fail;
+    }
+    l->ring[0].buf = (uint8_t *)malloc(capacity);
+    l->ring[1].buf = (uint8_t *)malloc(capacity);
+    if (!l->ring[0].buf || !l->ring[1].buf || pthread_mutex_init(&l->lock, NULL) != 0) {
+        goto fail;
+    }
+    if (pthread_cond_init(&l->changed, NULL) != 0) {
+        pthread_mutex_destroy(&l->lock);
+        goto fail;
+    }
+    l->cap = capacity;
+
+    gc_channel *chans[2] = { a, b };
+    for (int e = 0; e < 2; ++e) {
+        l->open[e]       = 1;
+        ends[e]->link    = l;
+        ends[e]->side    = e;
+        chans[e]->send   = gc_mem_send;
+        chans[e]->recv   = gc_mem_recv;
+        chans[e]->close  = gc_mem_close;
+        chans[e]->user   = ends[e];
+    }
+    return 0;
+
+fail:
+    if (l) {
+        free(l->ring[0].buf);
+        free(l->ring[1].buf);
+    }
+    free(l);
+    free(ends[0]);
+    free(ends[1]);
+    return -3;
+}
+
+// ---- file descriptors ----
+
+static int gc_fd_send(void *user, const void *buf, size_t len) {
+    const int fd = (int)(intptr_t)user;
+    const uint8_t *p = (const uint8_t *)buf;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == ENOTSOCK) {
+            n = write(fd, p, len);
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -4;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int gc_fd_recv(void *user, void *buf, size_t len) {
+    const int fd = (int)(intptr_t)user;
+    uint8_t *p = (uint8_t *)buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -4;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void gc_fd_close(void *user) {
+    close((int)(intptr_t)user);
+}
+
+int gc_channel_fd(gc_channel *ch, int fd) {
+    if (!ch || fd < 0) {
+        return -1;
+    }
+    memset(ch, 0, sizeof(*ch));
+    ch->send  = gc_fd_send;
+    ch->recv  = gc_fd_recv;
+    ch->close = gc_fd_close;
+    ch->user  = (void *)(intptr_t)fd;
+    return 0;
+}
+
+int gc_channel_socketpair(gc_channel *a, gc_channel *b) {
+    if (!a || !b) {
+        return -1;
+    }
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        return -4;
+    }
+    gc_channel_fd(a, fds[0]);
+    gc_channel_fd(b, fds[1]);
+    return 0;
+}
+
+// ---- garbled table streams ----
+
+int gc_channel_table_sink(void *user, const gc_label *ct, size_t n_ct) {
+    return gc_channel_send((gc_channel *)user, ct, n_ct * sizeof(gc_label));
+}
+
+int gc_channel_table_source(void *user, gc_label *ct, size_t n_ct) {
+    return gc_channel_recv((gc_channel *)user, ct, n_ct * sizeof(gc_label));
+}
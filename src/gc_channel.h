@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gc_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// a reliable, ordered byte stream to the other party of a two-party
+// protocol. send and recv block until all len bytes are written or read
+// and return non-zero if the peer is gone or the transport fails; close
+// releases the transport. any transport fits by filling in the callbacks.
+// bytes_sent and bytes_received count what went through
+// gc_channel_send / gc_channel_recv.
+//
+// each end is used by one thread, so the two parties of a protocol run on
+// two threads (or processes) rather than taking turns on one.
+typedef struct {
+    int  (*send)(void *user, const void *buf, size_t len);
+    int  (*recv)(void *user, void *buf, size_t len);
+    void (*close)(void *user);
+    void *user;
+
+    uint64_t bytes_sent;
+    uint64_t bytes_received;
+} gc_channel;
+
+// return 0, or -4 if the transport fails
+int gc_channel_send(gc_channel *ch, const void *buf, size_t len);
+
+int gc_channel_recv(gc_channel *ch, void *buf, size_t len);
+
+// closes the transport; the peer's pending and later calls then fail
+// instead of blocking. safe on a zeroed or already closed channel.
+void gc_channel_close(gc_channel *ch);
+
+// both ends of an in-process channel: each direction is a ring buffer of
+// capacity bytes (0 for 1 MiB) under a mutex, and a send that finds it
+// full waits for the peer to read. -3 on allocation failure.
+int gc_channel_mem_pair(gc_channel *a, gc_channel *b, size_t capacity);
+
+// a connected stream socket or pipe; close closes fd. sends on a socket
+// whose peer is gone fail rather than raise SIGPIPE.
+int gc_channel_fd(gc_channel *ch, int fd);
+
+// both ends of a Unix-domain socketpair, e.g. to measure the kernel's
+// share of a protocol's cost on one box. -4 if socketpair fails.
+int gc_channel_socketpair(gc_channel *a, gc_channel *b);
+
+// gc_table_sink / gc_table_source over a gc_channel passed as user, so
+// gc_garble_stream and gc_eval_stream can talk through one
+int gc_channel_table_sink(void *user, const gc_label *ct, size_t n_ct);
+
+int gc_channel_table_source(void *user, gc_label *ct, size_t n_ct);
+
+#ifdef __cplusplus
+}
+#endif
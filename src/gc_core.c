@@ -1,19 +1,34 @@
+// getentropy is a POSIX/BSD extension hidden by -std=c11
+#define _DEFAULT_SOURCE
+
 #include "gc_core.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <sys/random.h>
+#endif
 
-#include "psi_hash_blake3.h"
-#include "blake3.h"
+#include "gc_internal.h"
+#include "gc_prf.h"
 
-static void secure_memzero(void *p, size_t len) {
+// one bulk memset the compiler may not drop: the empty asm makes the buffer
+// look observed afterwards
+void gc_secure_memzero(void *p, size_t len) {
     if (!p || len == 0) {
         return;
     }
+#if defined(__GNUC__) || defined(__clang__)
+    memset(p, 0, len);
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+#else
     volatile uint8_t *v = (volatile uint8_t *)p;
     while (len--) {
         *v++ = 0;
     }
+#endif
 }
 
 int gc_eval_clear(
@@ -33,8 +48,8 @@ int gc_eval_clear(
         return -3;
     }
 
-    for (uint16_t i = 0; i < c->n_inputs; ++i) {
-        uint16_t w = c->input_wires[i];
+    for (gc_wire_id i = 0; i < c->n_inputs; ++i) {
+        gc_wire_id w = c->input_wires[i];
         if (w >= c->n_wires) {
             free(wire_vals);
             return -4;
@@ -80,8 +95,8 @@ int gc_eval_clear(
         wire_vals[g->out] = out;
     }
 
-    for (uint16_t i = 0; i < c->n_outputs; ++i) {
-        uint16_t w = c->output_wires[i];
+    for (gc_wire_id i = 0; i < c->n_outputs; ++i) {
+        gc_wire_id w = c->output_wires[i];
         if (w >= c->n_wires) {
             free(wire_vals);
             return -10;
@@ -93,11 +108,157 @@ int gc_eval_clear(
     return 0;
 }
 
+// 8 words per wire = 512 assignments per gate visit, one zmm register or two
+// ymm registers when the kernel is built for AVX-512/AVX2
+#define GC_BATCH_TILE_WORDS 8
+
+typedef uint64_t gc_batch_vec __attribute__((vector_size(GC_BATCH_TILE_WORDS * 8)));
+
+#if !defined(__EMSCRIPTEN__) && defined(__x86_64__) && defined(__linux__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define GC_BATCH_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define GC_BATCH_CLONES
+#endif
+
+GC_BATCH_CLONES
+static void gc_eval_batch_tile(const gc_circuit *c, gc_batch_vec *v) {
+    for (size_t gi = 0; gi < c->n_gates; ++gi) {
+        const gc_gate *g = &c->gates[gi];
+        switch (g->type) {
+        case GC_GATE_AND:
+            v[g->out] = v[g->in0] & v[g->in1];
+            break;
+        case GC_GATE_XOR:
+            v[g->out] = v[g->in0] ^ v[g->in1];
+            break;
+        default:
+            v[g->out] = ~v[g->in0];
+            break;
+        }
+    }
+}
+
+int gc_eval_clear_batch(
+    const gc_circuit *c,
+    const uint64_t   *inputs,
+    size_t            n_words,
+    uint64_t         *outputs
+) {
+    if (!c || !inputs || !outputs) {
+        return -1;
+    }
+    if (c->n_inputs == 0 || c->n_outputs == 0 || c->n_wires == 0) {
+        return -2;
+    }
+    if (n_words == 0) {
+        return 0;
+    }
+
+    // validate once so the tile kernel can run without per-gate checks
+    for (gc_wire_id i = 0; i < c->n_inputs; ++i) {
+        if (c->input_wires[i] >= c->n_wires) {
+            return -4;
+        }
+    }
+    for (size_t gi = 0; gi < c->n_gates; ++gi) {
+        const gc_gate *g = &c->gates[gi];
+        if (g->out >= c->n_wires || g->in0 >= c->n_wires) {
+            return -5;
+        }
+        if (g->type != GC_GATE_AND && g->type != GC_GATE_XOR && g->type != GC_GATE_NOT) {
+            return -9;
+        }
+        if (g->type != GC_GATE_NOT && g->in1 >= c->n_wires) {
+            return -6;
+        }
+    }
+    for (gc_wire_id i = 0; i < c->n_outputs; ++i) {
+        if (c->output_wires[i] >= c->n_wires) {
+            return -10;
+        }
+    }
+
+    gc_batch_vec *v = (gc_batch_vec *)aligned_alloc(
+        sizeof(gc_batch_vec), (size_t)c->n_wires * sizeof(gc_batch_vec));
+    if (!v) {
+        return -3;
+    }
+    memset(v, 0, (size_t)c->n_wires * sizeof(gc_batch_vec));
+
+    for (size_t w0 = 0; w0 < n_words; w0 += GC_BATCH_TILE_WORDS) {
+        size_t nw = n_words - w0;
+        if (nw > GC_BATCH_TILE_WORDS) {
+            nw = GC_BATCH_TILE_WORDS;
+        }
+
+        for (gc_wire_id i = 0; i < c->n_inputs; ++i) {
+            uint64_t *lane = (uint64_t *)&v[c->input_wires[i]];
+            const uint64_t *src = &inputs[(size_t)i * n_words + w0];
+            for (size_t k = 0; k < GC_BATCH_TILE_WORDS; ++k) {
+                lane[k] = (k < nw) ? src[k] : 0;
+            }
+        }
+
+        gc_eval_batch_tile(c, v);
+
+        for (gc_wire_id i = 0; i < c->n_outputs; ++i) {
+            const uint64_t *lane = (const uint64_t *)&v[c->output_wires[i]];
+            memcpy(&outputs[(size_t)i * n_words + w0], lane, nw * sizeof(uint64_t));
+        }
+    }
+
+    free(v);
+    return 0;
+}
+
+void gc_batch_pack_bits(
+    const uint8_t *bits,
+    size_t         n_vectors,
+    size_t         n_bits,
+    uint64_t      *out_words
+) {
+    if (!bits || !out_words) {
+        return;
+    }
+    const size_t n_words = (n_vectors + 63u) / 64u;
+    memset(out_words, 0, n_bits * n_words * sizeof(uint64_t));
+
+    for (size_t vi = 0; vi < n_vectors; ++vi) {
+        const uint8_t *row = bits + vi * n_bits;
+        const uint64_t mask = (uint64_t)1 << (vi % 64u);
+        for (size_t b = 0; b < n_bits; ++b) {
+            if (row[b] & 1u) {
+                out_words[b * n_words + vi / 64u] |= mask;
+            }
+        }
+    }
+}
+
+void gc_batch_unpack_bits(
+    const uint64_t *words,
+    size_t          n_vectors,
+    size_t          n_bits,
+    uint8_t        *out_bits
+) {
+    if (!words || !out_bits) {
+        return;
+    }
+    const size_t n_words = (n_vectors + 63u) / 64u;
+
+    for (size_t vi = 0; vi < n_vectors; ++vi) {
+        uint8_t *row = out_bits + vi * n_bits;
+        for (size_t b = 0; b < n_bits; ++b) {
+            row[b] = (uint8_t)((words[b * n_words + vi / 64u] >> (vi % 64u)) & 1u);
+        }
+    }
+}
+
 static gc_circuit *gc_circuit_alloc(
-    uint16_t n_wires,
-    uint16_t n_inputs,
-    uint16_t n_outputs,
-    size_t   n_gates
+    gc_wire_id n_wires,
+    gc_wire_id n_inputs,
+    gc_wire_id n_outputs,
+    size_t     n_gates
 ) {
     gc_circuit *c = (gc_circuit *)calloc(1, sizeof(gc_circuit));
     if (!c) {
@@ -109,11 +270,11 @@ static gc_circuit *gc_circuit_alloc(
     c->n_outputs = n_outputs;
     c->n_gates   = n_gates;
 
-    c->input_wires  = (uint16_t *)calloc(n_inputs, sizeof(uint16_t));
-    c->output_wires = (uint16_t *)calloc(n_outputs, sizeof(uint16_t));
+    c->input_wires  = (gc_wire_id *)calloc(n_inputs, sizeof(gc_wire_id));
+    c->output_wires = (gc_wire_id *)calloc(n_outputs, sizeof(gc_wire_id));
     c->gates        = (gc_gate *)calloc(n_gates, sizeof(gc_gate));
 
-    if (!c->input_wires || !c->output_wires || !c->gates) {
+    if (!c->input_wires || !c->output_wires || (!c->gates && n_gates > 0)) {
         gc_circuit_free(c);
         return NULL;
     }
@@ -200,80 +361,359 @@ void gc_circuit_free(gc_circuit *c) {
     free(c);
 }
 
-static const uint8_t GC_PRF_KEY[PSI_BLAKE3_KEY_LEN] = {
-    0x47, 0x43, 0x2d, 0x50, 0x52, 0x46, 0x2d, 0x4b,
-    0x65, 0x79, 0x2d, 0x31, 0x32, 0x33, 0x34, 0x56,
-    0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf6, 0x11, 0x22,
-    0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa
-};
+// optimizer graph: node 0 is the constant false, then one node per input and
+// per surviving AND/XOR. a literal is node * 2 + complement, so NOT gates
+// become a flipped bit and constants are literals 0 (false) and 1 (true).
+#define GC_OPT_NONE ((size_t)-1)
+#define GC_OPT_LIT_FALSE ((size_t)0)
+#define GC_OPT_LIT_TRUE  ((size_t)1)
+
+typedef struct {
+    gc_gate_type type;  // GC_GATE_AND / GC_GATE_XOR, unused for const/inputs
+    size_t a;
+    size_t b;
+} gc_opt_node;
+
+typedef struct {
+    gc_opt_node *nodes;
+    size_t n_nodes;
+    size_t n_leaf;      // constant + inputs, nodes below this have no operands
+    size_t *table;      // structural hash, node index or GC_OPT_NONE
+    size_t table_mask;
+} gc_opt_graph;
+
+static size_t gc_opt_hash(gc_gate_type type, size_t a, size_t b) {
+    uint64_t h = (uint64_t)a * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)b + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2);
+    h ^= (uint64_t)type * 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 29;
+    return (size_t)h;
+}
 
-static gc_label GC_DELTA;
-static int GC_DELTA_INITIALIZED = 0;
+// returns the literal for type(a, b), reusing an existing node when possible
+static size_t gc_opt_add(gc_opt_graph *g, gc_gate_type type, size_t a, size_t b) {
+    size_t neg = 0;
 
-static void gc_init_delta(void) {
-    if (GC_DELTA_INITIALIZED) {
-        return;
+    if (type == GC_GATE_XOR) {
+        // pull complements out: ~a ^ b = ~(a ^ b)
+        neg = (a ^ b) & 1u;
+        a &= ~(size_t)1;
+        b &= ~(size_t)1;
+    }
+    if (a > b) {
+        size_t t = a; a = b; b = t;
     }
 
-    uint8_t input[4] = { 0x44, 0x45, 0x4c, 0x54 };
+    if (type == GC_GATE_AND) {
+        if (a == GC_OPT_LIT_FALSE) return GC_OPT_LIT_FALSE;
+        if (a == GC_OPT_LIT_TRUE)  return b;
+        if (a == b)                return a;
+        if ((a ^ 1u) == b)         return GC_OPT_LIT_FALSE;
+    } else {
+        if (a == GC_OPT_LIT_FALSE) return b ^ neg;
+        if (a == b)                return GC_OPT_LIT_FALSE ^ neg;
+    }
 
-    blake3_hasher hasher;
-    blake3_hasher_init_keyed(&hasher, GC_PRF_KEY);
-    blake3_hasher_update(&hasher, input, sizeof(input));
-    blake3_hasher_finalize(&hasher, GC_DELTA.b, GC_LABEL_BYTES);
+    size_t slot = gc_opt_hash(type, a, b) & g->table_mask;
+    while (g->table[slot] != GC_OPT_NONE) {
+        const gc_opt_node *n = &g->nodes[g->table[slot]];
+        if (n->type == type && n->a == a && n->b == b) {
+            return (g->table[slot] << 1) ^ neg;
+        }
+        slot = (slot + 1) & g->table_mask;
+    }
 
-    GC_DELTA.b[0] |= 0x01;
-    GC_DELTA_INITIALIZED = 1;
+    size_t id = g->n_nodes++;
+    g->nodes[id].type = type;
+    g->nodes[id].a = a;
+    g->nodes[id].b = b;
+    g->table[slot] = id;
+    return (id << 1) ^ neg;
 }
 
-static void gc_derive_label0(uint16_t wire, gc_label *l0) {
-    uint8_t input[4];
-    input[0] = (uint8_t)(wire & 0xff);
-    input[1] = (uint8_t)((wire >> 8) & 0xff);
-    input[2] = 0;
-    input[3] = 0xA5;
+int gc_circuit_optimize(
+    const gc_circuit *in,
+    gc_circuit      **out,
+    gc_stats         *before,
+    gc_stats         *after
+) {
+    if (!in || !out) {
+        return -1;
+    }
+    if (in->n_inputs == 0 || in->n_outputs == 0 || in->n_wires == 0) {
+        return -2;
+    }
 
-    blake3_hasher hasher;
-    blake3_hasher_init_keyed(&hasher, GC_PRF_KEY);
-    blake3_hasher_update(&hasher, input, sizeof(input));
-    blake3_hasher_finalize(&hasher, l0->b, GC_LABEL_BYTES);
+    int rc = 0;
+    gc_circuit *c = NULL;
+    gc_opt_graph g;
+    memset(&g, 0, sizeof(g));
 
-    l0->b[0] &= 0xFE;
-}
+    size_t table_size = 16;
+    while (table_size < 2 * in->n_gates) {
+        table_size <<= 1;
+    }
+
+    const size_t max_nodes = 1 + (size_t)in->n_inputs + in->n_gates;
+    size_t *wire_lit  = (size_t *)malloc((size_t)in->n_wires * sizeof(size_t));
+    uint8_t *live     = (uint8_t *)calloc(max_nodes, sizeof(uint8_t));
+    size_t *node_wire = (size_t *)malloc(max_nodes * sizeof(size_t));
+    size_t *not_wire  = (size_t *)malloc(max_nodes * sizeof(size_t));
+    g.nodes = (gc_opt_node *)calloc(max_nodes, sizeof(gc_opt_node));
+    g.table = (size_t *)malloc(table_size * sizeof(size_t));
+    g.table_mask = table_size - 1;
+
+    if (!wire_lit || !live || !node_wire || !not_wire || !g.nodes || !g.table) {
+        rc = -3;
+        goto cleanup;
+    }
 
-static inline uint8_t gc_permute_bit(const gc_label *lab) {
-    return lab->b[0] & 1u;
+    for (size_t i = 0; i < in->n_wires; ++i) {
+        wire_lit[i] = GC_OPT_NONE;
+    }
+    for (size_t i = 0; i < table_size; ++i) {
+        g.table[i] = GC_OPT_NONE;
+    }
+
+    // forward pass: rebuild the circuit as a graph of literals
+    g.n_nodes = 1;
+    for (gc_wire_id i = 0; i < in->n_inputs; ++i) {
+        gc_wire_id w = in->input_wires[i];
+        if (w >= in->n_wires) {
+            rc = -4;
+            goto cleanup;
+        }
+        wire_lit[w] = g.n_nodes++ << 1;
+    }
+    g.n_leaf = g.n_nodes;
+
+    for (size_t gi = 0; gi < in->n_gates; ++gi) {
+        const gc_gate *pg = &in->gates[gi];
+        if (pg->out >= in->n_wires || pg->in0 >= in->n_wires ||
+            wire_lit[pg->in0] == GC_OPT_NONE) {
+            rc = -4;
+            goto cleanup;
+        }
+
+        size_t la = wire_lit[pg->in0];
+        switch (pg->type) {
+        case GC_GATE_NOT:
+            wire_lit[pg->out] = la ^ 1u;
+            break;
+        case GC_GATE_AND:
+        case GC_GATE_XOR:
+            if (pg->in1 >= in->n_wires || wire_lit[pg->in1] == GC_OPT_NONE) {
+                rc = -4;
+                goto cleanup;
+            }
+            wire_lit[pg->out] = gc_opt_add(&g, pg->type, la, wire_lit[pg->in1]);
+            break;
+        default:
+            rc = -4;
+            goto cleanup;
+        }
+    }
+
+    // liveness: walk back from the outputs, operands precede their users
+    for (gc_wire_id i = 0; i < in->n_outputs; ++i) {
+        gc_wire_id w = in->output_wires[i];
+        if (w >= in->n_wires || wire_lit[w] == GC_OPT_NONE) {
+            rc = -4;
+            goto cleanup;
+        }
+        live[wire_lit[w] >> 1] = 1;
+    }
+    for (size_t n = g.n_nodes; n-- > g.n_leaf; ) {
+        if (live[n]) {
+            live[g.nodes[n].a >> 1] = 1;
+            live[g.nodes[n].b >> 1] = 1;
+        }
+    }
+
+    // count what will be emitted: one gate per live node, one NOT per
+    // complemented use of a node, and a constant wire pair if outputs need it
+    for (size_t n = 0; n < g.n_nodes; ++n) {
+        not_wire[n] = GC_OPT_NONE;
+        node_wire[n] = GC_OPT_NONE;
+    }
+    size_t n_new_gates = 0;
+    int need_const = 0;
+    for (size_t n = g.n_leaf; n < g.n_nodes; ++n) {
+        if (!live[n]) {
+            continue;
+        }
+        n_new_gates++;
+        size_t ops[2] = { g.nodes[n].a, g.nodes[n].b };
+        for (size_t k = 0; k < 2; ++k) {
+            if ((ops[k] & 1u) && not_wire[ops[k] >> 1] == GC_OPT_NONE) {
+                not_wire[ops[k] >> 1] = 0;
+                n_new_gates++;
+            }
+        }
+    }
+    for (gc_wire_id i = 0; i < in->n_outputs; ++i) {
+        size_t lit = wire_lit[in->output_wires[i]];
+        if ((lit >> 1) == 0) {
+            need_const = 1;
+        } else if ((lit & 1u) && not_wire[lit >> 1] == GC_OPT_NONE) {
+            not_wire[lit >> 1] = 0;
+            n_new_gates++;
+        }
+    }
+    if (need_const) {
+        n_new_gates += 2;
+    }
+
+    const size_t n_new_wires = (size_t)in->n_inputs + n_new_gates;
+    if (n_new_wires > GC_WIRE_ID_MAX) {
+        rc = -5;
+        goto cleanup;
+    }
+
+    c = gc_circuit_alloc((gc_wire_id)n_new_wires, in->n_inputs, in->n_outputs, n_new_gates);
+    if (!c) {
+        rc = -3;
+        goto cleanup;
+    }
+
+    for (gc_wire_id i = 0; i < in->n_inputs; ++i) {
+        c->input_wires[i] = i;
+        node_wire[1 + i] = i;
+    }
+
+    size_t gi = 0;
+    size_t next_wire = in->n_inputs;
+
+#define GC_OPT_EMIT(t, x, y, dst) do {          \
+        gc_gate *eg_ = &c->gates[gi++];         \
+        eg_->type = (t);                        \
+        eg_->in0  = (gc_wire_id)(x);            \
+        eg_->in1  = (gc_wire_id)(y);            \
+        eg_->out  = (gc_wire_id)next_wire;      \
+        (dst) = next_wire++;                    \
+    } while (0)
+
+    if (need_const) {
+        // false = in0 ^ in0, true = ~false
+        GC_OPT_EMIT(GC_GATE_XOR, 0, 0, node_wire[0]);
+        GC_OPT_EMIT(GC_GATE_NOT, node_wire[0], 0, not_wire[0]);
+    }
+
+    for (size_t n = 1; n < g.n_nodes; ++n) {
+        if (!live[n] && n >= g.n_leaf) {
+            continue;
+        }
+        if (n >= g.n_leaf) {
+            size_t wa = (g.nodes[n].a & 1u) ? not_wire[g.nodes[n].a >> 1]
+                                            : node_wire[g.nodes[n].a >> 1];
+            size_t wb = (g.nodes[n].b & 1u) ? not_wire[g.nodes[n].b >> 1]
+                                            : node_wire[g.nodes[n].b >> 1];
+            GC_OPT_EMIT(g.nodes[n].type, wa, wb, node_wire[n]);
+        }
+        // complement right after its node so later users see it
+        if (not_wire[n] != GC_OPT_NONE) {
+            GC_OPT_EMIT(GC_GATE_NOT, node_wire[n], 0, not_wire[n]);
+        }
+    }
+
+#undef GC_OPT_EMIT
+
+    for (gc_wire_id i = 0; i < in->n_outputs; ++i) {
+        size_t lit = wire_lit[in->output_wires[i]];
+        size_t w = (lit & 1u) ? not_wire[lit >> 1] : node_wire[lit >> 1];
+        c->output_wires[i] = (gc_wire_id)w;
+    }
+
+    if (before) {
+        gc_circuit_stats(in, GC_GARBLE_HALF_GATES, before);
+    }
+    if (after) {
+        gc_circuit_stats(c, GC_GARBLE_HALF_GATES, after);
+    }
+    *out = c;
+    c = NULL;
+
+cleanup:
+    gc_circuit_free(c);
+    free(wire_lit);
+    free(live);
+    free(node_wire);
+    free(not_wire);
+    free(g.nodes);
+    free(g.table);
+    return rc;
 }
 
-static void gc_gate_prf(
-    const gc_label *ka,
-    const gc_label *kb,
-    uint16_t        gate_index,
-    uint8_t         row,
-    uint8_t        *out_keystream
-) {
-    uint8_t buf[GC_LABEL_BYTES * 2 + 4];
+int gc_random_bytes(uint8_t *buf, size_t len) {
+    // getentropy caps a single call at 256 bytes
     size_t off = 0;
+    while (off < len) {
+        size_t n = (len - off < 256) ? len - off : 256;
+        if (getentropy(buf + off, n) != 0) {
+            break;
+        }
+        off += n;
+    }
+    if (off == len) {
+        return 0;
+    }
 
-    memcpy(buf + off, ka->b, GC_LABEL_BYTES); off += GC_LABEL_BYTES;
-    memcpy(buf + off, kb->b, GC_LABEL_BYTES); off += GC_LABEL_BYTES;
-    buf[off++] = (uint8_t)(gate_index & 0xff);
-    buf[off++] = (uint8_t)((gate_index >> 8) & 0xff);
-    buf[off++] = row;
-    buf[off++] = 0x3C;
+    FILE *f = fopen("/dev/urandom", "rb");
+    if (!f) {
+        return -1;
+    }
+    size_t got = fread(buf + off, 1, len - off, f);
+    fclose(f);
+    return (got == len - off) ? 0 : -1;
+}
+
+int gc_garble_keys_init(gc_garble_keys *k, const uint8_t *seed) {
+    if (seed) {
+        memcpy(k->key, seed, GC_GARBLE_SEED_BYTES);
+    } else if (gc_random_bytes(k->key, GC_GARBLE_SEED_BYTES) != 0) {
+        return -8;
+    }
 
-    blake3_hasher hasher;
-    blake3_hasher_init_keyed(&hasher, GC_PRF_KEY);
-    blake3_hasher_update(&hasher, buf, off);
-    blake3_hasher_finalize(&hasher, out_keystream, GC_LABEL_BYTES);
+    uint8_t block[GC_PRF_BLOCK_BYTES] = { 0x44, 0x45, 0x4c, 0x54 };
+    gc_prf_blake3_blocks(k->key, block, 1, &k->delta);
+
+    // lsb(delta) = 1 so the two labels of a wire carry opposite permute bits
+    k->delta.b[0] |= 0x01;
+    return 0;
 }
 
-static void gc_label_xor(const gc_label *a, const gc_label *b, gc_label *out) {
-    for (size_t i = 0; i < GC_LABEL_BYTES; ++i) {
-        out->b[i] = (uint8_t)(a->b[i] ^ b->b[i]);
+void gc_garble_keys_wipe(gc_garble_keys *k) {
+    gc_secure_memzero(k, sizeof(*k));
+}
+
+// label inputs are wire (LE32) || 0x00 || 0xA5, zero-padded to one block
+// so a whole range goes through the multi-input BLAKE3 kernels.
+// the permute bit of L0 is left random: clearing it would make every
+// wire's permute bit equal its plaintext value
+void gc_derive_labels0(const gc_garble_keys *k, gc_wire_id first, gc_wire_id n, gc_label *l0) {
+    uint8_t blocks[GC_PRF_LANES * GC_PRF_BLOCK_BYTES];
+    memset(blocks, 0, sizeof(blocks));
+
+    for (gc_wire_id done = 0; done < n;) {
+        gc_wire_id m = (n - done < GC_PRF_LANES) ? n - done : GC_PRF_LANES;
+        for (gc_wire_id i = 0; i < m; ++i) {
+            uint32_t wire = (uint32_t)first + done + i;
+            uint8_t *in = blocks + (size_t)i * GC_PRF_BLOCK_BYTES;
+            in[0] = (uint8_t)(wire & 0xff);
+            in[1] = (uint8_t)((wire >> 8) & 0xff);
+            in[2] = (uint8_t)((wire >> 16) & 0xff);
+            in[3] = (uint8_t)((wire >> 24) & 0xff);
+            in[5] = 0xA5;
+        }
+        gc_prf_blake3_blocks(k->key, blocks, m, l0 + done);
+        done += m;
     }
 }
 
+void gc_derive_label0(const gc_garble_keys *k, gc_wire_id wire, gc_label *l0) {
+    gc_derive_labels0(k, wire, 1, l0);
+}
+
 static int gc_label_equal_ct(const gc_label *a, const gc_label *b) {
     uint8_t diff = 0;
     for (size_t i = 0; i < GC_LABEL_BYTES; ++i) {
@@ -282,26 +722,167 @@ static int gc_label_equal_ct(const gc_label *a, const gc_label *b) {
     return diff == 0;
 }
 
+// classic rows: hash2(Ka, Kb, 4*gi + row) for the 4 input combinations
+static void gc_garble_and_classic_many(
+    const gc_label      *delta,
+    const gc_and_garble *jobs,
+    size_t               n
+) {
+    // zeroed only so GCC can see the PRF inputs are written: it cannot
+    // follow the per-lane fill below (a few hundred bytes per batch)
+    gc_label ka[4 * GC_AND_BATCH] = { { { 0 } } }, kb[4 * GC_AND_BATCH] = { { { 0 } } };
+    gc_label ks[4 * GC_AND_BATCH];
+    uint64_t tweak[4 * GC_AND_BATCH] = { 0 };
+    uint8_t  rows[4 * GC_AND_BATCH];
+
+    for (size_t j = 0; j < n; ++j) {
+        for (uint8_t a = 0; a < 2; ++a) {
+            for (uint8_t b = 0; b < 2; ++b) {
+                size_t r = 4 * j + 2 * a + b;
+                ka[r] = *jobs[j].Wa0;
+                kb[r] = *jobs[j].Wb0;
+                if (a) gc_label_xor(&ka[r], delta, &ka[r]);
+                if (b) gc_label_xor(&kb[r], delta, &kb[r]);
+                rows[r] = (uint8_t)((gc_permute_bit(&ka[r]) << 1) | gc_permute_bit(&kb[r]));
+                tweak[r] = (jobs[j].gi << 2) | rows[r];
+            }
+        }
+    }
+    gc_prf_hash2_many(ka, kb, tweak, 4 * n, ks);
+
+    for (size_t j = 0; j < n; ++j) {
+        gc_label Wc1;
+        gc_label_xor(jobs[j].Wc0, delta, &Wc1);
+        for (size_t ab = 0; ab < 4; ++ab) {
+            size_t r = 4 * j + ab;
+            const gc_label *Kout = (ab == 3) ? &Wc1 : jobs[j].Wc0;
+            gc_label_xor(Kout, &ks[r], &jobs[j].table[rows[r]]);
+        }
+    }
+}
+
+// the generator half goes to table[0], the evaluator half to table[1]
+static void gc_garble_and_half_many(
+    const gc_label      *delta,
+    const gc_and_garble *jobs,
+    size_t               n
+) {
+    // zeroed for GCC's sake, as in gc_garble_and_classic_many
+    gc_label k[4 * GC_AND_BATCH] = { { { 0 } } }, H[4 * GC_AND_BATCH];
+    uint64_t tweak[4 * GC_AND_BATCH] = { 0 };
+
+    // H(Wa0, 2j), H(Wa1, 2j), H(Wb0, 2j+1), H(Wb1, 2j+1)
+    for (size_t j = 0; j < n; ++j) {
+        k[4 * j]     = *jobs[j].Wa0;
+        k[4 * j + 2] = *jobs[j].Wb0;
+        gc_label_xor(jobs[j].Wa0, delta, &k[4 * j + 1]);
+        gc_label_xor(jobs[j].Wb0, delta, &k[4 * j + 3]);
+        tweak[4 * j]     = jobs[j].gi << 1;
+        tweak[4 * j + 1] = jobs[j].gi << 1;
+        tweak[4 * j + 2] = (jobs[j].gi << 1) | 1u;
+        tweak[4 * j + 3] = (jobs[j].gi << 1) | 1u;
+    }
+    gc_prf_hash1_many(k, tweak, 4 * n, H);
+
+    for (size_t j = 0; j < n; ++j) {
+        const gc_label *Wa0 = jobs[j].Wa0;
+        const gc_label *Ha0 = &H[4 * j], *Ha1 = &H[4 * j + 1];
+        const gc_label *Hb0 = &H[4 * j + 2], *Hb1 = &H[4 * j + 3];
+        const uint8_t pa = gc_permute_bit(Wa0);
+        const uint8_t pb = gc_permute_bit(jobs[j].Wb0);
+
+        gc_label *TG = &jobs[j].table[0];
+        gc_label *TE = &jobs[j].table[1];
+        gc_label WG0, WE0;
+
+        gc_label_xor(Ha0, Ha1, TG);
+        if (pb) {
+            gc_label_xor(TG, delta, TG);
+        }
+        WG0 = *Ha0;
+        if (pa) {
+            gc_label_xor(&WG0, TG, &WG0);
+        }
+
+        gc_label_xor(Hb0, Hb1, TE);
+        gc_label_xor(TE, Wa0, TE);
+        WE0 = *Hb0;
+        if (pb) {
+            gc_label_xor(&WE0, TE, &WE0);
+            gc_label_xor(&WE0, Wa0, &WE0);
+        }
+
+        // last, since Wc0 may alias Wa0 or Wb0
+        gc_label_xor(&WG0, &WE0, jobs[j].Wc0);
+    }
+}
+
+void gc_garble_and_many(
+    gc_garble_mode       mode,
+    const gc_label      *delta,
+    const gc_and_garble *jobs,
+    size_t               n
+) {
+    if (mode == GC_GARBLE_HALF_GATES) {
+        gc_garble_and_half_many(delta, jobs, n);
+    } else {
+        gc_garble_and_classic_many(delta, jobs, n);
+    }
+}
+
+void gc_garble_and_classic(
+    const gc_label *delta,
+    uint64_t        gi,
+    const gc_label *Wa0,
+    const gc_label *Wb0,
+    const gc_label *Wc0,
+    gc_label       *table
+) {
+    gc_and_garble job = { gi, Wa0, Wb0, table, (gc_label *)Wc0 };
+    gc_garble_and_classic_many(delta, &job, 1);
+}
+
+void gc_garble_and_half(
+    const gc_label *delta,
+    uint64_t        gi,
+    const gc_label *Wa0,
+    const gc_label *Wb0,
+    gc_label       *table,
+    gc_label       *Wc0
+) {
+    gc_and_garble job = { gi, Wa0, Wb0, table, Wc0 };
+    gc_garble_and_half_many(delta, &job, 1);
+}
+
 int gc_garble(
     const gc_circuit    *plain,
     gc_garbled_circuit **out_gc
 ) {
-    if (!plain || !out_gc) {
-        return -1;
-    }
+    return gc_garble_with_mode(plain, GC_GARBLE_HALF_GATES, out_gc);
+}
 
+int gc_garble_with_mode(
+    const gc_circuit    *plain,
+    gc_garble_mode       mode,
+    gc_garbled_circuit **out_gc
+) {
+    return gc_garble_seeded(plain, mode, NULL, out_gc);
+}
+
+gc_garbled_circuit *gc_garbled_alloc(const gc_circuit *plain, gc_garble_mode mode) {
     gc_garbled_circuit *gc = (gc_garbled_circuit *)calloc(1, sizeof(gc_garbled_circuit));
     if (!gc) {
-        return -2;
+        return NULL;
     }
 
+    gc->mode      = mode;
     gc->n_wires   = plain->n_wires;
     gc->n_inputs  = plain->n_inputs;
     gc->n_outputs = plain->n_outputs;
     gc->n_gates   = plain->n_gates;
 
-    gc->input_wires  = (uint16_t *)calloc(gc->n_inputs, sizeof(uint16_t));
-    gc->output_wires = (uint16_t *)calloc(gc->n_outputs, sizeof(uint16_t));
+    gc->input_wires  = (gc_wire_id *)calloc(gc->n_inputs, sizeof(gc_wire_id));
+    gc->output_wires = (gc_wire_id *)calloc(gc->n_outputs, sizeof(gc_wire_id));
     gc->gates        = (gc_garbled_gate *)calloc(gc->n_gates, sizeof(gc_garbled_gate));
     gc->wire_labels0 = (gc_label *)calloc(gc->n_wires, sizeof(gc_label));
     gc->wire_labels1 = (gc_label *)calloc(gc->n_wires, sizeof(gc_label));
@@ -309,172 +890,391 @@ int gc_garble(
     if (!gc->input_wires || !gc->output_wires || !gc->gates ||
         !gc->wire_labels0 || !gc->wire_labels1) {
         gc_garbled_free(gc);
-        return -3;
+        return NULL;
     }
 
-    memcpy(gc->input_wires,  plain->input_wires,  gc->n_inputs  * sizeof(uint16_t));
-    memcpy(gc->output_wires, plain->output_wires, gc->n_outputs * sizeof(uint16_t));
+    memcpy(gc->input_wires,  plain->input_wires,  gc->n_inputs  * sizeof(gc_wire_id));
+    memcpy(gc->output_wires, plain->output_wires, gc->n_outputs * sizeof(gc_wire_id));
+    return gc;
+}
 
-    gc_init_delta();
-    for (uint16_t w = 0; w < gc->n_wires; ++w) {
-        gc_label l0;
-        gc_derive_label0(w, &l0);
-        gc->wire_labels0[w] = l0;
-        gc_label_xor(&l0, &GC_DELTA, &gc->wire_labels1[w]);
+int gc_garble_gate(
+    gc_garble_mode   mode,
+    const gc_label  *delta,
+    size_t           gi,
+    const gc_gate   *pg,
+    gc_garbled_gate *gg,
+    gc_label        *L0,
+    gc_wire_id       n_wires
+) {
+    if (pg->in0 >= n_wires || pg->out >= n_wires ||
+        (pg->type != GC_GATE_NOT && pg->in1 >= n_wires)) {
+        return -5;
     }
 
-    for (size_t gi = 0; gi < gc->n_gates; ++gi) {
-        const gc_gate *pg = &plain->gates[gi];
-        if (pg->type != GC_GATE_XOR) {
-            continue;
+    gg->in0  = pg->in0;
+    gg->in1  = pg->in1;
+    gg->out  = pg->out;
+    gg->type = pg->type;
+
+    switch (pg->type) {
+    case GC_GATE_XOR:
+        gc_label_xor(&L0[pg->in0], &L0[pg->in1], &L0[pg->out]);
+        return 0;
+    case GC_GATE_NOT:
+        // free NOT: swap the label pair, the evaluator just copies its label
+        gc_label_xor(&L0[pg->in0], delta, &L0[pg->out]);
+        return 0;
+    case GC_GATE_AND:
+        if (mode == GC_GARBLE_HALF_GATES) {
+            gc_garble_and_half(delta, gi, &L0[pg->in0], &L0[pg->in1],
+                               gg->table, &L0[pg->out]);
+        } else {
+            gc_garble_and_classic(delta, gi, &L0[pg->in0], &L0[pg->in1],
+                                  &L0[pg->out], gg->table);
         }
+        return 0;
+    default:
+        return -4;
+    }
+}
 
-        const gc_label *L0_in0 = &gc->wire_labels0[pg->in0];
-        const gc_label *L0_in1 = &gc->wire_labels0[pg->in1];
+void gc_garble_batch_flush(gc_garble_batch *b) {
+    if (b->n > 0) {
+        gc_garble_and_many(b->mode, b->delta, b->jobs, b->n);
+        b->n = 0;
+    }
+}
 
-        gc_label L0_out;
-        gc_label_xor(L0_in0, L0_in1, &L0_out);
+int gc_garble_gate_batched(
+    gc_garble_batch *b,
+    size_t           gi,
+    const gc_gate   *pg,
+    gc_garbled_gate *gg,
+    gc_label        *L0,
+    gc_wire_id       n_wires
+) {
+    if (pg->type != GC_GATE_AND) {
+        gc_garble_batch_flush(b);
+        return gc_garble_gate(b->mode, b->delta, gi, pg, gg, L0, n_wires);
+    }
+    if (pg->in0 >= n_wires || pg->in1 >= n_wires || pg->out >= n_wires) {
+        return -5;
+    }
 
-        gc->wire_labels0[pg->out] = L0_out;
-        gc_label_xor(&L0_out, &GC_DELTA, &gc->wire_labels1[pg->out]);
+    // an input still waiting on a queued gate's output needs that gate first
+    const gc_label *a = &L0[pg->in0];
+    const gc_label *c = &L0[pg->in1];
+    int ready = b->n < GC_AND_BATCH;
+    for (size_t j = 0; j < b->n && ready; ++j) {
+        ready = b->jobs[j].Wc0 != a && b->jobs[j].Wc0 != c;
     }
+    if (!ready) {
+        gc_garble_batch_flush(b);
+    }
+
+    gg->in0  = pg->in0;
+    gg->in1  = pg->in1;
+    gg->out  = pg->out;
+    gg->type = pg->type;
+    b->jobs[b->n++] = (gc_and_garble){ gi, a, c, gg->table, &L0[pg->out] };
+    return 0;
+}
 
+int gc_garble_seeded(
+    const gc_circuit    *plain,
+    gc_garble_mode       mode,
+    const uint8_t       *seed,
+    gc_garbled_circuit **out_gc
+) {
+    if (!plain || !out_gc) {
+        return -1;
+    }
+    if (mode != GC_GARBLE_CLASSIC && mode != GC_GARBLE_HALF_GATES) {
+        return -1;
+    }
+
+    gc_garbled_circuit *gc = gc_garbled_alloc(plain, mode);
+    if (!gc) {
+        return -3;
+    }
+
+    gc_garble_keys keys;
+    if (gc_garble_keys_init(&keys, seed) != 0) {
+        gc_garbled_free(gc);
+        return -8;
+    }
+    const gc_label *delta = &keys.delta;
+    gc_derive_labels0(&keys, 0, gc->n_wires, gc->wire_labels0);
+
+    // one pass in gate order: XOR and half-gates AND outputs are computed
+    // from their inputs, so every gate must see its inputs' final labels.
+    // runs of independent AND gates share one batched PRF call.
+    gc_garble_batch batch = { .mode = mode, .delta = delta };
     for (size_t gi = 0; gi < gc->n_gates; ++gi) {
-        const gc_gate *pg = &plain->gates[gi];
-        gc_garbled_gate *gg = &gc->gates[gi];
+        int rc = gc_garble_gate_batched(&batch, gi, &plain->gates[gi], &gc->gates[gi],
+                                        gc->wire_labels0, gc->n_wires);
+        if (rc != 0) {
+            gc_garble_keys_wipe(&keys);
+            gc_garbled_free(gc);
+            return rc;
+        }
+    }
+    gc_garble_batch_flush(&batch);
 
-        gg->in0  = pg->in0;
-        gg->in1  = pg->in1;
-        gg->out  = pg->out;
-        gg->type = pg->type;
+    for (gc_wire_id w = 0; w < gc->n_wires; ++w) {
+        gc_label_xor(&gc->wire_labels0[w], delta, &gc->wire_labels1[w]);
+    }
+    gc_garble_keys_wipe(&keys);
 
-        if (pg->type == GC_GATE_XOR) {
-            continue;
+    *out_gc = gc;
+    return 0;
+}
+
+// 2 ciphertexts (half-gates) or the 4-row point-and-permute table (classic)
+void gc_eval_and_many(
+    gc_garble_mode     mode,
+    const gc_and_eval *jobs,
+    size_t             n
+) {
+    gc_label ka[2 * GC_AND_BATCH], kb[GC_AND_BATCH], ks[2 * GC_AND_BATCH];
+    uint64_t tweak[2 * GC_AND_BATCH];
+
+    if (n == 0) {
+        return;
+    }
+
+    if (mode == GC_GARBLE_HALF_GATES) {
+        for (size_t j = 0; j < n; ++j) {
+            ka[2 * j]        = *jobs[j].Ka;
+            ka[2 * j + 1]    = *jobs[j].Kb;
+            tweak[2 * j]     = jobs[j].gi << 1;
+            tweak[2 * j + 1] = (jobs[j].gi << 1) | 1u;
         }
+        gc_prf_hash1_many(ka, tweak, 2 * n, ks);
 
-        for (uint8_t a = 0; a < 2; ++a) {
-            for (uint8_t b = 0; b < 2; ++b) {
-                const gc_label *la = &gc->wire_labels0[pg->in0];
-                const gc_label *la1 = &gc->wire_labels1[pg->in0];
-                const gc_label *lb = &gc->wire_labels0[pg->in1];
-                const gc_label *lb1 = &gc->wire_labels1[pg->in1];
-
-                const gc_label *Ka = (a == 0) ? la : la1;
-                const gc_label *Kb = (b == 0) ? lb : lb1;
-
-                uint8_t bit_out = 0;
-                switch (pg->type) {
-                case GC_GATE_AND:
-                    bit_out = (uint8_t)((a & b) & 1u);
-                    break;
-                case GC_GATE_XOR:
-                    bit_out = (uint8_t)((a ^ b) & 1u);
-                    break;
-                case GC_GATE_NOT:
-                    bit_out = (uint8_t)((a ? 0u : 1u) & 1u);
-                    break;
-                default:
-                    return -4;
-                }
-
-                const gc_label *Lout0 = &gc->wire_labels0[pg->out];
-                const gc_label *Lout1 = &gc->wire_labels1[pg->out];
-                const gc_label *Kout  = (bit_out == 0) ? Lout0 : Lout1;
-
-                uint8_t color_a = gc_permute_bit(Ka);
-                uint8_t color_b = gc_permute_bit(Kb);
-                uint8_t row = (uint8_t)((color_a << 1) | color_b);
-
-                uint8_t keystream[GC_LABEL_BYTES];
-                gc_gate_prf(Ka, Kb, (uint16_t)gi, row, keystream);
-
-                gc_label *ct = &gg->table[row];
-                for (size_t i = 0; i < GC_LABEL_BYTES; ++i) {
-                    ct->b[i] = (uint8_t)(Kout->b[i] ^ keystream[i]);
-                }
+        for (size_t j = 0; j < n; ++j) {
+            const gc_label *Ka = jobs[j].Ka;
+            gc_label *WG = &ks[2 * j], *WE = &ks[2 * j + 1];
+            if (gc_permute_bit(Ka)) {
+                gc_label_xor(WG, &jobs[j].table[0], WG);
             }
+            if (gc_permute_bit(jobs[j].Kb)) {
+                gc_label_xor(WE, &jobs[j].table[1], WE);
+                gc_label_xor(WE, Ka, WE);
+            }
+            gc_label_xor(WG, WE, jobs[j].Kout);
         }
+        return;
     }
 
-    *out_gc = gc;
-    return 0;
+    uint8_t rows[GC_AND_BATCH];
+    for (size_t j = 0; j < n; ++j) {
+        ka[j] = *jobs[j].Ka;
+        kb[j] = *jobs[j].Kb;
+        rows[j] = (uint8_t)((gc_permute_bit(&ka[j]) << 1) | gc_permute_bit(&kb[j]));
+        tweak[j] = (jobs[j].gi << 2) | rows[j];
+    }
+    gc_prf_hash2_many(ka, kb, tweak, n, ks);
+
+    for (size_t j = 0; j < n; ++j) {
+        gc_label_xor(&jobs[j].table[rows[j]], &ks[j], jobs[j].Kout);
+    }
 }
 
-int gc_eval_garbled(
-    const gc_garbled_circuit *gc,
-    const gc_label           *input_labels,
-    gc_label                 *output_labels
+void gc_eval_and_gate(
+    gc_garble_mode  mode,
+    uint64_t        gi,
+    const gc_label *Ka,
+    const gc_label *Kb,
+    const gc_label *table,
+    gc_label       *Kout
 ) {
-    if (!gc || !input_labels || !output_labels) {
-        return -1;
+    gc_and_eval job = { gi, Ka, Kb, table, Kout };
+    gc_eval_and_many(mode, &job, 1);
+}
+
+void gc_eval_batch_flush(gc_eval_batch *b) {
+    if (b->n > 0) {
+        gc_eval_and_many(b->mode, b->jobs, b->n);
+        b->n = 0;
     }
+}
 
-    gc_label *wire_vals = (gc_label *)calloc(gc->n_wires, sizeof(gc_label));
-    if (!wire_vals) {
-        return -2;
+void gc_eval_batch_push(
+    gc_eval_batch  *b,
+    uint64_t        gi,
+    const gc_label *Ka,
+    const gc_label *Kb,
+    const gc_label *table,
+    gc_label       *Kout
+) {
+    int ready = b->n < GC_AND_BATCH;
+    for (size_t j = 0; j < b->n && ready; ++j) {
+        ready = b->jobs[j].Kout != Ka && b->jobs[j].Kout != Kb;
     }
-    int rc = 0;
+    if (!ready) {
+        gc_eval_batch_flush(b);
+    }
+    b->jobs[b->n++] = (gc_and_eval){ gi, Ka, Kb, table, Kout };
+}
 
-    for (uint16_t i = 0; i < gc->n_inputs; ++i) {
-        uint16_t w = gc->input_wires[i];
-        if (w >= gc->n_wires) {
-            rc = -3;
-            goto cleanup;
+// wire buffer reused across evaluations, 64-byte aligned so labels never
+// straddle cache lines. only the prefix touched since the last wipe is dirty.
+#define GC_EVAL_ALIGN 64
+
+struct gc_evaluator {
+    gc_label  *wire_vals;
+    gc_wire_id capacity;
+    gc_wire_id dirty;
+};
+
+static int gc_evaluator_reserve(gc_evaluator *ev, gc_wire_id n_wires) {
+    if (n_wires <= ev->capacity) {
+        if (n_wires > ev->dirty) {
+            ev->dirty = n_wires;
         }
-        wire_vals[w] = input_labels[i];
+        return 0;
     }
 
-    for (size_t gi = 0; gi < gc->n_gates; ++gi) {
-        const gc_garbled_gate *gg = &gc->gates[gi];
+    size_t bytes = (size_t)n_wires * sizeof(gc_label);
+    bytes = (bytes + GC_EVAL_ALIGN - 1) & ~(size_t)(GC_EVAL_ALIGN - 1);
+    gc_label *buf = (gc_label *)aligned_alloc(GC_EVAL_ALIGN, bytes);
+    if (!buf) {
+        return -2;
+    }
 
-        if (gg->out >= gc->n_wires) {
-            rc = -4;
-            goto cleanup;
-        }
+    gc_evaluator_wipe(ev);
+    free(ev->wire_vals);
+    ev->wire_vals = buf;
+    ev->capacity  = n_wires;
+    ev->dirty     = n_wires;
+    return 0;
+}
 
-        if (gg->type == GC_GATE_XOR) {
-            gc_label Kout;
-            gc_label_xor(&wire_vals[gg->in0], &wire_vals[gg->in1], &Kout);
-            wire_vals[gg->out] = Kout;
-            continue;
-        }
+gc_label *gc_evaluator_buffer(gc_evaluator *ev, gc_wire_id n_wires) {
+    return (gc_evaluator_reserve(ev, n_wires) == 0) ? ev->wire_vals : NULL;
+}
 
-        const gc_label *Ka = &wire_vals[gg->in0];
-        const gc_label *Kb = &wire_vals[gg->in1];
+void gc_eval_gate(
+    gc_eval_batch         *b,
+    size_t                 gi,
+    const gc_garbled_gate *gg,
+    gc_label              *wire_vals
+) {
+    switch (gg->type) {
+    case GC_GATE_XOR:
+        gc_eval_batch_flush(b);
+        gc_label_xor(&wire_vals[gg->in0], &wire_vals[gg->in1], &wire_vals[gg->out]);
+        break;
+    case GC_GATE_NOT:
+        gc_eval_batch_flush(b);
+        wire_vals[gg->out] = wire_vals[gg->in0];
+        break;
+    default:
+        gc_eval_batch_push(b, gi, &wire_vals[gg->in0], &wire_vals[gg->in1],
+                           gg->table, &wire_vals[gg->out]);
+        break;
+    }
+}
+
+gc_evaluator *gc_evaluator_create(gc_wire_id n_wires) {
+    gc_evaluator *ev = (gc_evaluator *)calloc(1, sizeof(gc_evaluator));
+    if (!ev) {
+        return NULL;
+    }
+    if (n_wires > 0 && gc_evaluator_reserve(ev, n_wires) != 0) {
+        free(ev);
+        return NULL;
+    }
+    ev->dirty = 0;
+    return ev;
+}
 
-        uint8_t color_a = gc_permute_bit(Ka);
-        uint8_t color_b = gc_permute_bit(Kb);
-        uint8_t row = (uint8_t)((color_a << 1) | color_b);
+void gc_evaluator_wipe(gc_evaluator *ev) {
+    if (!ev) return;
+    gc_secure_memzero(ev->wire_vals, (size_t)ev->dirty * sizeof(gc_label));
+    ev->dirty = 0;
+}
 
-        const gc_label *ct = &gg->table[row];
+void gc_evaluator_destroy(gc_evaluator *ev) {
+    if (!ev) return;
+    gc_evaluator_wipe(ev);
+    free(ev->wire_vals);
+    free(ev);
+}
 
-        uint8_t keystream[GC_LABEL_BYTES];
-        gc_gate_prf(Ka, Kb, (uint16_t)gi, row, keystream);
+int gc_evaluator_eval(
+    gc_evaluator             *ev,
+    const gc_garbled_circuit *gc,
+    const gc_label           *input_labels,
+    gc_label                 *output_labels
+) {
+    if (!gc) {
+        return -1;
+    }
+    return gc_evaluator_eval_spans(ev, gc, input_labels, gc->n_inputs, NULL, output_labels);
+}
 
-        gc_label Kout;
-        for (size_t i = 0; i < GC_LABEL_BYTES; ++i) {
-            Kout.b[i] = (uint8_t)(ct->b[i] ^ keystream[i]);
+int gc_evaluator_eval_spans(
+    gc_evaluator             *ev,
+    const gc_garbled_circuit *gc,
+    const gc_label           *first,
+    gc_wire_id                n_first,
+    const gc_label           *second,
+    gc_label                 *output_labels
+) {
+    if (!ev || !gc || !output_labels || n_first > gc->n_inputs ||
+        (n_first > 0 && !first) || (n_first < gc->n_inputs && !second)) {
+        return -1;
+    }
+    if (gc_evaluator_reserve(ev, gc->n_wires) != 0) {
+        return -2;
+    }
+    gc_label *wire_vals = ev->wire_vals;
+
+    for (gc_wire_id i = 0; i < gc->n_inputs; ++i) {
+        gc_wire_id w = gc->input_wires[i];
+        if (w >= gc->n_wires) {
+            return -3;
         }
+        wire_vals[w] = (i < n_first) ? first[i] : second[i - n_first];
+    }
 
-        wire_vals[gg->out] = Kout;
+    gc_eval_batch batch = { .mode = gc->mode };
+    for (size_t gi = 0; gi < gc->n_gates; ++gi) {
+        if (gc->gates[gi].out >= gc->n_wires) {
+            return -4;
+        }
+        gc_eval_gate(&batch, gi, &gc->gates[gi], wire_vals);
     }
+    gc_eval_batch_flush(&batch);
 
-    for (uint16_t i = 0; i < gc->n_outputs; ++i) {
-        uint16_t w = gc->output_wires[i];
+    for (gc_wire_id i = 0; i < gc->n_outputs; ++i) {
+        gc_wire_id w = gc->output_wires[i];
         if (w >= gc->n_wires) {
-            rc = -5;
-            goto cleanup;
+            return -5;
         }
         output_labels[i] = wire_vals[w];
     }
+    return 0;
+}
 
-    rc = 0;
+int gc_eval_garbled(
+    const gc_garbled_circuit *gc,
+    const gc_label           *input_labels,
+    gc_label                 *output_labels
+) {
+    if (!gc || !input_labels || !output_labels) {
+        return -1;
+    }
 
-cleanup:
-    if (wire_vals) {
-        secure_memzero(wire_vals, gc->n_wires * sizeof(gc_label));
-        free(wire_vals);
+    gc_evaluator *ev = gc_evaluator_create(gc->n_wires);
+    if (!ev) {
+        return -2;
     }
+    int rc = gc_evaluator_eval(ev, gc, input_labels, output_labels);
+    gc_evaluator_destroy(ev);
     return rc;
 }
 
@@ -487,8 +1287,8 @@ int gc_decode_outputs(
         return -1;
     }
 
-    for (uint16_t i = 0; i < gc->n_outputs; ++i) {
-        uint16_t w = gc->output_wires[i];
+    for (gc_wire_id i = 0; i < gc->n_outputs; ++i) {
+        gc_wire_id w = gc->output_wires[i];
         const gc_label *L0 = &gc->wire_labels0[w];
         const gc_label *L1 = &gc->wire_labels1[w];
         const gc_label *Lo = &output_labels[i];
@@ -504,16 +1304,27 @@ int gc_decode_outputs(
     return 0;
 }
 
+int gc_decode_info(const gc_garbled_circuit *gc, uint8_t *decode_bits) {
+    if (!gc || !decode_bits) {
+        return -1;
+    }
+
+    for (gc_wire_id i = 0; i < gc->n_outputs; ++i) {
+        decode_bits[i] = gc_permute_bit(&gc->wire_labels0[gc->output_wires[i]]);
+    }
+    return 0;
+}
+
 void gc_garbled_free(gc_garbled_circuit *gc) {
     if (!gc) return;
     if (gc->wire_labels0) {
-        secure_memzero(gc->wire_labels0, gc->n_wires * sizeof(gc_label));
+        gc_secure_memzero(gc->wire_labels0, gc->n_wires * sizeof(gc_label));
     }
     if (gc->wire_labels1) {
-        secure_memzero(gc->wire_labels1, gc->n_wires * sizeof(gc_label));
+        gc_secure_memzero(gc->wire_labels1, gc->n_wires * sizeof(gc_label));
     }
     if (gc->gates) {
-        secure_memzero(gc->gates, gc->n_gates * sizeof(gc_garbled_gate));
+        gc_secure_memzero(gc->gates, gc->n_gates * sizeof(gc_garbled_gate));
     }
     free(gc->input_wires);
     free(gc->output_wires);
@@ -523,6 +1334,221 @@ void gc_garbled_free(gc_garbled_circuit *gc) {
     free(gc);
 }
 
+int gc_pack_garbled(
+    const gc_garbled_circuit *gc,
+    gc_packed_circuit       **out_packed
+) {
+    if (!gc || !out_packed) {
+        return -1;
+    }
+
+    const size_t per_gate = gc_table_size(gc->mode);
+    size_t n_ct = 0;
+    for (size_t gi = 0; gi < gc->n_gates; ++gi) {
+        if (gc->gates[gi].type == GC_GATE_AND) {
+            n_ct += per_gate;
+        }
+    }
+
+    gc_packed_circuit *pc = (gc_packed_circuit *)calloc(1, sizeof(gc_packed_circuit));
+    if (!pc) {
+        return -2;
+    }
+
+    pc->mode          = gc->mode;
+    pc->n_wires       = gc->n_wires;
+    pc->n_inputs      = gc->n_inputs;
+    pc->n_outputs     = gc->n_outputs;
+    pc->n_gates       = gc->n_gates;
+    pc->n_ciphertexts = n_ct;
+
+    pc->input_wires    = (gc_wire_id *)calloc(pc->n_inputs, sizeof(gc_wire_id));
+    pc->output_wires   = (gc_wire_id *)calloc(pc->n_outputs, sizeof(gc_wire_id));
+    pc->gate_types     = (uint8_t *)malloc(pc->n_gates ? pc->n_gates : 1);
+    pc->gates          = (gc_packed_gate *)malloc((pc->n_gates ? pc->n_gates : 1) * sizeof(gc_packed_gate));
+    pc->ciphertexts    = (gc_label *)malloc((n_ct ? n_ct : 1) * sizeof(gc_label));
+    pc->output_labels0 = (gc_label *)calloc(pc->n_outputs, sizeof(gc_label));
+    pc->output_labels1 = (gc_label *)calloc(pc->n_outputs, sizeof(gc_label));
+
+    if (!pc->input_wires || !pc->output_wires || !pc->gate_types || !pc->gates ||
+        !pc->ciphertexts || !pc->output_labels0 || !pc->output_labels1) {
+        gc_packed_free(pc);
+        return -3;
+    }
+
+    memcpy(pc->input_wires,  gc->input_wires,  pc->n_inputs  * sizeof(gc_wire_id));
+    memcpy(pc->output_wires, gc->output_wires, pc->n_outputs * sizeof(gc_wire_id));
+
+    gc_label *ct = pc->ciphertexts;
+    for (size_t gi = 0; gi < gc->n_gates; ++gi) {
+        const gc_garbled_gate *gg = &gc->gates[gi];
+        pc->gate_types[gi] = (uint8_t)gg->type;
+        pc->gates[gi].in0  = gg->in0;
+        pc->gates[gi].in1  = gg->in1;
+        pc->gates[gi].out  = gg->out;
+        if (gg->type == GC_GATE_AND) {
+            memcpy(ct, gg->table, per_gate * sizeof(gc_label));
+            ct += per_gate;
+        }
+    }
+
+    for (gc_wire_id i = 0; i < pc->n_outputs; ++i) {
+        gc_wire_id w = gc->output_wires[i];
+        if (w >= gc->n_wires) {
+            gc_packed_free(pc);
+            return -4;
+        }
+        pc->output_labels0[i] = gc->wire_labels0[w];
+        pc->output_labels1[i] = gc->wire_labels1[w];
+    }
+
+    *out_packed = pc;
+    return 0;
+}
+
+int gc_evaluator_eval_packed(
+    gc_evaluator            *ev,
+    const gc_packed_circuit *pc,
+    const gc_label          *input_labels,
+    gc_label                *output_labels
+) {
+    if (!ev || !pc || !input_labels || !output_labels) {
+        return -1;
+    }
+    if (gc_evaluator_reserve(ev, pc->n_wires) != 0) {
+        return -2;
+    }
+    gc_label *wire_vals = ev->wire_vals;
+
+    for (gc_wire_id i = 0; i < pc->n_inputs; ++i) {
+        gc_wire_id w = pc->input_wires[i];
+        if (w >= pc->n_wires) {
+            return -3;
+        }
+        wire_vals[w] = input_labels[i];
+    }
+
+    const size_t per_gate = gc_table_size(pc->mode);
+    const gc_label *ct = pc->ciphertexts;
+    const gc_label *ct_end = pc->ciphertexts + pc->n_ciphertexts;
+
+    gc_eval_batch batch = { .mode = pc->mode };
+    for (size_t gi = 0; gi < pc->n_gates; ++gi) {
+        const gc_packed_gate *g = &pc->gates[gi];
+
+        if (g->out >= pc->n_wires || g->in0 >= pc->n_wires ||
+            (pc->gate_types[gi] != GC_GATE_NOT && g->in1 >= pc->n_wires)) {
+            return -4;
+        }
+
+        switch (pc->gate_types[gi]) {
+        case GC_GATE_XOR:
+            gc_eval_batch_flush(&batch);
+            gc_label_xor(&wire_vals[g->in0], &wire_vals[g->in1], &wire_vals[g->out]);
+            break;
+        case GC_GATE_NOT:
+            gc_eval_batch_flush(&batch);
+            wire_vals[g->out] = wire_vals[g->in0];
+            break;
+        case GC_GATE_AND:
+            if (ct + per_gate > ct_end) {
+                return -6;
+            }
+            gc_eval_batch_push(&batch, gi, &wire_vals[g->in0], &wire_vals[g->in1],
+                               ct, &wire_vals[g->out]);
+            ct += per_gate;
+            break;
+        default:
+            return -7;
+        }
+    }
+    gc_eval_batch_flush(&batch);
+
+    for (gc_wire_id i = 0; i < pc->n_outputs; ++i) {
+        gc_wire_id w = pc->output_wires[i];
+        if (w >= pc->n_wires) {
+            return -5;
+        }
+        output_labels[i] = wire_vals[w];
+    }
+    return 0;
+}
+
+int gc_eval_packed(
+    const gc_packed_circuit *pc,
+    const gc_label          *input_labels,
+    gc_label                *output_labels
+) {
+    if (!pc || !input_labels || !output_labels) {
+        return -1;
+    }
+
+    gc_evaluator *ev = gc_evaluator_create(pc->n_wires);
+    if (!ev) {
+        return -2;
+    }
+    int rc = gc_evaluator_eval_packed(ev, pc, input_labels, output_labels);
+    gc_evaluator_destroy(ev);
+    return rc;
+}
+
+int gc_packed_decode_outputs(
+    const gc_packed_circuit *pc,
+    const gc_label          *output_labels,
+    uint8_t                 *outputs_bits
+) {
+    if (!pc || !output_labels || !outputs_bits) {
+        return -1;
+    }
+
+    for (gc_wire_id i = 0; i < pc->n_outputs; ++i) {
+        if (gc_label_equal_ct(&output_labels[i], &pc->output_labels0[i])) {
+            outputs_bits[i] = 0;
+        } else if (gc_label_equal_ct(&output_labels[i], &pc->output_labels1[i])) {
+            outputs_bits[i] = 1;
+        } else {
+            return -2;
+        }
+    }
+    return 0;
+}
+
+void gc_packed_free(gc_packed_circuit *pc) {
+    if (!pc) return;
+    if (pc->ciphertexts) {
+        gc_secure_memzero(pc->ciphertexts, pc->n_ciphertexts * sizeof(gc_label));
+    }
+    free(pc->input_wires);
+    free(pc->output_wires);
+    free(pc->gate_types);
+    free(pc->gates);
+    free(pc->ciphertexts);
+    free(pc->output_labels0);
+    free(pc->output_labels1);
+    free(pc);
+}
+
+size_t gc_garbled_bytes(const gc_garbled_circuit *gc) {
+    if (!gc) {
+        return 0;
+    }
+    return sizeof(*gc)
+        + ((size_t)gc->n_inputs + gc->n_outputs) * sizeof(gc_wire_id)
+        + gc->n_gates * sizeof(gc_garbled_gate)
+        + 2 * (size_t)gc->n_wires * sizeof(gc_label);
+}
+
+size_t gc_packed_bytes(const gc_packed_circuit *pc) {
+    if (!pc) {
+        return 0;
+    }
+    return sizeof(*pc)
+        + ((size_t)pc->n_inputs + pc->n_outputs) * sizeof(gc_wire_id)
+        + pc->n_gates * (sizeof(uint8_t) + sizeof(gc_packed_gate))
+        + pc->n_ciphertexts * sizeof(gc_label)
+        + 2 * (size_t)pc->n_outputs * sizeof(gc_label);
+}
+
 void gc_compute_stats(const gc_garbled_circuit *gc, gc_stats *stats) {
     if (!gc || !stats) {
         return;
@@ -536,14 +1562,43 @@ void gc_compute_stats(const gc_garbled_circuit *gc, gc_stats *stats) {
         switch (gg->type) {
         case GC_GATE_AND:
             stats->num_and_gates++;
-            stats->num_ciphertexts += 4;
+            stats->num_ciphertexts += (gc->mode == GC_GARBLE_HALF_GATES) ? 2 : 4;
+            break;
+        case GC_GATE_XOR:
+            stats->num_xor_gates++;
+            break;
+        case GC_GATE_NOT:
+            stats->num_not_gates++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    stats->ciphertext_bytes = stats->num_ciphertexts * GC_LABEL_BYTES;
+    stats->num_wires = gc->n_wires;
+}
+
+void gc_circuit_stats(const gc_circuit *c, gc_garble_mode mode, gc_stats *stats) {
+    if (!c || !stats) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->num_gates = c->n_gates;
+    stats->num_wires = c->n_wires;
+
+    for (size_t gi = 0; gi < c->n_gates; ++gi) {
+        switch (c->gates[gi].type) {
+        case GC_GATE_AND:
+            stats->num_and_gates++;
+            stats->num_ciphertexts += (mode == GC_GARBLE_HALF_GATES) ? 2 : 4;
             break;
         case GC_GATE_XOR:
             stats->num_xor_gates++;
             break;
         case GC_GATE_NOT:
             stats->num_not_gates++;
-            stats->num_ciphertexts += 4;
             break;
         default:
             break;
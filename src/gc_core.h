@@ -9,6 +9,20 @@ extern "C" {
 
 #define GC_LABEL_BYTES 16
 
+// bytes of seed a garbling's labels and delta are expanded from
+#define GC_GARBLE_SEED_BYTES 32
+
+// wire index type. 32-bit so circuits can go well past 65,535 wires; define
+// GC_WIRE_INDEX_16 (for the library and all users) to get the compact
+// 16-bit layout back on memory-constrained targets
+#ifdef GC_WIRE_INDEX_16
+typedef uint16_t gc_wire_id;
+#define GC_WIRE_ID_MAX UINT16_MAX
+#else
+typedef uint32_t gc_wire_id;
+#define GC_WIRE_ID_MAX UINT32_MAX
+#endif
+
 typedef struct {
     uint8_t b[GC_LABEL_BYTES];
 } gc_label;
@@ -19,43 +33,80 @@ typedef enum {
     GC_GATE_NOT = 2
 } gc_gate_type;
 
+// how AND gates are garbled. both modes use free-XOR with a global delta.
+//   GC_GARBLE_CLASSIC:    4-row point-and-permute table per AND gate
+//   GC_GARBLE_HALF_GATES: 2 ciphertexts per AND gate (Zahur-Rosulek-Evans)
+typedef enum {
+    GC_GARBLE_CLASSIC    = 0,
+    GC_GARBLE_HALF_GATES = 1
+} gc_garble_mode;
+
 typedef struct {
-    uint16_t in0;
-    uint16_t in1;
-    uint16_t out;
+    gc_wire_id in0;
+    gc_wire_id in1;
+    gc_wire_id out;
     gc_gate_type type;
 } gc_gate;
 
 typedef struct {
-    uint16_t n_wires;
-    uint16_t n_inputs;
-    uint16_t n_outputs;
-    uint16_t *input_wires;
-    uint16_t *output_wires;
+    gc_wire_id n_wires;
+    gc_wire_id n_inputs;
+    gc_wire_id n_outputs;
+    gc_wire_id *input_wires;
+    gc_wire_id *output_wires;
     size_t n_gates;
     gc_gate *gates;
 } gc_circuit;
 
 typedef struct {
-    uint16_t in0;
-    uint16_t in1;
-    uint16_t out;
+    gc_wire_id in0;
+    gc_wire_id in1;
+    gc_wire_id out;
     gc_gate_type type;
+    // classic mode uses all 4 rows, half-gates mode only table[0..1]
     gc_label table[4];
 } gc_garbled_gate;
 
 typedef struct {
-    uint16_t n_wires;
-    uint16_t n_inputs;
-    uint16_t n_outputs;
-    uint16_t *input_wires;
-    uint16_t *output_wires;
+    gc_garble_mode mode;
+    gc_wire_id n_wires;
+    gc_wire_id n_inputs;
+    gc_wire_id n_outputs;
+    gc_wire_id *input_wires;
+    gc_wire_id *output_wires;
     size_t n_gates;
     gc_garbled_gate *gates;
     gc_label *wire_labels0;
     gc_label *wire_labels1;
 } gc_garbled_circuit;
 
+// evaluator-side structure-of-arrays form of a garbled circuit. topology is
+// a tight array with no per-gate table; the tables of non-free (AND) gates
+// sit back to back in gate order in one ciphertext stream, 2 or 4 labels
+// each depending on mode. only the output decoding labels are kept, so this
+// carries nothing the evaluator should not see.
+typedef struct {
+    gc_wire_id in0;
+    gc_wire_id in1;
+    gc_wire_id out;
+} gc_packed_gate;
+
+typedef struct {
+    gc_garble_mode mode;
+    gc_wire_id n_wires;
+    gc_wire_id n_inputs;
+    gc_wire_id n_outputs;
+    gc_wire_id *input_wires;
+    gc_wire_id *output_wires;
+    size_t n_gates;
+    uint8_t *gate_types;        // gc_gate_type per gate
+    gc_packed_gate *gates;
+    size_t n_ciphertexts;
+    gc_label *ciphertexts;
+    gc_label *output_labels0;   // n_outputs each, for decoding
+    gc_label *output_labels1;
+} gc_packed_circuit;
+
 typedef struct {
     size_t num_gates;
     size_t num_and_gates;
@@ -63,19 +114,129 @@ typedef struct {
     size_t num_not_gates;
     size_t num_ciphertexts;
     size_t ciphertext_bytes;
+    size_t num_wires;
 } gc_stats;
 
+// receives garbled tables from gc_garble_stream: n_ct labels holding whole
+// AND tables, in gate order. the buffer is reused after the call returns.
+// a non-zero return aborts garbling.
+typedef int (*gc_table_sink)(void *user, const gc_label *ct, size_t n_ct);
+
+// evaluator-side counterpart: must fill ct with exactly the next n_ct labels
+// of the table stream (a blocking read, for a pipe or socket). non-zero
+// aborts evaluation.
+typedef int (*gc_table_source)(void *user, gc_label *ct, size_t n_ct);
+
+// 4096 labels = 64 KiB per sink / source call
+#define GC_STREAM_DEFAULT_CHUNK 4096
+
+typedef struct {
+    size_t peak_live_labels;    // label slots held at once
+    size_t chunk_labels;        // effective chunk size after rounding
+    size_t n_chunks;
+    size_t num_ciphertexts;
+} gc_stream_stats;
+
 int gc_eval_clear(
     const gc_circuit *c,
     const uint8_t    *inputs,
     uint8_t          *outputs
 );
 
+// bitsliced plaintext evaluation of many independent input assignments in
+// one pass over the gates. buffers are bit-transposed: inputs[i * n_words + w]
+// holds input bit i of assignments 64*w .. 64*w + 63 (bit j = assignment
+// 64*w + j), outputs[o * n_words + w] likewise.
+int gc_eval_clear_batch(
+    const gc_circuit *c,
+    const uint64_t   *inputs,
+    size_t            n_words,
+    uint64_t         *outputs
+);
+
+// converts between gc_eval_clear's byte-per-bit vectors (n_vectors rows of
+// n_bits bytes) and the transposed layout above, n_words = ceil(n_vectors/64)
+void gc_batch_pack_bits(
+    const uint8_t *bits,
+    size_t         n_vectors,
+    size_t         n_bits,
+    uint64_t      *out_words
+);
+
+void gc_batch_unpack_bits(
+    const uint64_t *words,
+    size_t          n_vectors,
+    size_t          n_bits,
+    uint8_t        *out_bits
+);
+
+// garbles with half-gates, see gc_garble_with_mode for the classic table
 int gc_garble(
     const gc_circuit    *plain,
     gc_garbled_circuit **out_gc
 );
 
+// every garbling draws a fresh seed from the OS CSPRNG, so delta and all
+// labels are independent between garblings and gc_garble* may run
+// concurrently on different threads. -8 if no entropy is available.
+int gc_garble_with_mode(
+    const gc_circuit    *plain,
+    gc_garble_mode       mode,
+    gc_garbled_circuit **out_gc
+);
+
+// deterministic variant: labels and delta are expanded from seed
+// (GC_GARBLE_SEED_BYTES), the same seed gives the same garbling. for tests
+// and for reproducing a garbling; NULL behaves like gc_garble_with_mode.
+int gc_garble_seeded(
+    const gc_circuit    *plain,
+    gc_garble_mode       mode,
+    const uint8_t       *seed,
+    gc_garbled_circuit **out_gc
+);
+
+// reusable evaluation state: a cache-aligned wire buffer that grows to the
+// largest circuit seen. labels left in it are wiped in bulk by
+// gc_evaluator_wipe / gc_evaluator_destroy, not after every evaluation, so
+// a caller evaluating many circuits pays one allocation and one wipe.
+// not thread-safe; use one evaluator per thread.
+typedef struct gc_evaluator gc_evaluator;
+
+// n_wires is a capacity hint, 0 allocates on first use
+gc_evaluator *gc_evaluator_create(gc_wire_id n_wires);
+
+int gc_evaluator_eval(
+    gc_evaluator             *ev,
+    const gc_garbled_circuit *gc,
+    const gc_label           *input_labels,
+    gc_label                 *output_labels
+);
+
+// same, with the input labels in two spans: inputs 0 .. n_first - 1 from
+// first, the remaining n_inputs - n_first from second. lets a caller keep
+// the labels of each party's elements in precomputed tables and evaluate
+// any pairing without copying them into one vector.
+int gc_evaluator_eval_spans(
+    gc_evaluator             *ev,
+    const gc_garbled_circuit *gc,
+    const gc_label           *first,
+    gc_wire_id                n_first,
+    const gc_label           *second,
+    gc_label                 *output_labels
+);
+
+int gc_evaluator_eval_packed(
+    gc_evaluator            *ev,
+    const gc_packed_circuit *pc,
+    const gc_label          *input_labels,
+    gc_label                *output_labels
+);
+
+void gc_evaluator_wipe(gc_evaluator *ev);
+
+void gc_evaluator_destroy(gc_evaluator *ev);
+
+// one-shot wrapper: creates an evaluator, evaluates, destroys it
 int gc_eval_garbled(
     const gc_garbled_circuit *gc,
     const gc_label           *input_labels,
@@ -88,10 +249,201 @@ int gc_decode_outputs(
     uint8_t                  *outputs_bits
 );
 
+// point-and-permute decoding info: decode_bits[i] is the permute bit of
+// output i's zero-label, so an output label L decodes to
+// (L.b[0] & 1) ^ decode_bits[i] without comparing labels. unlike
+// gc_decode_outputs this cannot tell a valid label from garbage.
+int gc_decode_info(const gc_garbled_circuit *gc, uint8_t *decode_bits);
+
 void gc_garbled_free(gc_garbled_circuit *gc);
 
+int gc_pack_garbled(
+    const gc_garbled_circuit *gc,
+    gc_packed_circuit       **out_packed
+);
+
+// same contract as gc_eval_garbled, reading the ciphertext stream in order
+int gc_eval_packed(
+    const gc_packed_circuit *pc,
+    const gc_label          *input_labels,
+    gc_label                *output_labels
+);
+
+int gc_packed_decode_outputs(
+    const gc_packed_circuit *pc,
+    const gc_label          *output_labels,
+    uint8_t                 *outputs_bits
+);
+
+void gc_packed_free(gc_packed_circuit *pc);
+
+// garbles plain gate by gate without materialising a gc_garbled_circuit.
+// AND tables go to sink in chunks of chunk_labels labels (0 = default,
+// rounded down to whole tables), the same stream gc_pack_garbled would put
+// in ciphertexts. labels live in slots reclaimed after a wire's last
+// reader, so label memory is O(peak live wires), and so is the wire ->
+// slot lookup. besides that, topology bookkeeping is one byte per gate and
+// input, plus one bit per wire while it is being worked out.
+//
+// input_labels0 / output_labels0 (n_inputs / n_outputs) receive the
+// zero-labels and delta_out the free-XOR offset: the one-label of a wire is
+// L0 ^ delta. input labels and delta are filled before the first sink call,
+// so the sink can send the evaluator's input labels ahead of the tables.
+// seed works as in gc_garble_seeded (NULL = fresh randomness). stats may be
+// NULL.
+int gc_garble_stream(
+    const gc_circuit *plain,
+    gc_garble_mode    mode,
+    const uint8_t    *seed,
+    size_t            chunk_labels,
+    gc_table_sink     sink,
+    void             *user,
+    gc_label         *input_labels0,
+    gc_label         *output_labels0,
+    gc_label         *delta_out,
+    gc_stream_stats  *stats
+);
+
+// evaluates plain against the table stream of gc_garble_stream, pulling
+// chunks of chunk_labels labels (the last one shorter) from source as AND
+// gates need them. the chunk size need not match the garbler's. memory is
+// one chunk plus the live label slots, the same bound as the garbler.
+int gc_eval_stream(
+    const gc_circuit *plain,
+    gc_garble_mode    mode,
+    size_t            chunk_labels,
+    gc_table_source   source,
+    void             *user,
+    const gc_label   *input_labels,
+    gc_label         *output_labels,
+    gc_stream_stats  *stats
+);
+
+// garbler side only: maps output labels to bits given the output
+// zero-labels and delta, -2 if a label matches neither. delta unlocks
+// every wire of the garbling, so it must never reach the evaluator; an
+// evaluator decodes with gc_stream_decode_bits instead.
+int gc_stream_decode_outputs(
+    gc_wire_id      n_outputs,
+    const gc_label *output_labels,
+    const gc_label *output_labels0,
+    const gc_label *delta,
+    uint8_t        *outputs_bits
+);
+
+// the streaming gc_decode_info: the permute bit of each output zero-label,
+// which the garbler may hand to the evaluator
+int gc_stream_decode_info(
+    gc_wire_id      n_outputs,
+    const gc_label *output_labels0,
+    uint8_t        *decode_bits
+);
+
+// evaluator side: outputs_bits[i] = (output_labels[i].b[0] & 1) ^
+// decode_bits[i]. like gc_decode_info, it cannot tell a valid label from
+// garbage.
+int gc_stream_decode_bits(
+    gc_wire_id      n_outputs,
+    const gc_label *output_labels,
+    const uint8_t  *decode_bits,
+    uint8_t        *outputs_bits
+);
+
+// heap bytes held by each representation, for footprint comparisons
+size_t gc_garbled_bytes(const gc_garbled_circuit *gc);
+
+size_t gc_packed_bytes(const gc_packed_circuit *pc);
+
 void gc_compute_stats(const gc_garbled_circuit *gc, gc_stats *stats);
 
+// plaintext counterpart of gc_compute_stats, ciphertexts are counted as if
+// the circuit were garbled in the given mode
+void gc_circuit_stats(const gc_circuit *c, gc_garble_mode mode, gc_stats *stats);
+
+// dependency layers: gates order[level_start[l] .. level_start[l + 1]) only
+// read circuit inputs and outputs of earlier levels, so each layer can run
+// in parallel. gate order is kept within a layer.
+typedef struct {
+    size_t  n_levels;
+    size_t *level_start;    // n_levels + 1 offsets into order
+    size_t *order;          // n_gates gate indices
+} gc_levels;
+
+// -5 on an out-of-range wire, -6 unless every wire is written once (by an
+// input or a gate) before it is read
+int gc_levelize(const gc_circuit *c, gc_levels *out);
+
+int gc_levelize_garbled(const gc_garbled_circuit *gc, gc_levels *out);
+
+void gc_levels_free(gc_levels *lv);
+
+// see gc_pool.h
+typedef struct gc_pool gc_pool;
+
+// average gates per level below which the parallel entry points take the
+// sequential path, a level's work would not cover the hand-off to the pool
+#define GC_PARALLEL_MIN_WIDTH 128
+
+// same result as gc_garble_seeded for the same seed, garbling each level's
+// gates across the pool. single-threaded pools, narrow circuits and
+// circuits gc_levelize rejects fall back to gc_garble_seeded.
+int gc_garble_parallel(
+    const gc_circuit    *plain,
+    gc_garble_mode       mode,
+    const uint8_t       *seed,
+    gc_pool             *pool,
+    gc_garbled_circuit **out_gc
+);
+
+// level-parallel gc_evaluator_eval. lv may be NULL to levelize gc on the
+// fly; pass gc_levelize's result to amortise it over many evaluations.
+// falls back to the sequential evaluator like gc_garble_parallel.
+int gc_evaluator_eval_parallel(
+    gc_evaluator             *ev,
+    const gc_garbled_circuit *gc,
+    const gc_levels          *lv,
+    gc_pool                  *pool,
+    const gc_label           *input_labels,
+    gc_label                 *output_labels
+);
+
+// builds an equivalent, smaller circuit:
+//   - gates whose outputs never reach output_wires are removed
+//   - constants, repeated operands (x & x, x ^ x) and double NOTs are folded
+//   - structurally identical gates are shared
+//   - wires are renumbered densely: inputs keep 0..n_inputs-1 in order, then
+//     one wire per emitted gate in topological order
+// before/after (either may be NULL) receive half-gates stats of the input
+// and the result. the caller owns *out and frees it with gc_circuit_free.
+int gc_circuit_optimize(
+    const gc_circuit *in,
+    gc_circuit      **out,
+    gc_stats         *before,
+    gc_stats         *after
+);
+
+// comparison circuits shaped for half-gates and level-parallel evaluation:
+// balanced AND trees, and NOT gates only on inputs where they can be shared.
+// operands are k-bit little-endian (input i carries bit i, weight 2^i), one
+// output wire. NULL if k == 0, the wires do not fit in gc_wire_id, or
+// allocation fails; free with gc_circuit_free.
+
+// a == b with inputs a then b: k - 1 ANDs at AND depth ceil(log2 k)
+gc_circuit *gc_circuit_eq(gc_wire_id k);
+
+// a in {b_1 .. b_m} with inputs a, b_1, .., b_m: m (k - 1) ANDs for the
+// equalities and an OR tree over them, m - 1 ANDs more unless distinct is
+// set. distinct promises the b_j are pairwise different, so at most one
+// equality holds and the OR tree is built from free XORs.
+gc_circuit *gc_circuit_member(gc_wire_id k, gc_wire_id m, int distinct);
+
+// a > b and a < b with inputs a then b: a tree of (greater, equal) pairs,
+// 3k - 2 - ceil(log2 k) ANDs at AND depth ceil(log2 k) + 1 (a ripple
+// comparator has k ANDs but is k deep)
+gc_circuit *gc_circuit_gt(gc_wire_id k);
+
+gc_circuit *gc_circuit_lt(gc_wire_id k);
+
 gc_circuit *gc_circuit_and_2();
 
 gc_circuit *gc_circuit_xor_2();
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gc_core.h"
+
+// helpers shared by the gc_core translation units, not part of the public
+// API. labels are passed as zero-labels; the one-label is L0 ^ delta.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void gc_secure_memzero(void *p, size_t len);
+
+static inline void gc_label_xor(const gc_label *a, const gc_label *b, gc_label *out) {
+    for (size_t i = 0; i < GC_LABEL_BYTES; ++i) {
+        out->b[i] = (uint8_t)(a->b[i] ^ b->b[i]);
+    }
+}
+
+static inline uint8_t gc_permute_bit(const gc_label *lab) {
+    return lab->b[0] & 1u;
+}
+
+static inline size_t gc_table_size(gc_garble_mode mode) {
+    return (mode == GC_GARBLE_HALF_GATES) ? 2u : 4u;
+}
+
+// fills buf from the OS CSPRNG (getentropy, then /dev/urandom), 0 on success
+int gc_random_bytes(uint8_t *buf, size_t len);
+
+// per-garbling secrets: the label-derivation key and the free-XOR offset
+// expanded from it. lives on the garbler's stack, so concurrent garblings
+// share nothing.
+typedef struct {
+    uint8_t  key[GC_GARBLE_SEED_BYTES];
+    gc_label delta;
+} gc_garble_keys;
+
+// seed NULL draws a fresh one from gc_random_bytes, -8 if that fails
+int gc_garble_keys_init(gc_garble_keys *k, const uint8_t *seed);
+
+void gc_garble_keys_wipe(gc_garble_keys *k);
+
+void gc_derive_label0(const gc_garble_keys *k, gc_wire_id wire, gc_label *l0);
+
+// zero-labels of wires first .. first + n - 1, hashed in batches
+void gc_derive_labels0(const gc_garble_keys *k, gc_wire_id first, gc_wire_id n, gc_label *l0);
+
+// AND gates garbled or evaluated together so their PRF inputs go through
+// one batched gc_prf_hash*_many call: a batch fills GC_PRF_LANES lanes
+// (evaluating half-gates) to 2 x GC_PRF_LANES (garbling).
+#define GC_AND_BATCH 8
+
+// one AND gate to garble. Wc0 is read (classic) or written (half-gates)
+// and may alias the gate's own inputs, but not those of other gates in
+// the same batch.
+typedef struct {
+    uint64_t        gi;
+    const gc_label *Wa0;
+    const gc_label *Wb0;
+    gc_label       *table;
+    gc_label       *Wc0;
+} gc_and_garble;
+
+// n <= GC_AND_BATCH
+void gc_garble_and_many(
+    gc_garble_mode       mode,
+    const gc_label      *delta,
+    const gc_and_garble *jobs,
+    size_t               n
+);
+
+// one AND gate to evaluate, same aliasing rules with Kout
+typedef struct {
+    uint64_t        gi;
+    const gc_label *Ka;
+    const gc_label *Kb;
+    const gc_label *table;
+    gc_label       *Kout;
+} gc_and_eval;
+
+void gc_eval_and_many(gc_garble_mode mode, const gc_and_eval *jobs, size_t n);
+
+// 4-row point-and-permute table of AND gate gi, Wc0 is the output
+// zero-label chosen by the caller
+void gc_garble_and_classic(
+    const gc_label *delta,
+    uint64_t        gi,
+    const gc_label *Wa0,
+    const gc_label *Wb0,
+    const gc_label *Wc0,
+    gc_label       *table
+);
+
+// half-gates AND: fills table[0..1] and produces the output zero-label.
+// Wc0 may alias Wa0 or Wb0.
+void gc_garble_and_half(
+    const gc_label *delta,
+    uint64_t        gi,
+    const gc_label *Wa0,
+    const gc_label *Wb0,
+    gc_label       *table,
+    gc_label       *Wc0
+);
+
+// evaluates one AND gate from its table. Kout may alias Ka or Kb.
+void gc_eval_and_gate(
+    gc_garble_mode  mode,
+    uint64_t        gi,
+    const gc_label *Ka,
+    const gc_label *Kb,
+    const gc_label *table,
+    gc_label       *Kout
+);
+
+// gc_garbled_circuit with topology copied from plain and labels zeroed
+gc_garbled_circuit *gc_garbled_alloc(const gc_circuit *plain, gc_garble_mode mode);
+
+// garbles gate gi into gg given the zero-labels of its inputs in L0 and
+// writes the output zero-label there. -5 on a wire index out of range.
+int gc_garble_gate(
+    gc_garble_mode   mode,
+    const gc_label  *delta,
+    size_t           gi,
+    const gc_gate   *pg,
+    gc_garbled_gate *gg,
+    gc_label        *L0,
+    gc_wire_id       n_wires
+);
+
+// queue of AND gates for a pass in gate order. a gate is queued until the
+// batch is full or a later gate reads its output; XOR and NOT gates flush
+// first. the caller flushes once after the last gate.
+typedef struct {
+    gc_garble_mode  mode;
+    const gc_label *delta;
+    size_t          n;
+    gc_and_garble   jobs[GC_AND_BATCH];
+} gc_garble_batch;
+
+// gc_garble_gate through the queue
+int gc_garble_gate_batched(
+    gc_garble_batch *b,
+    size_t           gi,
+    const gc_gate   *pg,
+    gc_garbled_gate *gg,
+    gc_label        *L0,
+    gc_wire_id       n_wires
+);
+
+void gc_garble_batch_flush(gc_garble_batch *b);
+
+typedef struct {
+    gc_garble_mode mode;
+    size_t         n;
+    gc_and_eval    jobs[GC_AND_BATCH];
+} gc_eval_batch;
+
+void gc_eval_batch_push(
+    gc_eval_batch  *b,
+    uint64_t        gi,
+    const gc_label *Ka,
+    const gc_label *Kb,
+    const gc_label *table,
+    gc_label       *Kout
+);
+
+void gc_eval_batch_flush(gc_eval_batch *b);
+
+// evaluates gate gi on wire_vals through the queue, indices already
+// validated
+void gc_eval_gate(
+    gc_eval_batch         *b,
+    size_t                 gi,
+    const gc_garbled_gate *gg,
+    gc_label              *wire_vals
+);
+
+// the evaluator's wire buffer grown to n_wires, NULL if that fails
+gc_label *gc_evaluator_buffer(gc_evaluator *ev, gc_wire_id n_wires);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,364 @@
+#include "gc_ot.h"
+#include "gc_internal.h"
+#include "gc_prf.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// IKNP, with the extension receiver R holding choice bits r and the
+// sender S a random s of GC_OT_BASE bits. from the base OTs R holds seed
+// pairs (k0_j, k1_j) and S the seeds k_j = k{s_j}_j. per batch:
+//   R: t_j = G(k0_j), sends u_j = t_j ^ G(k1_j) ^ r      (column j)
+//   S: q_j = G(k_j) ^ (s_j ? u_j : 0) = t_j ^ (s_j & r)
+// transposed, row i of q is t_i ^ (r_i ? s : 0), so
+//   S: sends y0_i = m0_i ^ H(i, q_i), y1_i = m1_i ^ H(i, q_i ^ s)
+//   R: m{r_i}_i = y{r_i}_i ^ H(i, t_i)
+// G is gc_prf_hash1 of the seed under a counter and H gc_prf_hash1 of the
+// row under the OT's index, the same correlation-robust hash half-gates
+// relies on with delta in the role of s. both sides count the 128-OT
+// blocks used so far; counters never repeat across calls.
+
+// tweaks of H are OT indices with the top bit set, apart from G's counters
+#define GC_OT_ROW_TWEAK (1ull << 63)
+
+struct gc_ot_sender {
+    int      ready;
+    gc_label s;
+    gc_label seeds[GC_OT_BASE];
+    uint64_t next_block;
+};
+
+struct gc_ot_receiver {
+    int      ready;
+    gc_label seeds0[GC_OT_BASE];
+    gc_label seeds1[GC_OT_BASE];
+    uint64_t next_block;
+};
+
+// per-call scratch for batches of up to n_blocks blocks
+typedef struct {
+    size_t    n_blocks;
+    gc_label *cols;     // GC_OT_BASE columns of n_blocks labels
+    gc_label *aux;      // the same shape: u, then row hashes
+    gc_label *rows;     // n_blocks * GC_OT_BASE rows
+    gc_label *pairs;    // two ciphertexts per OT
+    gc_label *keys;     // n_blocks copies of a seed for G
+    uint64_t *tweaks;   // n_blocks * GC_OT_BASE
+} gc_ot_work;
+
+static void gc_ot_work_free(gc_ot_work *w) {
+    const size_t n = w->n_blocks * GC_OT_BASE;
+    if (w->cols) gc_secure_memzero(w->cols, n * sizeof(gc_label));
+    if (w->aux) gc_secure_memzero(w->aux, n * sizeof(gc_label));
+    if (w->rows) gc_secure_memzero(w->rows, n * sizeof(gc_label));
+    free(w->cols);
+    free(w->aux);
+    free(w->rows);
+    free(w->pairs);
+    free(w->keys);
+    free(w->tweaks);
+    memset(w, 0, sizeof(*w));
+}
+
+static int gc_ot_work_init(gc_ot_work *w, size_t n) {
+    memset(w, 0, sizeof(*w));
+    if (n > GC_OT_BATCH) {
+        n = GC_OT_BATCH;
+    }
+    w->n_blocks = (n + GC_OT_BASE - 1) / GC_OT_BASE;
+    const size_t n_rows = w->n_blocks * GC_OT_BASE;
+    w->cols   = (gc_label *)malloc(n_rows * sizeof(gc_label));
+    w->aux    = (gc_label *)malloc(n_rows * sizeof(gc_label));
+    w->rows   = (gc_label *)malloc(n_rows * sizeof(gc_label));
+    w->pairs  = (gc_label *)malloc(2 * n_rows * sizeof(gc_label));
+    w->keys   = (gc_label *)malloc(w->n_blocks * sizeof(gc_label));
+    w->tweaks = (uint64_t *)malloc(n_rows * sizeof(uint64_t));
+    if (!w->cols || !w->aux || !w->rows || !w->pairs || !w->keys || !w->tweaks) {
+        gc_ot_work_free(w);
+        return -3;
+    }
+    return 0;
+}
+
+// blocks first .. first + n_blocks - 1 of the stream G(seed)
+static void gc_ot_prg(gc_ot_work *w, const gc_label *seed, uint64_t first, size_t n_blocks,
+                      gc_label *out) {
+    for (size_t b = 0; b < n_blocks; ++b) {
+        w->keys[b]   = *seed;
+        w->tweaks[b] = first + b;
+    }
+    gc_prf_hash1_many(w->keys, w->tweaks, n_blocks, out);
+}
+
+static uint64_t gc_ot_load64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static void gc_ot_store64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+// 128 x 128 bit transpose in place, bit c of row i in bit c % 64 of
+// m[i][c / 64]: swaps the off-diagonal halves, then quarters inside them,
+// down to single bits (Eklundh)
+static void gc_ot_transpose128(uint64_t m[GC_OT_BASE][2]) {
+    static const uint64_t masks[6] = {
+        0x00000000ffffffffull, 0x0000ffff0000ffffull, 0x00ff00ff00ff00ffull,
+        0x0f0f0f0f0f0f0f0full, 0x3333333333333333ull, 0x5555555555555555ull,
+    };
+    for (size_t i = 0; i < 64; ++i) {
+        uint64_t t = m[i][1];
+        m[i][1] = m[i + 64][0];
+        m[i + 64][0] = t;
+    }
+    for (unsigned level = 0, j = 32; j > 0; ++level, j /= 2) {
+        const uint64_t mask = masks[level];
+        for (size_t i = 0; i < GC_OT_BASE; ++i) {
+            if (i & j) {
+                continue;
+            }
+            for (int h = 0; h < 2; ++h) {
+                uint64_t t = ((m[i][h] >> j) ^ m[i + j][h]) & mask;
+                m[i + j][h] ^= t;
+                m[i][h] ^= t << j;
+            }
+        }
+    }
+}
+
+// column j, block b is cols[j * n_blocks + b]: bit i of it belongs to OT
+// b * 128 + i. rows[b * 128 + i] gets bit j from it.
+static void gc_ot_transpose(const gc_label *cols, size_t n_blocks, gc_label *rows) {
+    uint64_t m[GC_OT_BASE][2];
+    for (size_t b = 0; b < n_blocks; ++b) {
+        for (size_t j = 0; j < GC_OT_BASE; ++j) {
+            const uint8_t *c = cols[j * n_blocks + b].b;
+            m[j][0] = gc_ot_load64(c);
+            m[j][1] = gc_ot_load64(c + 8);
+        }
+        gc_ot_transpose128(m);
+        for (size_t i = 0; i < GC_OT_BASE; ++i) {
+            uint8_t *r = rows[b * GC_OT_BASE + i].b;
+            gc_ot_store64(r, m[i][0]);
+            gc_ot_store64(r + 8, m[i][1]);
+        }
+    }
+    gc_secure_memzero(m, sizeof(m));
+}
+
+// H over the first n rows, OTs numbered from first_ot
+static void gc_ot_hash_rows(gc_ot_work *w, const gc_label *rows, uint64_t first_ot, size_t n,
+                            gc_label *out) {
+    for (size_t i = 0; i < n; ++i) {
+        w->tweaks[i] = (first_ot + i) | GC_OT_ROW_TWEAK;
+    }
+    gc_prf_hash1_many(rows, w->tweaks, n, out);
+}
+
+static uint8_t gc_ot_bit(const uint8_t *bits, size_t i) {
+    return (bits[i / 8] >> (i % 8)) & 1u;
+}
+
+gc_ot_sender *gc_ot_sender_create(void) {
+    return (gc_ot_sender *)calloc(1, sizeof(gc_ot_sender));
+}
+
+void gc_ot_sender_destroy(gc_ot_sender *s) {
+    if (!s) return;
+    gc_secure_memzero(s, sizeof(*s));
+    free(s);
+}
+
+gc_ot_receiver *gc_ot_receiver_create(void) {
+    return (gc_ot_receiver *)calloc(1, sizeof(gc_ot_receiver));
+}
+
+void gc_ot_receiver_destroy(gc_ot_receiver *r) {
+    if (!r) return;
+    gc_secure_memzero(r, sizeof(*r));
+    free(r);
+}
+
+int gc_ot_sender_setup(gc_ot_sender *s, gc_channel *ch) {
+    if (!s || !ch) {
+        return -1;
+    }
+    s->ready = 0;
+    if (gc_random_bytes(s->s.b, GC_LABEL_BYTES) != 0) {
+        return -8;
+    }
+    int rc = gc_base_ot_recv(ch, GC_OT_BASE, s->s.b, s->seeds);
+    if (rc != 0) {
+        return rc;
+    }
+    s->next_block = 0;
+    s->ready = 1;
+    return 0;
+}
+
+int gc_ot_receiver_setup(gc_ot_receiver *r, gc_channel *ch) {
+    if (!r || !ch) {
+        return -1;
+    }
+    r->ready = 0;
+    int rc = gc_base_ot_send(ch, GC_OT_BASE, r->seeds0, r->seeds1);
+    if (rc != 0) {
+        return rc;
+    }
+    r->next_block = 0;
+    r->ready = 1;
+    return 0;
+}
+
+// m1 NULL: m1[i] = m0[i] ^ *delta
+static int gc_ot_send_impl(
+    gc_ot_sender   *s,
+    gc_channel     *ch,
+    const gc_label *m0,
+    const gc_label *m1,
+    const gc_label *delta,
+    size_t          n
+) {
+    if (!s || !ch || (n && !m0)) {
+        return -1;
+    }
+    // a programming error, not something the peer sent
+    if (!s->ready) {
+        return -1;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    gc_ot_work w;
+    if (gc_ot_work_init(&w, n) != 0) {
+        return -3;
+    }
+    int rc = 0;
+    for (size_t start = 0; start < n && rc == 0; start += GC_OT_BATCH) {
+        const size_t len = (n - start < GC_OT_BATCH) ? n - start : GC_OT_BATCH;
+        const size_t n_blocks = (len + GC_OT_BASE - 1) / GC_OT_BASE;
+        const uint64_t first_ot = s->next_block * GC_OT_BASE;
+
+        if (gc_channel_recv(ch, w.aux, GC_OT_BASE * n_blocks * sizeof(gc_label)) != 0) {
+            rc = -4;
+            break;
+        }
+        for (size_t j = 0; j < GC_OT_BASE; ++j) {
+            gc_label *q = w.cols + j * n_blocks;
+            gc_ot_prg(&w, &s->seeds[j], s->next_block, n_blocks, q);
+            if (gc_ot_bit(s->s.b, j)) {
+                for (size_t b = 0; b < n_blocks; ++b) {
+                    gc_label_xor(&q[b], &w.aux[j * n_blocks + b], &q[b]);
+                }
+            }
+        }
+        s->next_block += n_blocks;
+        gc_ot_transpose(w.cols, n_blocks, w.rows);
+
+        // H(q_i) into aux, then q_i ^ s in place and H of that into cols
+        gc_ot_hash_rows(&w, w.rows, first_ot, len, w.aux);
+        for (size_t i = 0; i < len; ++i) {
+            gc_label_xor(&w.rows[i], &s->s, &w.rows[i]);
+        }
+        gc_ot_hash_rows(&w, w.rows, first_ot, len, w.cols);
+        for (size_t i = 0; i < len; ++i) {
+            gc_label one;
+            if (m1) {
+                one = m1[start + i];
+            } else {
+                gc_label_xor(&m0[start + i], delta, &one);
+            }
+            gc_label_xor(&m0[start + i], &w.aux[i], &w.pairs[2 * i]);
+            gc_label_xor(&one, &w.cols[i], &w.pairs[2 * i + 1]);
+        }
+        if (gc_channel_send(ch, w.pairs, 2 * len * sizeof(gc_label)) != 0) {
+            rc = -4;
+        }
+    }
+    gc_ot_work_free(&w);
+    return rc;
+}
+
+int gc_ot_send(gc_ot_sender *s, gc_channel *ch, const gc_label *m0, const gc_label *m1, size_t n) {
+    if (n && !m1) {
+        return -1;
+    }
+    return gc_ot_send_impl(s, ch, m0, m1, NULL, n);
+}
+
+int gc_ot_send_xor(gc_ot_sender *s, gc_channel *ch, const gc_label *m0, const gc_label *delta,
+                   size_t n) {
+    if (n && !delta) {
+        return -1;
+    }
+    return gc_ot_send_impl(s, ch, m0, NULL, delta, n);
+}
+
+int gc_ot_recv(gc_ot_receiver *r, gc_channel *ch, const uint8_t *choices, size_t n,
+               gc_label *out) {
+    if (!r || !ch || (n && (!choices || !out))) {
+        return -1;
+    }
+    if (!r->ready) {
+        return -1;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    gc_ot_work w;
+    if (gc_ot_work_init(&w, n) != 0) {
+        return -3;
+    }
+    int rc = 0;
+    for (size_t start = 0; start < n && rc == 0; start += GC_OT_BATCH) {
+        const size_t len = (n - start < GC_OT_BATCH) ? n - start : GC_OT_BATCH;
+        const size_t n_blocks = (len + GC_OT_BASE - 1) / GC_OT_BASE;
+        const uint64_t first_ot = r->next_block * GC_OT_BASE;
+        // start is a multiple of 8, so the batch's choices start on a byte
+        const uint8_t *c = choices + start / 8;
+
+        // the batch's choice bits as one label per block, zero-padded
+        gc_label *r_bits = w.rows;
+        memset(r_bits, 0, n_blocks * sizeof(gc_label));
+        memcpy(r_bits, c, (len + 7) / 8);
+        if (len % 8) {
+            ((uint8_t *)r_bits)[len / 8] &= (uint8_t)((1u << (len % 8)) - 1u);
+        }
+
+        for (size_t j = 0; j < GC_OT_BASE; ++j) {
+            gc_label *t = w.cols + j * n_blocks;
+            gc_label *u = w.aux + j * n_blocks;
+            gc_ot_prg(&w, &r->seeds0[j], r->next_block, n_blocks, t);
+            gc_ot_prg(&w, &r->seeds1[j], r->next_block, n_blocks, u);
+            for (size_t b = 0; b < n_blocks; ++b) {
+                gc_label_xor(&u[b], &t[b], &u[b]);
+                gc_label_xor(&u[b], &r_bits[b], &u[b]);
+            }
+        }
+        r->next_block += n_blocks;
+        if (gc_channel_send(ch, w.aux, GC_OT_BASE * n_blocks * sizeof(gc_label)) != 0) {
+            rc = -4;
+            break;
+        }
+
+        gc_ot_transpose(w.cols, n_blocks, w.rows);
+        gc_ot_hash_rows(&w, w.rows, first_ot, len, w.aux);
+        if (gc_channel_recv(ch, w.pairs, 2 * len * sizeof(gc_label)) != 0) {
+            rc = -4;
+            break;
+        }
+        for (size_t i = 0; i < len; ++i) {
+            gc_label_xor(&w.pairs[2 * i + gc_ot_bit(c, i)], &w.aux[i], &out[start + i]);
+        }
+    }
+    gc_ot_work_free(&w);
+    return rc;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gc_channel.h"
+#include "gc_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// oblivious transfer of labels, secure against semi-honest parties: the
+// sender has pairs (m0[i], m1[i]), the receiver a choice bit per i and
+// learns m_{choice}[i] only, the sender learns nothing about the choices.
+// this is how an evaluator gets the input labels for its own bits without
+// reading the garbler's wire_labels0/1.
+//
+// a one-time setup runs GC_OT_BASE public-key OTs (Chou-Orlandi, "The
+// Simplest Protocol for Oblivious Transfer", over edwards25519); the IKNP
+// extension (Ishai-Kilian-Nissim-Petrank) then turns them into any number
+// of OTs at the cost of symmetric crypto: per OT, 16 bytes from receiver
+// to sender plus the two 16-byte ciphertexts back, a bit-matrix transpose
+// and three gc_prf_hash1 calls. each matrix row is GC_OT_BASE bits, i.e.
+// exactly one gc_label.
+//
+// both parties must make matching calls with the same n, in the same
+// order; each call runs in batches of GC_OT_BATCH OTs so memory stays
+// bounded however many labels move. returns are 0, -1 on bad arguments
+// (a transfer before its setup included), -2 on a malformed message from
+// the peer, -3 on allocation failure, -4 if the channel fails, -8 if the
+// OS has no randomness.
+
+#define GC_OT_BASE  128
+#define GC_OT_BATCH (1u << 16)
+
+// the base OTs on their own, random-message form: the sender gets n random
+// label pairs, the receiver the label its choice bit picks (bit i of
+// choices[i / 8]). one message each way.
+int gc_base_ot_send(gc_channel *ch, size_t n, gc_label *out0, gc_label *out1);
+
+int gc_base_ot_recv(gc_channel *ch, size_t n, const uint8_t *choices, gc_label *out);
+
+typedef struct gc_ot_sender gc_ot_sender;
+typedef struct gc_ot_receiver gc_ot_receiver;
+
+gc_ot_sender *gc_ot_sender_create(void);
+
+void gc_ot_sender_destroy(gc_ot_sender *s);
+
+gc_ot_receiver *gc_ot_receiver_create(void);
+
+void gc_ot_receiver_destroy(gc_ot_receiver *r);
+
+// the base OTs, once per sender / receiver pair (the extension sender is
+// the base-OT receiver). later calls keep extending the same setup.
+int gc_ot_sender_setup(gc_ot_sender *s, gc_channel *ch);
+
+int gc_ot_receiver_setup(gc_ot_receiver *r, gc_channel *ch);
+
+// n OTs of chosen labels
+int gc_ot_send(gc_ot_sender *s, gc_channel *ch, const gc_label *m0, const gc_label *m1, size_t n);
+
+// the free-XOR form: m1[i] = m0[i] ^ delta, so a garbler can pass its
+// zero-labels and delta as they come from gc_garble_stream
+int gc_ot_send_xor(gc_ot_sender *s, gc_channel *ch, const gc_label *m0, const gc_label *delta,
+                   size_t n);
+
+// out[i] = m0[i] or m1[i] as bit i of choices[i / 8] says; pairs with
+// either send call
+int gc_ot_recv(gc_ot_receiver *r, gc_channel *ch, const uint8_t *choices, size_t n,
+               gc_label *out);
+
+#ifdef __cplusplus
+}
+#endif
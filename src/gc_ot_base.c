@@ -0,0 +1,413 @@
+#include "gc_ot.h"
+#include "gc_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "blake3.h"
+
+// Chou-Orlandi base OTs over edwards25519 (-x^2 + y^2 = 1 + d x^2 y^2 mod
+// 2^255 - 19). only a handful run per setup, so the arithmetic favours
+// being short and branch-free on secrets over speed: field elements in
+// five 51-bit limbs with 128-bit products, extended coordinates and the
+// unified addition law (complete on this curve), double-and-add with a
+// masked select per bit. points travel as affine (x, y), 64 bytes, and
+// are checked to be on the curve when received.
+
+__extension__ typedef unsigned __int128 gc_u128;
+
+#define GC_FE_MASK ((1ull << 51) - 1)
+
+typedef struct {
+    uint64_t v[5];
+} gc_fe;
+
+// extended coordinates: x = X / Z, y = Y / Z, x y = T / Z
+typedef struct {
+    gc_fe X, Y, Z, T;
+} gc_ge;
+
+#define GC_GE_BYTES 64
+
+static const gc_fe GC_FE_D = { {
+    929955233495203ull, 466365720129213ull, 1662059464998953ull,
+    2033849074728123ull, 1442794654840575ull
+} };
+
+static const gc_fe GC_FE_D2 = { {
+    1859910466990425ull, 932731440258426ull, 1072319116312658ull,
+    1815898335770999ull, 633789495995903ull
+} };
+
+// the standard base point, y = 4/5 and x even
+static const gc_ge GC_GE_BASE = {
+    { { 1738742601995546ull, 1146398526822698ull, 2070867633025821ull,
+        562264141797630ull, 587772402128613ull } },
+    { { 1801439850948184ull, 1351079888211148ull, 450359962737049ull,
+        900719925474099ull, 1801439850948198ull } },
+    { { 1, 0, 0, 0, 0 } },
+    { { 1841354044333475ull, 16398895984059ull, 755974180946558ull,
+        900171276175154ull, 1821297809914039ull } },
+};
+
+// limbs back under 2^51 plus a little, the top carry folded in times 19
+static void gc_fe_carry(gc_fe *h) {
+    uint64_t c;
+    for (int i = 0; i < 4; ++i) {
+        c = h->v[i] >> 51;
+        h->v[i] &= GC_FE_MASK;
+        h->v[i + 1] += c;
+    }
+    c = h->v[4] >> 51;
+    h->v[4] &= GC_FE_MASK;
+    h->v[0] += 19 * c;
+    c = h->v[0] >> 51;
+    h->v[0] &= GC_FE_MASK;
+    h->v[1] += c;
+}
+
+static void gc_fe_add(gc_fe *r, const gc_fe *a, const gc_fe *b) {
+    for (int i = 0; i < 5; ++i) {
+        r->v[i] = a->v[i] + b->v[i];
+    }
+    gc_fe_carry(r);
+}
+
+// a + 2p - b, so carried limbs never go negative
+static void gc_fe_sub(gc_fe *r, const gc_fe *a, const gc_fe *b) {
+    r->v[0] = a->v[0] + 0xfffffffffffdaull - b->v[0];
+    for (int i = 1; i < 5; ++i) {
+        r->v[i] = a->v[i] + 0xffffffffffffeull - b->v[i];
+    }
+    gc_fe_carry(r);
+}
+
+static void gc_fe_mul(gc_fe *r, const gc_fe *a, const gc_fe *b) {
+    const uint64_t *x = a->v, *y = b->v;
+    const uint64_t y1 = 19 * y[1], y2 = 19 * y[2], y3 = 19 * y[3], y4 = 19 * y[4];
+
+    gc_u128 t0 = (gc_u128)x[0] * y[0] + (gc_u128)x[1] * y4 + (gc_u128)x[2] * y3 +
+                 (gc_u128)x[3] * y2 + (gc_u128)x[4] * y1;
+    gc_u128 t1 = (gc_u128)x[0] * y[1] + (gc_u128)x[1] * y[0] + (gc_u128)x[2] * y4 +
+                 (gc_u128)x[3] * y3 + (gc_u128)x[4] * y2;
+    gc_u128 t2 = (gc_u128)x[0] * y[2] + (gc_u128)x[1] * y[1] + (gc_u128)x[2] * y[0] +
+                 (gc_u128)x[3] * y4 + (gc_u128)x[4] * y3;
+    gc_u128 t3 = (gc_u128)x[0] * y[3] + (gc_u128)x[1] * y[2] + (gc_u128)x[2] * y[1] +
+                 (gc_u128)x[3] * y[0] + (gc_u128)x[4] * y4;
+    gc_u128 t4 = (gc_u128)x[0] * y[4] + (gc_u128)x[1] * y[3] + (gc_u128)x[2] * y[2] +
+                 (gc_u128)x[3] * y[1] + (gc_u128)x[4] * y[0];
+
+    t1 += (uint64_t)(t0 >> 51);
+    t2 += (uint64_t)(t1 >> 51);
+    t3 += (uint64_t)(t2 >> 51);
+    t4 += (uint64_t)(t3 >> 51);
+    r->v[0] = ((uint64_t)t0 & GC_FE_MASK) + 19 * (uint64_t)(t4 >> 51);
+    r->v[1] = (uint64_t)t1 & GC_FE_MASK;
+    r->v[2] = (uint64_t)t2 & GC_FE_MASK;
+    r->v[3] = (uint64_t)t3 & GC_FE_MASK;
+    r->v[4] = (uint64_t)t4 & GC_FE_MASK;
+    gc_fe_carry(r);
+}
+
+// a^(p - 2) = 1 / a; p - 2 = 2^255 - 21
+static void gc_fe_invert(gc_fe *r, const gc_fe *a) {
+    gc_fe acc = { { 1, 0, 0, 0, 0 } };
+    for (int i = 254; i >= 0; --i) {
+        gc_fe_mul(&acc, &acc, &acc);
+        // 255 one bits less 20 = 0b10100: only bits 2 and 4 are clear
+        if (i != 2 && i != 4) {
+            gc_fe_mul(&acc, &acc, a);
+        }
+    }
+    *r = acc;
+}
+
+// canonical little-endian encoding, fully reduced mod p
+static void gc_fe_tobytes(uint8_t out[32], const gc_fe *a) {
+    gc_fe t = *a;
+    gc_fe_carry(&t);
+    gc_fe_carry(&t);
+
+    // t < 2p: subtract p once if t + 19 reaches 2^255
+    uint64_t q = (t.v[0] + 19) >> 51;
+    for (int i = 1; i < 5; ++i) {
+        q = (t.v[i] + q) >> 51;
+    }
+    t.v[0] += 19 * q;
+    for (int i = 0; i < 4; ++i) {
+        t.v[i + 1] += t.v[i] >> 51;
+        t.v[i] &= GC_FE_MASK;
+    }
+    t.v[4] &= GC_FE_MASK;
+
+    const uint64_t w[4] = {
+        t.v[0] | (t.v[1] << 51),
+        (t.v[1] >> 13) | (t.v[2] << 38),
+        (t.v[2] >> 26) | (t.v[3] << 25),
+        (t.v[3] >> 39) | (t.v[4] << 12),
+    };
+    for (int i = 0; i < 32; ++i) {
+        out[i] = (uint8_t)(w[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+// the top bit is ignored; callers wanting canonical input re-encode
+static void gc_fe_frombytes(gc_fe *r, const uint8_t in[32]) {
+    uint64_t w[4] = { 0, 0, 0, 0 };
+    for (int i = 31; i >= 0; --i) {
+        w[i / 8] = (w[i / 8] << 8) | in[i];
+    }
+    r->v[0] = w[0] & GC_FE_MASK;
+    r->v[1] = ((w[0] >> 51) | (w[1] << 13)) & GC_FE_MASK;
+    r->v[2] = ((w[1] >> 38) | (w[2] << 26)) & GC_FE_MASK;
+    r->v[3] = ((w[2] >> 25) | (w[3] << 39)) & GC_FE_MASK;
+    r->v[4] = (w[3] >> 12) & GC_FE_MASK;
+}
+
+static int gc_fe_equal(const gc_fe *a, const gc_fe *b) {
+    uint8_t ea[32], eb[32];
+    gc_fe_tobytes(ea, a);
+    gc_fe_tobytes(eb, b);
+    return memcmp(ea, eb, 32) == 0;
+}
+
+static void gc_ge_identity(gc_ge *p) {
+    memset(p, 0, sizeof(*p));
+    p->Y.v[0] = 1;
+    p->Z.v[0] = 1;
+}
+
+// add-2008-hwcd-3 for a = -1; also doubles
+static void gc_ge_add(gc_ge *r, const gc_ge *p, const gc_ge *q) {
+    gc_fe a, b, c, d, e, f, g, h, t;
+
+    gc_fe_sub(&a, &p->Y, &p->X);
+    gc_fe_sub(&t, &q->Y, &q->X);
+    gc_fe_mul(&a, &a, &t);
+    gc_fe_add(&b, &p->Y, &p->X);
+    gc_fe_add(&t, &q->Y, &q->X);
+    gc_fe_mul(&b, &b, &t);
+    gc_fe_mul(&c, &p->T, &q->T);
+    gc_fe_mul(&c, &c, &GC_FE_D2);
+    gc_fe_mul(&d, &p->Z, &q->Z);
+    gc_fe_add(&d, &d, &d);
+
+    gc_fe_sub(&e, &b, &a);
+    gc_fe_sub(&f, &d, &c);
+    gc_fe_add(&g, &d, &c);
+    gc_fe_add(&h, &b, &a);
+
+    gc_fe_mul(&r->X, &e, &f);
+    gc_fe_mul(&r->Y, &g, &h);
+    gc_fe_mul(&r->T, &e, &h);
+    gc_fe_mul(&r->Z, &f, &g);
+}
+
+static void gc_ge_neg(gc_ge *r, const gc_ge *p) {
+    const gc_fe zero = { { 0, 0, 0, 0, 0 } };
+    gc_fe_sub(&r->X, &zero, &p->X);
+    r->Y = p->Y;
+    r->Z = p->Z;
+    gc_fe_sub(&r->T, &zero, &p->T);
+}
+
+// r = a if bit, else r unchanged
+static void gc_fe_cmov(gc_fe *r, const gc_fe *a, uint64_t mask) {
+    for (int i = 0; i < 5; ++i) {
+        r->v[i] ^= (r->v[i] ^ a->v[i]) & mask;
+    }
+}
+
+static void gc_ge_cmov(gc_ge *r, const gc_ge *a, uint64_t bit) {
+    const uint64_t mask = (uint64_t)0 - bit;
+    gc_fe_cmov(&r->X, &a->X, mask);
+    gc_fe_cmov(&r->Y, &a->Y, mask);
+    gc_fe_cmov(&r->Z, &a->Z, mask);
+    gc_fe_cmov(&r->T, &a->T, mask);
+}
+
+// scalar is 256 bits little-endian; every bit costs the same
+static void gc_ge_scalarmult(gc_ge *r, const gc_ge *p, const uint8_t scalar[32]) {
+    gc_ge acc, sum;
+    gc_ge_identity(&acc);
+    for (int i = 255; i >= 0; --i) {
+        gc_ge_add(&acc, &acc, &acc);
+        gc_ge_add(&sum, &acc, p);
+        gc_ge_cmov(&acc, &sum, (scalar[i / 8] >> (i % 8)) & 1u);
+    }
+    *r = acc;
+    gc_secure_memzero(&acc, sizeof(acc));
+    gc_secure_memzero(&sum, sizeof(sum));
+}
+
+static void gc_ge_tobytes(uint8_t out[GC_GE_BYTES], const gc_ge *p) {
+    gc_fe zi, x, y;
+    gc_fe_invert(&zi, &p->Z);
+    gc_fe_mul(&x, &p->X, &zi);
+    gc_fe_mul(&y, &p->Y, &zi);
+    gc_fe_tobytes(out, &x);
+    gc_fe_tobytes(out + 32, &y);
+}
+
+// -2 unless in holds a canonical affine point on the curve
+static int gc_ge_frombytes(gc_ge *p, const uint8_t in[GC_GE_BYTES]) {
+    uint8_t check[32];
+    gc_fe_frombytes(&p->X, in);
+    gc_fe_frombytes(&p->Y, in + 32);
+    gc_fe_tobytes(check, &p->X);
+    if (memcmp(check, in, 32) != 0) {
+        return -2;
+    }
+    gc_fe_tobytes(check, &p->Y);
+    if (memcmp(check, in + 32, 32) != 0) {
+        return -2;
+    }
+
+    gc_fe xx, yy, lhs, rhs;
+    const gc_fe one = { { 1, 0, 0, 0, 0 } };
+    gc_fe_mul(&xx, &p->X, &p->X);
+    gc_fe_mul(&yy, &p->Y, &p->Y);
+    gc_fe_sub(&lhs, &yy, &xx);
+    gc_fe_mul(&rhs, &xx, &yy);
+    gc_fe_mul(&rhs, &rhs, &GC_FE_D);
+    gc_fe_add(&rhs, &rhs, &one);
+    if (!gc_fe_equal(&lhs, &rhs)) {
+        return -2;
+    }
+
+    p->Z = one;
+    gc_fe_mul(&p->T, &p->X, &p->Y);
+    return 0;
+}
+
+// the OT key for index j: a hash of the transcript and the shared point
+static void gc_base_ot_key(
+    const uint8_t  a_bytes[GC_GE_BYTES],
+    const uint8_t  b_bytes[GC_GE_BYTES],
+    const gc_ge   *shared,
+    size_t         j,
+    gc_label      *out
+) {
+    static const char domain[] = "gc-ot-base-co";
+    uint8_t p_bytes[GC_GE_BYTES], idx[8];
+    gc_ge_tobytes(p_bytes, shared);
+    for (int i = 0; i < 8; ++i) {
+        idx[i] = (uint8_t)((uint64_t)j >> (8 * i));
+    }
+
+    blake3_hasher hasher;
+    blake3_hasher_init(&hasher);
+    blake3_hasher_update(&hasher, domain, sizeof(domain));
+    blake3_hasher_update(&hasher, a_bytes, GC_GE_BYTES);
+    blake3_hasher_update(&hasher, b_bytes, GC_GE_BYTES);
+    blake3_hasher_update(&hasher, p_bytes, GC_GE_BYTES);
+    blake3_hasher_update(&hasher, idx, sizeof(idx));
+    blake3_hasher_finalize(&hasher, out->b, GC_LABEL_BYTES);
+    gc_secure_memzero(p_bytes, sizeof(p_bytes));
+}
+
+// sender: A = aG out; for each B_j in, keys from aB_j and a(B_j - A)
+int gc_base_ot_send(gc_channel *ch, size_t n, gc_label *out0, gc_label *out1) {
+    if (!ch || (n && (!out0 || !out1)) || n > SIZE_MAX / GC_GE_BYTES) {
+        return -1;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    uint8_t a[32], a_bytes[GC_GE_BYTES];
+    gc_ge A, aA, B, P;
+    uint8_t *b_bytes = (uint8_t *)malloc(n * GC_GE_BYTES);
+    if (!b_bytes) {
+        return -3;
+    }
+    int rc = 0;
+    if (gc_random_bytes(a, sizeof(a)) != 0) {
+        rc = -8;
+        goto done;
+    }
+
+    gc_ge_scalarmult(&A, &GC_GE_BASE, a);
+    gc_ge_tobytes(a_bytes, &A);
+    gc_ge_scalarmult(&aA, &A, a);
+    gc_ge_neg(&aA, &aA);
+
+    if (gc_channel_send(ch, a_bytes, sizeof(a_bytes)) != 0 ||
+        gc_channel_recv(ch, b_bytes, n * GC_GE_BYTES) != 0) {
+        rc = -4;
+        goto done;
+    }
+    for (size_t j = 0; j < n; ++j) {
+        const uint8_t *bj = b_bytes + j * GC_GE_BYTES;
+        if (gc_ge_frombytes(&B, bj) != 0) {
+            rc = -2;
+            goto done;
+        }
+        gc_ge_scalarmult(&P, &B, a);
+        gc_base_ot_key(a_bytes, bj, &P, j, &out0[j]);
+        gc_ge_add(&P, &P, &aA);
+        gc_base_ot_key(a_bytes, bj, &P, j, &out1[j]);
+    }
+
+done:
+    gc_secure_memzero(a, sizeof(a));
+    gc_secure_memzero(&aA, sizeof(aA));
+    gc_secure_memzero(&P, sizeof(P));
+    free(b_bytes);
+    return rc;
+}
+
+// receiver: B_j = b_j G, plus A when the choice is 1; key from b_j A
+int gc_base_ot_recv(gc_channel *ch, size_t n, const uint8_t *choices, gc_label *out) {
+    if (!ch || (n && (!choices || !out)) || n > SIZE_MAX / GC_GE_BYTES) {
+        return -1;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    uint8_t a_bytes[GC_GE_BYTES];
+    gc_ge A, B, sum, P;
+    uint8_t *b_bytes = (uint8_t *)malloc(n * GC_GE_BYTES);
+    uint8_t (*b)[32] = (uint8_t (*)[32])malloc(n * 32);
+    if (!b_bytes || !b) {
+        free(b_bytes);
+        free(b);
+        return -3;
+    }
+    int rc = 0;
+    if (gc_random_bytes(&b[0][0], n * 32) != 0) {
+        rc = -8;
+        goto done;
+    }
+
+    if (gc_channel_recv(ch, a_bytes, sizeof(a_bytes)) != 0) {
+        rc = -4;
+        goto done;
+    }
+    if (gc_ge_frombytes(&A, a_bytes) != 0) {
+        rc = -2;
+        goto done;
+    }
+    for (size_t j = 0; j < n; ++j) {
+        gc_ge_scalarmult(&B, &GC_GE_BASE, b[j]);
+        gc_ge_add(&sum, &B, &A);
+        gc_ge_cmov(&B, &sum, (choices[j / 8] >> (j % 8)) & 1u);
+        gc_ge_tobytes(b_bytes + j * GC_GE_BYTES, &B);
+    }
+    if (gc_channel_send(ch, b_bytes, n * GC_GE_BYTES) != 0) {
+        rc = -4;
+        goto done;
+    }
+    for (size_t j = 0; j < n; ++j) {
+        gc_ge_scalarmult(&P, &A, b[j]);
+        gc_base_ot_key(a_bytes, b_bytes + j * GC_GE_BYTES, &P, j, &out[j]);
+    }
+
+done:
+    gc_secure_memzero(&b[0][0], n * 32);
+    gc_secure_memzero(&P, sizeof(P));
+    free(b);
+    free(b_bytes);
+    return rc;
+}
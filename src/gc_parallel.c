@@ -0,0 +1,325 @@
+#include "gc_core.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gc_internal.h"
+#include "gc_pool.h"
+
+#define GC_LEVEL_UNDEF UINT32_MAX
+
+typedef void (*gc_gate_get)(const void *gates, size_t i, gc_gate *g);
+
+static void gc_get_plain(const void *gates, size_t i, gc_gate *g) {
+    *g = ((const gc_gate *)gates)[i];
+}
+
+static void gc_get_garbled(const void *gates, size_t i, gc_gate *g) {
+    const gc_garbled_gate *gg = &((const gc_garbled_gate *)gates)[i];
+    g->in0  = gg->in0;
+    g->in1  = gg->in1;
+    g->out  = gg->out;
+    g->type = gg->type;
+}
+
+// a gate's level is the highest level among the wires it reads, with inputs
+// at 0 and a gate's output one above the gate.
+// running gates level by level only works if every wire has exactly one
+// writer that precedes its readers, so anything else is rejected with -6.
+static int gc_levelize_impl(
+    gc_wire_id        n_wires,
+    gc_wire_id        n_inputs,
+    const gc_wire_id *input_wires,
+    size_t            n_gates,
+    const void       *gates,
+    gc_gate_get       get,
+    gc_levels        *out
+) {
+    memset(out, 0, sizeof(*out));
+
+    uint32_t *wire_level = (uint32_t *)malloc((size_t)(n_wires ? n_wires : 1) * sizeof(uint32_t));
+    uint32_t *gate_level = (uint32_t *)malloc((n_gates ? n_gates : 1) * sizeof(uint32_t));
+    if (!wire_level || !gate_level) {
+        free(wire_level);
+        free(gate_level);
+        return -2;
+    }
+    for (gc_wire_id w = 0; w < n_wires; ++w) {
+        wire_level[w] = GC_LEVEL_UNDEF;
+    }
+
+    int rc = 0;
+    for (gc_wire_id i = 0; i < n_inputs && rc == 0; ++i) {
+        gc_wire_id w = input_wires[i];
+        if (w >= n_wires) {
+            rc = -5;
+        } else if (wire_level[w] != GC_LEVEL_UNDEF) {
+            rc = -6;
+        } else {
+            wire_level[w] = 0;
+        }
+    }
+
+    uint32_t max_level = 0;
+    for (size_t gi = 0; gi < n_gates && rc == 0; ++gi) {
+        gc_gate g;
+        get(gates, gi, &g);
+        if (g.type != GC_GATE_AND && g.type != GC_GATE_XOR && g.type != GC_GATE_NOT) {
+            rc = -4;
+            break;
+        }
+        if (g.in0 >= n_wires || g.out >= n_wires ||
+            (g.type != GC_GATE_NOT && g.in1 >= n_wires)) {
+            rc = -5;
+            break;
+        }
+
+        uint32_t l = wire_level[g.in0];
+        if (g.type != GC_GATE_NOT) {
+            uint32_t l1 = wire_level[g.in1];
+            if (l1 == GC_LEVEL_UNDEF || (l != GC_LEVEL_UNDEF && l1 > l)) {
+                l = l1;
+            }
+        }
+        if (l == GC_LEVEL_UNDEF || wire_level[g.out] != GC_LEVEL_UNDEF) {
+            rc = -6;
+            break;
+        }
+        gate_level[gi] = l;
+        wire_level[g.out] = l + 1;
+        if (l + 1 > max_level) {
+            max_level = l + 1;
+        }
+    }
+
+    if (rc == 0) {
+        out->n_levels    = max_level;
+        out->level_start = (size_t *)calloc((size_t)max_level + 2, sizeof(size_t));
+        out->order       = (size_t *)malloc((n_gates ? n_gates : 1) * sizeof(size_t));
+        if (!out->level_start || !out->order) {
+            gc_levels_free(out);
+            rc = -2;
+        }
+    }
+
+    if (rc == 0) {
+        // counting sort by level, stable so gate order is kept within a level
+        for (size_t gi = 0; gi < n_gates; ++gi) {
+            ++out->level_start[gate_level[gi] + 1];
+        }
+        for (size_t l = 1; l <= max_level; ++l) {
+            out->level_start[l] += out->level_start[l - 1];
+        }
+        for (size_t gi = 0; gi < n_gates; ++gi) {
+            out->order[out->level_start[gate_level[gi]]++] = gi;
+        }
+        // the scatter advanced each start to the next level's; shift back
+        memmove(out->level_start + 1, out->level_start, (size_t)max_level * sizeof(size_t));
+        out->level_start[0] = 0;
+    }
+
+    free(wire_level);
+    free(gate_level);
+    return rc;
+}
+
+int gc_levelize(const gc_circuit *c, gc_levels *out) {
+    if (!c || !out) {
+        return -1;
+    }
+    return gc_levelize_impl(c->n_wires, c->n_inputs, c->input_wires,
+                            c->n_gates, c->gates, gc_get_plain, out);
+}
+
+int gc_levelize_garbled(const gc_garbled_circuit *gc, gc_levels *out) {
+    if (!gc || !out) {
+        return -1;
+    }
+    return gc_levelize_impl(gc->n_wires, gc->n_inputs, gc->input_wires,
+                            gc->n_gates, gc->gates, gc_get_garbled, out);
+}
+
+void gc_levels_free(gc_levels *lv) {
+    if (!lv) return;
+    free(lv->level_start);
+    free(lv->order);
+    memset(lv, 0, sizeof(*lv));
+}
+
+static int gc_levels_wide(const gc_levels *lv, size_t n_gates, const gc_pool *pool) {
+    return gc_pool_threads(pool) > 1 && lv->n_levels > 0 &&
+           n_gates / lv->n_levels >= GC_PARALLEL_MIN_WIDTH;
+}
+
+typedef struct {
+    gc_garble_mode        mode;
+    const gc_garble_keys *keys;
+    const gc_circuit     *plain;
+    gc_garbled_circuit   *gc;
+    const size_t         *order;
+} gc_par_garble;
+
+static void gc_par_derive(void *ctx, size_t begin, size_t end, size_t worker) {
+    gc_par_garble *j = (gc_par_garble *)ctx;
+    (void)worker;
+    gc_derive_labels0(j->keys, (gc_wire_id)begin, (gc_wire_id)(end - begin),
+                      &j->gc->wire_labels0[begin]);
+}
+
+static void gc_par_garble_level(void *ctx, size_t begin, size_t end, size_t worker) {
+    gc_par_garble *j = (gc_par_garble *)ctx;
+    (void)worker;
+    // gates of one level never read each other's outputs, so the AND gates
+    // of a range batch up fully
+    gc_garble_batch batch = { .mode = j->mode, .delta = &j->keys->delta };
+    for (size_t i = begin; i < end; ++i) {
+        size_t gi = j->order[i];
+        // indices and types were checked by gc_levelize
+        (void)gc_garble_gate_batched(&batch, gi, &j->plain->gates[gi],
+                                     &j->gc->gates[gi], j->gc->wire_labels0, j->gc->n_wires);
+    }
+    gc_garble_batch_flush(&batch);
+}
+
+static void gc_par_one_labels(void *ctx, size_t begin, size_t end, size_t worker) {
+    gc_par_garble *j = (gc_par_garble *)ctx;
+    (void)worker;
+    for (size_t w = begin; w < end; ++w) {
+        gc_label_xor(&j->gc->wire_labels0[w], &j->keys->delta, &j->gc->wire_labels1[w]);
+    }
+}
+
+int gc_garble_parallel(
+    const gc_circuit    *plain,
+    gc_garble_mode       mode,
+    const uint8_t       *seed,
+    gc_pool             *pool,
+    gc_garbled_circuit **out_gc
+) {
+    if (!plain || !out_gc) {
+        return -1;
+    }
+    if (mode != GC_GARBLE_CLASSIC && mode != GC_GARBLE_HALF_GATES) {
+        return -1;
+    }
+    if (gc_pool_threads(pool) <= 1) {
+        return gc_garble_seeded(plain, mode, seed, out_gc);
+    }
+
+    gc_levels lv;
+    if (gc_levelize(plain, &lv) != 0 || !gc_levels_wide(&lv, plain->n_gates, pool)) {
+        // narrow or not single-assignment: the sequential path handles it
+        gc_levels_free(&lv);
+        return gc_garble_seeded(plain, mode, seed, out_gc);
+    }
+
+    gc_garbled_circuit *gc = gc_garbled_alloc(plain, mode);
+    if (!gc) {
+        gc_levels_free(&lv);
+        return -3;
+    }
+
+    gc_garble_keys keys;
+    if (gc_garble_keys_init(&keys, seed) != 0) {
+        gc_garbled_free(gc);
+        gc_levels_free(&lv);
+        return -8;
+    }
+
+    gc_par_garble job = { mode, &keys, plain, gc, lv.order };
+    gc_pool_for(pool, gc->n_wires, 0, gc_par_derive, &job);
+    for (size_t l = 0; l < lv.n_levels; ++l) {
+        job.order = lv.order + lv.level_start[l];
+        gc_pool_for(pool, lv.level_start[l + 1] - lv.level_start[l], 0,
+                    gc_par_garble_level, &job);
+    }
+    gc_pool_for(pool, gc->n_wires, 0, gc_par_one_labels, &job);
+
+    gc_garble_keys_wipe(&keys);
+    gc_levels_free(&lv);
+    *out_gc = gc;
+    return 0;
+}
+
+typedef struct {
+    const gc_garbled_circuit *gc;
+    const size_t             *order;
+    gc_label                 *wire_vals;
+} gc_par_eval;
+
+static void gc_par_eval_level(void *ctx, size_t begin, size_t end, size_t worker) {
+    gc_par_eval *j = (gc_par_eval *)ctx;
+    (void)worker;
+    gc_eval_batch batch = { .mode = j->gc->mode };
+    for (size_t i = begin; i < end; ++i) {
+        size_t gi = j->order[i];
+        gc_eval_gate(&batch, gi, &j->gc->gates[gi], j->wire_vals);
+    }
+    gc_eval_batch_flush(&batch);
+}
+
+int gc_evaluator_eval_parallel(
+    gc_evaluator             *ev,
+    const gc_garbled_circuit *gc,
+    const gc_levels          *lv,
+    gc_pool                  *pool,
+    const gc_label           *input_labels,
+    gc_label                 *output_labels
+) {
+    if (!ev || !gc || !input_labels || !output_labels) {
+        return -1;
+    }
+    if (gc_pool_threads(pool) <= 1) {
+        return gc_evaluator_eval(ev, gc, input_labels, output_labels);
+    }
+
+    gc_levels own;
+    memset(&own, 0, sizeof(own));
+    if (!lv) {
+        if (gc_levelize_garbled(gc, &own) != 0) {
+            gc_levels_free(&own);
+            return gc_evaluator_eval(ev, gc, input_labels, output_labels);
+        }
+        lv = &own;
+    }
+    if (!gc_levels_wide(lv, gc->n_gates, pool)) {
+        gc_levels_free(&own);
+        return gc_evaluator_eval(ev, gc, input_labels, output_labels);
+    }
+
+    int rc = 0;
+    gc_label *wire_vals = gc_evaluator_buffer(ev, gc->n_wires);
+    if (!wire_vals) {
+        rc = -2;
+        goto done;
+    }
+
+    for (gc_wire_id i = 0; i < gc->n_inputs; ++i) {
+        gc_wire_id w = gc->input_wires[i];
+        if (w >= gc->n_wires) {
+            rc = -3;
+            goto done;
+        }
+        wire_vals[w] = input_labels[i];
+    }
+
+    gc_par_eval job = { gc, NULL, wire_vals };
+    for (size_t l = 0; l < lv->n_levels; ++l) {
+        job.order = lv->order + lv->level_start[l];
+        gc_pool_for(pool, lv->level_start[l + 1] - lv->level_start[l], 0,
+                    gc_par_eval_level, &job);
+    }
+
+    for (gc_wire_id i = 0; i < gc->n_outputs; ++i) {
+        gc_wire_id w = gc->output_wires[i];
+        if (w >= gc->n_wires) {
+            rc = -5;
+            goto done;
+        }
+        output_labels[i] = wire_vals[w];
+    }
+
+done:
+    gc_levels_free(&own);
+    return rc;
+}
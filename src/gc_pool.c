@@ -0,0 +1,237 @@
+// sysconf is POSIX, hidden by -std=c11
+#define _POSIX_C_SOURCE 200809L
+
+#include "gc_pool.h"
+
+#include <stdlib.h>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define GC_POOL_THREADS 0
+#else
+#define GC_POOL_THREADS 1
+#endif
+
+#if GC_POOL_THREADS
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+// one range per worker, padded so the counters of different workers never
+// share a cache line
+typedef struct {
+    _Alignas(64) atomic_size_t next;
+    size_t end;
+} gc_pool_range;
+
+typedef struct {
+    gc_pool *pool;
+    size_t   index;
+} gc_pool_worker;
+
+struct gc_pool {
+    size_t          n_threads;
+    pthread_t      *threads;
+    gc_pool_worker *workers;
+    gc_pool_range  *ranges;
+
+    pthread_mutex_t mu;
+    pthread_cond_t  cv_start;
+    pthread_cond_t  cv_done;
+    unsigned long   generation;
+    size_t          n_running;
+    int             stop;
+
+    // the loop in flight
+    gc_pool_fn fn;
+    void      *ctx;
+    size_t     grain;
+};
+
+static void gc_pool_drain(gc_pool *pool, size_t self) {
+    const size_t n = pool->n_threads;
+    const size_t grain = pool->grain;
+
+    // own range first, then steal from the others in ring order
+    for (size_t k = 0; k < n; ++k) {
+        gc_pool_range *r = &pool->ranges[(self + k) % n];
+        for (;;) {
+            size_t b = atomic_fetch_add_explicit(&r->next, grain, memory_order_relaxed);
+            if (b >= r->end) {
+                break;
+            }
+            size_t e = (r->end - b < grain) ? r->end : b + grain;
+            pool->fn(pool->ctx, b, e, self);
+        }
+    }
+}
+
+static void *gc_pool_main(void *arg) {
+    gc_pool_worker *w = (gc_pool_worker *)arg;
+    gc_pool *pool = w->pool;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->mu);
+    for (;;) {
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->cv_start, &pool->mu);
+        }
+        if (pool->stop) {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->mu);
+
+        gc_pool_drain(pool, w->index);
+
+        pthread_mutex_lock(&pool->mu);
+        if (--pool->n_running == 0) {
+            pthread_cond_signal(&pool->cv_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mu);
+    return NULL;
+}
+
+gc_pool *gc_pool_create(size_t n_threads) {
+    if (n_threads == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        n_threads = (n > 0) ? (size_t)n : 1;
+    }
+
+    gc_pool *pool = (gc_pool *)calloc(1, sizeof(gc_pool));
+    if (!pool) {
+        return NULL;
+    }
+    pool->n_threads = n_threads;
+    pool->threads = (pthread_t *)calloc(n_threads, sizeof(pthread_t));
+    pool->workers = (gc_pool_worker *)calloc(n_threads, sizeof(gc_pool_worker));
+    pool->ranges  = (gc_pool_range *)aligned_alloc(_Alignof(gc_pool_range),
+                                                   n_threads * sizeof(gc_pool_range));
+    if (!pool->threads || !pool->workers || !pool->ranges) {
+        free(pool->threads);
+        free(pool->workers);
+        free(pool->ranges);
+        free(pool);
+        return NULL;
+    }
+    for (size_t i = 0; i < n_threads; ++i) {
+        atomic_init(&pool->ranges[i].next, 0);
+        pool->ranges[i].end = 0;
+    }
+
+    pthread_mutex_init(&pool->mu, NULL);
+    pthread_cond_init(&pool->cv_start, NULL);
+    pthread_cond_init(&pool->cv_done, NULL);
+
+    // worker 0 is whoever calls gc_pool_for
+    for (size_t i = 1; i < n_threads; ++i) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        if (pthread_create(&pool->threads[i], NULL, gc_pool_main, &pool->workers[i]) != 0) {
+            pool->n_threads = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+void gc_pool_destroy(gc_pool *pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mu);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->cv_start);
+    pthread_mutex_unlock(&pool->mu);
+    for (size_t i = 1; i < pool->n_threads; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->mu);
+    pthread_cond_destroy(&pool->cv_start);
+    pthread_cond_destroy(&pool->cv_done);
+    free(pool->threads);
+    free(pool->workers);
+    free(pool->ranges);
+    free(pool);
+}
+
+size_t gc_pool_threads(const gc_pool *pool) {
+    return pool ? pool->n_threads : 1;
+}
+
+void gc_pool_for(gc_pool *pool, size_t n, size_t grain, gc_pool_fn fn, void *ctx) {
+    if (n == 0) {
+        return;
+    }
+    if (!pool || pool->n_threads == 1) {
+        fn(ctx, 0, n, 0);
+        return;
+    }
+
+    const size_t t = pool->n_threads;
+    if (grain == 0) {
+        // ~8 pieces per thread leaves room for stealing without making the
+        // shared counters hot
+        grain = n / (8 * t);
+        if (grain == 0) {
+            grain = 1;
+        }
+    }
+
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->grain = grain;
+    for (size_t i = 0; i < t; ++i) {
+        atomic_store_explicit(&pool->ranges[i].next, n * i / t, memory_order_relaxed);
+        pool->ranges[i].end = n * (i + 1) / t;
+    }
+
+    pthread_mutex_lock(&pool->mu);
+    pool->n_running = t - 1;
+    ++pool->generation;
+    pthread_cond_broadcast(&pool->cv_start);
+    pthread_mutex_unlock(&pool->mu);
+
+    gc_pool_drain(pool, 0);
+
+    pthread_mutex_lock(&pool->mu);
+    while (pool->n_running > 0) {
+        pthread_cond_wait(&pool->cv_done, &pool->mu);
+    }
+    pthread_mutex_unlock(&pool->mu);
+}
+
+#else // !GC_POOL_THREADS
+
+struct gc_pool {
+    size_t n_threads;
+};
+
+gc_pool *gc_pool_create(size_t n_threads) {
+    (void)n_threads;
+    gc_pool *pool = (gc_pool *)calloc(1, sizeof(gc_pool));
+    if (pool) {
+        pool->n_threads = 1;
+    }
+    return pool;
+}
+
+void gc_pool_destroy(gc_pool *pool) {
+    free(pool);
+}
+
+size_t gc_pool_threads(const gc_pool *pool) {
+    (void)pool;
+    return 1;
+}
+
+void gc_pool_for(gc_pool *pool, size_t n, size_t grain, gc_pool_fn fn, void *ctx) {
+    (void)pool;
+    (void)grain;
+    if (n > 0) {
+        fn(ctx, 0, n, 0);
+    }
+}
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// fixed-size thread pool running parallel-for loops. each call splits
+// [0, n) into one contiguous range per thread; a thread hands itself
+// grain-sized pieces of its own range and, once that is empty, steals
+// pieces from the other ranges, so uneven work evens out without a central
+// queue. the calling thread takes part as worker 0.
+//
+// builds without threads (Emscripten without -pthread) get a pool of one
+// thread that runs every loop inline.
+typedef struct gc_pool gc_pool;
+
+// body of a loop: handles items [begin, end). worker is in [0, n_threads)
+// and is stable for the call, e.g. to index per-thread scratch.
+typedef void (*gc_pool_fn)(void *ctx, size_t begin, size_t end, size_t worker);
+
+// n_threads = 0 uses the number of online CPUs
+gc_pool *gc_pool_create(size_t n_threads);
+
+void gc_pool_destroy(gc_pool *pool);
+
+size_t gc_pool_threads(const gc_pool *pool);
+
+// runs fn over [0, n) and returns once every item is done. grain = 0 picks
+// one from n and the thread count. not reentrant: fn must not call
+// gc_pool_for on the same pool.
+void gc_pool_for(gc_pool *pool, size_t n, size_t grain, gc_pool_fn fn, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
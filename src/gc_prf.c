@@ -0,0 +1,415 @@
+#include "gc_prf.h"
+
+#include <string.h>
+
+#include "psi_hash_blake3.h"
+#include "blake3.h"
+// blake3_hash_many, the multi-input kernels behind the SIMD backends
+#include "blake3_impl.h"
+
+#if !defined(__EMSCRIPTEN__) && defined(__x86_64__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define GC_PRF_HAVE_AESNI 1
+#include <wmmintrin.h>
+#include <emmintrin.h>
+#endif
+
+// separate from the label derivation key in gc_core.c
+static const uint8_t GC_ROW_PRF_KEY[PSI_BLAKE3_KEY_LEN] = {
+    0x47, 0x43, 0x2d, 0x52, 0x4f, 0x57, 0x2d, 0x4b,
+    0x65, 0x79, 0x2d, 0x31, 0x32, 0x33, 0x34, 0x56,
+    0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf6, 0x11, 0x22,
+    0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa
+};
+
+// AES-128 round keys for the public key "psi-gc fixed key", expanded ahead
+// of time so the backend needs no initialisation and is trivially reentrant
+static const uint8_t GC_AES_ROUND_KEYS[11][16] = {
+    { 0x70, 0x73, 0x69, 0x2d, 0x67, 0x63, 0x20, 0x66,
+      0x69, 0x78, 0x65, 0x64, 0x20, 0x6b, 0x65, 0x79 },
+    { 0x0e, 0x3e, 0xdf, 0x9a, 0x69, 0x5d, 0xff, 0xfc,
+      0x00, 0x25, 0x9a, 0x98, 0x20, 0x4e, 0xff, 0xe1 },
+    { 0x23, 0x28, 0x27, 0x2d, 0x4a, 0x75, 0xd8, 0xd1,
+      0x4a, 0x50, 0x42, 0x49, 0x6a, 0x1e, 0xbd, 0xa8 },
+    { 0x55, 0x52, 0xe5, 0x2f, 0x1f, 0x27, 0x3d, 0xfe,
+      0x55, 0x77, 0x7f, 0xb7, 0x3f, 0x69, 0xc2, 0x1f },
+    { 0xa4, 0x77, 0x25, 0x5a, 0xbb, 0x50, 0x18, 0xa4,
+      0xee, 0x27, 0x67, 0x13, 0xd1, 0x4e, 0xa5, 0x0c },
+    { 0x9b, 0x71, 0xdb, 0x64, 0x20, 0x21, 0xc3, 0xc0,
+      0xce, 0x06, 0xa4, 0xd3, 0x1f, 0x48, 0x01, 0xdf },
+    { 0xe9, 0x0d, 0x45, 0xa4, 0xc9, 0x2c, 0x86, 0x64,
+      0x07, 0x2a, 0x22, 0xb7, 0x18, 0x62, 0x23, 0x68 },
+    { 0x03, 0x2b, 0x00, 0x09, 0xca, 0x07, 0x86, 0x6d,
+      0xcd, 0x2d, 0xa4, 0xda, 0xd5, 0x4f, 0x87, 0xb2 },
+    { 0x07, 0x3c, 0x37, 0x0a, 0xcd, 0x3b, 0xb1, 0x67,
+      0x00, 0x16, 0x15, 0xbd, 0xd5, 0x59, 0x92, 0x0f },
+    { 0xd7, 0x73, 0x41, 0x09, 0x1a, 0x48, 0xf0, 0x6e,
+      0x1a, 0x5e, 0xe5, 0xd3, 0xcf, 0x07, 0x77, 0xdc },
+    { 0x24, 0x86, 0xc7, 0x83, 0x3e, 0xce, 0x37, 0xed,
+      0x24, 0x90, 0xd2, 0x3e, 0xeb, 0x97, 0xa5, 0xe2 },
+};
+
+static const uint8_t GC_AES_SBOX[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+static void store_le64(uint8_t *p, uint64_t v) {
+    for (size_t i = 0; i < 8; ++i) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint64_t load_le64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        v |= (uint64_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+// every BLAKE3 PRF input is one zero-padded 64-byte block, so a single
+// call and a lane of blake3_hash_many compute the same compression
+static void gc_prf_block2(uint8_t block[GC_PRF_BLOCK_BYTES], const gc_label *ka,
+                          const gc_label *kb, uint64_t tweak) {
+    memset(block, 0, GC_PRF_BLOCK_BYTES);
+    memcpy(block, ka->b, GC_LABEL_BYTES);
+    memcpy(block + GC_LABEL_BYTES, kb->b, GC_LABEL_BYTES);
+    store_le64(block + 2 * GC_LABEL_BYTES, tweak);
+    block[2 * GC_LABEL_BYTES + 8] = 0x3C;
+}
+
+static void gc_prf_block1(uint8_t block[GC_PRF_BLOCK_BYTES], const gc_label *k,
+                          uint64_t tweak) {
+    memset(block, 0, GC_PRF_BLOCK_BYTES);
+    memcpy(block, k->b, GC_LABEL_BYTES);
+    store_le64(block + GC_LABEL_BYTES, tweak);
+    block[GC_LABEL_BYTES + 8] = 0x48;
+}
+
+void gc_prf_blake3_blocks(
+    const uint8_t  key[32],
+    const uint8_t *blocks,
+    size_t         n,
+    gc_label      *out
+) {
+    uint32_t key_words[8];
+    load_key_words(key, key_words);
+
+    const uint8_t *inputs[GC_PRF_LANES];
+    uint8_t digests[GC_PRF_LANES * BLAKE3_OUT_LEN];
+
+    for (size_t done = 0; done < n;) {
+        size_t m = (n - done < GC_PRF_LANES) ? n - done : GC_PRF_LANES;
+        for (size_t i = 0; i < m; ++i) {
+            inputs[i] = blocks + (done + i) * GC_PRF_BLOCK_BYTES;
+        }
+        // a one-block message is a whole chunk and also the root
+        blake3_hash_many(inputs, m, 1, key_words, 0, false,
+                         KEYED_HASH, CHUNK_START, CHUNK_END | ROOT, digests);
+        for (size_t i = 0; i < m; ++i) {
+            memcpy(out[done + i].b, digests + i * BLAKE3_OUT_LEN, GC_LABEL_BYTES);
+        }
+        done += m;
+    }
+}
+
+void gc_prf_blake3_hash2(const gc_label *ka, const gc_label *kb, uint64_t tweak, gc_label *out) {
+    uint8_t block[GC_PRF_BLOCK_BYTES];
+    gc_prf_block2(block, ka, kb, tweak);
+    gc_prf_blake3_blocks(GC_ROW_PRF_KEY, block, 1, out);
+}
+
+void gc_prf_blake3_hash1(const gc_label *k, uint64_t tweak, gc_label *out) {
+    uint8_t block[GC_PRF_BLOCK_BYTES];
+    gc_prf_block1(block, k, tweak);
+    gc_prf_blake3_blocks(GC_ROW_PRF_KEY, block, 1, out);
+}
+
+void gc_prf_blake3_hash2_many(
+    const gc_label *ka,
+    const gc_label *kb,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+) {
+    uint8_t blocks[GC_PRF_LANES * GC_PRF_BLOCK_BYTES];
+    for (size_t done = 0; done < n;) {
+        size_t m = (n - done < GC_PRF_LANES) ? n - done : GC_PRF_LANES;
+        for (size_t i = 0; i < m; ++i) {
+            gc_prf_block2(blocks + i * GC_PRF_BLOCK_BYTES,
+                          &ka[done + i], &kb[done + i], tweak[done + i]);
+        }
+        gc_prf_blake3_blocks(GC_ROW_PRF_KEY, blocks, m, out + done);
+        done += m;
+    }
+}
+
+void gc_prf_blake3_hash1_many(
+    const gc_label *k,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+) {
+    uint8_t blocks[GC_PRF_LANES * GC_PRF_BLOCK_BYTES];
+    for (size_t done = 0; done < n;) {
+        size_t m = (n - done < GC_PRF_LANES) ? n - done : GC_PRF_LANES;
+        for (size_t i = 0; i < m; ++i) {
+            gc_prf_block1(blocks + i * GC_PRF_BLOCK_BYTES, &k[done + i], tweak[done + i]);
+        }
+        gc_prf_blake3_blocks(GC_ROW_PRF_KEY, blocks, m, out + done);
+        done += m;
+    }
+}
+
+static uint8_t gc_aes_xtime(uint8_t a) {
+    return (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1b : 0x00));
+}
+
+void gc_prf_aes_encrypt_soft(const uint8_t in[16], uint8_t out[16]) {
+    uint8_t s[16];
+    for (size_t i = 0; i < 16; ++i) {
+        s[i] = (uint8_t)(in[i] ^ GC_AES_ROUND_KEYS[0][i]);
+    }
+
+    for (size_t r = 1; r <= 10; ++r) {
+        uint8_t t[16];
+
+        // SubBytes + ShiftRows, state is column-major
+        for (size_t i = 0; i < 16; ++i) {
+            t[i] = GC_AES_SBOX[s[(i + 4 * (i % 4)) % 16]];
+        }
+
+        if (r < 10) {
+            for (size_t c = 0; c < 4; ++c) {
+                uint8_t *a = &t[4 * c];
+                uint8_t a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3];
+                uint8_t all = (uint8_t)(a0 ^ a1 ^ a2 ^ a3);
+                a[0] = (uint8_t)(a0 ^ all ^ gc_aes_xtime((uint8_t)(a0 ^ a1)));
+                a[1] = (uint8_t)(a1 ^ all ^ gc_aes_xtime((uint8_t)(a1 ^ a2)));
+                a[2] = (uint8_t)(a2 ^ all ^ gc_aes_xtime((uint8_t)(a2 ^ a3)));
+                a[3] = (uint8_t)(a3 ^ all ^ gc_aes_xtime((uint8_t)(a3 ^ a0)));
+            }
+        }
+
+        for (size_t i = 0; i < 16; ++i) {
+            s[i] = (uint8_t)(t[i] ^ GC_AES_ROUND_KEYS[r][i]);
+        }
+    }
+
+    memcpy(out, s, 16);
+}
+
+#ifdef GC_PRF_HAVE_AESNI
+__attribute__((target("aes,sse2")))
+static void gc_prf_aes_encrypt_ni(const uint8_t in[16], uint8_t out[16]) {
+    __m128i s = _mm_loadu_si128((const __m128i *)in);
+    s = _mm_xor_si128(s, _mm_loadu_si128((const __m128i *)GC_AES_ROUND_KEYS[0]));
+    for (size_t r = 1; r < 10; ++r) {
+        s = _mm_aesenc_si128(s, _mm_loadu_si128((const __m128i *)GC_AES_ROUND_KEYS[r]));
+    }
+    s = _mm_aesenclast_si128(s, _mm_loadu_si128((const __m128i *)GC_AES_ROUND_KEYS[10]));
+    _mm_storeu_si128((__m128i *)out, s);
+}
+
+// up to GC_PRF_LANES independent blocks interleaved round by round, which
+// keeps the AES unit's pipeline full instead of waiting on each block
+__attribute__((target("aes,sse2")))
+static void gc_prf_aes_encrypt_many_ni(const uint8_t *in, size_t n, uint8_t *out) {
+    __m128i s[GC_PRF_LANES];
+    __m128i rk = _mm_loadu_si128((const __m128i *)GC_AES_ROUND_KEYS[0]);
+    for (size_t i = 0; i < n; ++i) {
+        s[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 16 * i)), rk);
+    }
+    for (size_t r = 1; r < 10; ++r) {
+        rk = _mm_loadu_si128((const __m128i *)GC_AES_ROUND_KEYS[r]);
+        for (size_t i = 0; i < n; ++i) {
+            s[i] = _mm_aesenc_si128(s[i], rk);
+        }
+    }
+    rk = _mm_loadu_si128((const __m128i *)GC_AES_ROUND_KEYS[10]);
+    for (size_t i = 0; i < n; ++i) {
+        _mm_storeu_si128((__m128i *)(out + 16 * i), _mm_aesenclast_si128(s[i], rk));
+    }
+}
+#endif
+
+int gc_prf_aes_has_hw(void) {
+#ifdef GC_PRF_HAVE_AESNI
+    return __builtin_cpu_supports("aes") ? 1 : 0;
+#else
+    return 0;
+#endif
+}
+
+void gc_prf_aes_encrypt(const uint8_t in[16], uint8_t out[16]) {
+#ifdef GC_PRF_HAVE_AESNI
+    if (__builtin_cpu_supports("aes")) {
+        gc_prf_aes_encrypt_ni(in, out);
+        return;
+    }
+#endif
+    gc_prf_aes_encrypt_soft(in, out);
+}
+
+// multiplication by x in GF(2^128) mod x^128 + x^7 + x^2 + x + 1,
+// the label is read as a little-endian 128-bit integer
+static void gc_prf_double(uint64_t *lo, uint64_t *hi) {
+    uint64_t carry = *hi >> 63;
+    *hi = (*hi << 1) | (*lo >> 63);
+    *lo = (*lo << 1) ^ (carry * 0x87u);
+}
+
+// out[i] = pi(K_i) ^ K_i for the n <= GC_PRF_LANES keys in k
+static void gc_prf_aes_finish(const uint8_t *k, size_t n, gc_label *out) {
+    uint8_t e[GC_PRF_LANES * 16];
+#ifdef GC_PRF_HAVE_AESNI
+    if (__builtin_cpu_supports("aes")) {
+        gc_prf_aes_encrypt_many_ni(k, n, e);
+    } else
+#endif
+    {
+        for (size_t i = 0; i < n; ++i) {
+            gc_prf_aes_encrypt_soft(k + 16 * i, e + 16 * i);
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < 16; ++j) {
+            out[i].b[j] = (uint8_t)(e[16 * i + j] ^ k[16 * i + j]);
+        }
+    }
+}
+
+static void gc_prf_aes_key2(uint8_t k[16], const gc_label *ka, const gc_label *kb, uint64_t tweak) {
+    uint64_t alo = load_le64(ka->b), ahi = load_le64(ka->b + 8);
+    uint64_t blo = load_le64(kb->b), bhi = load_le64(kb->b + 8);
+
+    gc_prf_double(&alo, &ahi);
+    gc_prf_double(&blo, &bhi);
+    gc_prf_double(&blo, &bhi);
+
+    // the high word separates the two-label and one-label domains
+    store_le64(k, alo ^ blo ^ tweak);
+    store_le64(k + 8, ahi ^ bhi ^ 0x3Cu);
+}
+
+static void gc_prf_aes_key1(uint8_t k[16], const gc_label *kl, uint64_t tweak) {
+    uint64_t lo = load_le64(kl->b), hi = load_le64(kl->b + 8);
+
+    gc_prf_double(&lo, &hi);
+
+    store_le64(k, lo ^ tweak);
+    store_le64(k + 8, hi ^ 0x48u);
+}
+
+void gc_prf_aes_hash2(const gc_label *ka, const gc_label *kb, uint64_t tweak, gc_label *out) {
+    uint8_t k[16];
+    gc_prf_aes_key2(k, ka, kb, tweak);
+    gc_prf_aes_finish(k, 1, out);
+}
+
+void gc_prf_aes_hash1(const gc_label *k, uint64_t tweak, gc_label *out) {
+    uint8_t key[16];
+    gc_prf_aes_key1(key, k, tweak);
+    gc_prf_aes_finish(key, 1, out);
+}
+
+void gc_prf_aes_hash2_many(
+    const gc_label *ka,
+    const gc_label *kb,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+) {
+    uint8_t k[GC_PRF_LANES * 16];
+    for (size_t done = 0; done < n;) {
+        size_t m = (n - done < GC_PRF_LANES) ? n - done : GC_PRF_LANES;
+        for (size_t i = 0; i < m; ++i) {
+            gc_prf_aes_key2(k + 16 * i, &ka[done + i], &kb[done + i], tweak[done + i]);
+        }
+        gc_prf_aes_finish(k, m, out + done);
+        done += m;
+    }
+}
+
+void gc_prf_aes_hash1_many(
+    const gc_label *k,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+) {
+    uint8_t key[GC_PRF_LANES * 16];
+    for (size_t done = 0; done < n;) {
+        size_t m = (n - done < GC_PRF_LANES) ? n - done : GC_PRF_LANES;
+        for (size_t i = 0; i < m; ++i) {
+            gc_prf_aes_key1(key + 16 * i, &k[done + i], tweak[done + i]);
+        }
+        gc_prf_aes_finish(key, m, out + done);
+        done += m;
+    }
+}
+
+void gc_prf_hash2(const gc_label *ka, const gc_label *kb, uint64_t tweak, gc_label *out) {
+#ifdef PSI_GC_PRF_AES
+    gc_prf_aes_hash2(ka, kb, tweak, out);
+#else
+    gc_prf_blake3_hash2(ka, kb, tweak, out);
+#endif
+}
+
+void gc_prf_hash1(const gc_label *k, uint64_t tweak, gc_label *out) {
+#ifdef PSI_GC_PRF_AES
+    gc_prf_aes_hash1(k, tweak, out);
+#else
+    gc_prf_blake3_hash1(k, tweak, out);
+#endif
+}
+
+void gc_prf_hash2_many(
+    const gc_label *ka,
+    const gc_label *kb,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+) {
+#ifdef PSI_GC_PRF_AES
+    gc_prf_aes_hash2_many(ka, kb, tweak, n, out);
+#else
+    gc_prf_blake3_hash2_many(ka, kb, tweak, n, out);
+#endif
+}
+
+void gc_prf_hash1_many(
+    const gc_label *k,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+) {
+#ifdef PSI_GC_PRF_AES
+    gc_prf_aes_hash1_many(k, tweak, n, out);
+#else
+    gc_prf_blake3_hash1_many(k, tweak, n, out);
+#endif
+}
+
+const char *gc_prf_backend_name(void) {
+#ifdef PSI_GC_PRF_AES
+    return gc_prf_aes_has_hw() ? "aes-ni" : "aes-soft";
+#else
+    return "blake3";
+#endif
+}
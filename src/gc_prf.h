@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gc_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// correlation-robust hashes used to encrypt garbled rows and label
+// derivation. gc_prf_hash1/2 dispatch to the backend chosen at configure
+// time (PSI_WITH_AES_GATE_PRF); both backends are always compiled so they
+// can be benchmarked against each other.
+//
+// hash2 is keyed by two labels (classic 4-row tables), hash1 by a single
+// label (half-gates). the tweak must be unique per call site within a
+// garbling, e.g. (gate_index << 2) | row.
+
+void gc_prf_hash2(const gc_label *ka, const gc_label *kb, uint64_t tweak, gc_label *out);
+
+void gc_prf_hash1(const gc_label *k, uint64_t tweak, gc_label *out);
+
+// batched forms: out[i] = hash(k[i], tweak[i]) for i < n, identical to n
+// single calls. inputs are hashed GC_PRF_LANES at a time: BLAKE3 feeds them
+// to blake3_hash_many, which runs as many lanes as the SIMD backend picked
+// at runtime has (16 with AVX-512, 8 with AVX2); AES interleaves the blocks
+// through AES-NI.
+#define GC_PRF_LANES 16
+
+void gc_prf_hash2_many(
+    const gc_label *ka,
+    const gc_label *kb,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+);
+
+void gc_prf_hash1_many(
+    const gc_label *k,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+);
+
+const char *gc_prf_backend_name(void);
+
+// keyed BLAKE3 over label(s) || tweak || domain byte, zero-padded to one
+// 64-byte block
+void gc_prf_blake3_hash2(const gc_label *ka, const gc_label *kb, uint64_t tweak, gc_label *out);
+
+void gc_prf_blake3_hash1(const gc_label *k, uint64_t tweak, gc_label *out);
+
+void gc_prf_blake3_hash2_many(
+    const gc_label *ka,
+    const gc_label *kb,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+);
+
+void gc_prf_blake3_hash1_many(
+    const gc_label *k,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+);
+
+// keyed BLAKE3 of n independent one-block messages (GC_PRF_BLOCK_BYTES
+// each, back to back), truncated to a label each. equals hashing each block
+// with blake3_hasher; also used for label derivation under the garbling key.
+#define GC_PRF_BLOCK_BYTES 64
+
+void gc_prf_blake3_blocks(
+    const uint8_t  key[32],
+    const uint8_t *blocks,
+    size_t         n,
+    gc_label      *out
+);
+
+// fixed-key AES in the MMO-style construction pi(K) ^ K with
+// K = 2*ka ^ 4*kb ^ T (hash2) or K = 2*k ^ T (hash1), doubling in GF(2^128).
+// uses AES-NI when the CPU has it, a portable byte-oriented AES otherwise.
+void gc_prf_aes_hash2(const gc_label *ka, const gc_label *kb, uint64_t tweak, gc_label *out);
+
+void gc_prf_aes_hash1(const gc_label *k, uint64_t tweak, gc_label *out);
+
+void gc_prf_aes_hash2_many(
+    const gc_label *ka,
+    const gc_label *kb,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+);
+
+void gc_prf_aes_hash1_many(
+    const gc_label *k,
+    const uint64_t *tweak,
+    size_t          n,
+    gc_label       *out
+);
+
+int gc_prf_aes_has_hw(void);
+
+// the fixed-key permutation itself, exposed for known-answer tests
+void gc_prf_aes_encrypt(const uint8_t in[16], uint8_t out[16]);
+
+void gc_prf_aes_encrypt_soft(const uint8_t in[16], uint8_t out[16]);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,609 @@
+#include "gc_core.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gc_internal.h"
+
+// wire -> slot assignment driven by liveness. a wire takes a slot when it is
+// defined (or at the start, for inputs) and gives it back after the last
+// gate that reads it, so the label array only ever holds live wires. the
+// assignment is a pure function of the topology, so both ends of a stream
+// arrive at the same slots.
+//
+// nothing here is sized by n_wires past setup: which operands a gate
+// retires is one flag byte per gate (and per input), found in a backward
+// pass with a transient one-bit-per-wire "read later" set, and the live
+// wires' slots sit in an open-addressing table and a free list that grow
+// with the live set only.
+
+#define GC_SLOT_NONE   ((gc_wire_id)GC_WIRE_ID_MAX)
+
+// gc_slot_map.retire flags
+#define GC_RETIRE_IN0  1u   // last reader of in0
+#define GC_RETIRE_IN1  2u   // last reader of in1
+#define GC_RETIRE_OUT  4u   // out is never read nor an output
+
+typedef struct {
+    uint8_t    *retire;         // per gate, then one per input
+    gc_wire_id *wire;           // table keys, GC_SLOT_NONE when empty
+    gc_wire_id *slot;
+    size_t      mask;           // table capacity - 1, a power of two
+    size_t      n_live;
+    gc_wire_id *free_slots;
+    size_t      free_cap;
+    size_t      n_free;
+    size_t      n_slots;
+} gc_slot_map;
+
+static void gc_slot_map_free(gc_slot_map *m) {
+    free(m->retire);
+    free(m->wire);
+    free(m->slot);
+    free(m->free_slots);
+    memset(m, 0, sizeof(*m));
+}
+
+static void gc_slot_map_reset(gc_slot_map *m) {
+    for (size_t i = 0; i <= m->mask; ++i) {
+        m->wire[i] = GC_SLOT_NONE;
+    }
+    m->n_live  = 0;
+    m->n_free  = 0;
+    m->n_slots = 0;
+}
+
+static size_t gc_slot_hash(const gc_slot_map *m, gc_wire_id w) {
+    return (size_t)(((uint64_t)w * 0x9e3779b97f4a7c15ull) >> 32) & m->mask;
+}
+
+// table index holding w, or the empty one where it would go
+static size_t gc_slot_find(const gc_slot_map *m, gc_wire_id w) {
+    size_t i = gc_slot_hash(m, w);
+    while (m->wire[i] != GC_SLOT_NONE && m->wire[i] != w) {
+        i = (i + 1) & m->mask;
+    }
+    return i;
+}
+
+static gc_wire_id gc_slot_get(const gc_slot_map *m, gc_wire_id w) {
+    const size_t i = gc_slot_find(m, w);
+    return m->wire[i] == GC_SLOT_NONE ? GC_SLOT_NONE : m->slot[i];
+}
+
+static int gc_slot_table_alloc(gc_slot_map *m, size_t cap) {
+    m->wire = (gc_wire_id *)malloc(cap * sizeof(gc_wire_id));
+    m->slot = (gc_wire_id *)malloc(cap * sizeof(gc_wire_id));
+    if (!m->wire || !m->slot) {
+        return -2;
+    }
+    m->mask = cap - 1;
+    for (size_t i = 0; i < cap; ++i) {
+        m->wire[i] = GC_SLOT_NONE;
+    }
+    return 0;
+}
+
+// doubles the table, keeping at most half of it full
+static int gc_slot_table_grow(gc_slot_map *m) {
+    gc_slot_map old = *m;
+    if (gc_slot_table_alloc(m, 2 * (old.mask + 1)) != 0) {
+        free(m->wire);
+        free(m->slot);
+        m->wire = old.wire;
+        m->slot = old.slot;
+        m->mask = old.mask;
+        return -2;
+    }
+    for (size_t i = 0; i <= old.mask; ++i) {
+        if (old.wire[i] != GC_SLOT_NONE) {
+            const size_t j = gc_slot_find(m, old.wire[i]);
+            m->wire[j] = old.wire[i];
+            m->slot[j] = old.slot[i];
+        }
+    }
+    free(old.wire);
+    free(old.slot);
+    return 0;
+}
+
+static int gc_slot_map_init(gc_slot_map *m, const gc_circuit *c) {
+    memset(m, 0, sizeof(*m));
+    if (c->n_wires == 0) {
+        return -5;
+    }
+
+    for (size_t gi = 0; gi < c->n_gates; ++gi) {
+        const gc_gate *g = &c->gates[gi];
+        if (g->in0 >= c->n_wires || g->out >= c->n_wires ||
+            (g->type != GC_GATE_NOT && g->in1 >= c->n_wires)) {
+            return -5;
+        }
+    }
+    for (gc_wire_id i = 0; i < c->n_inputs; ++i) {
+        if (c->input_wires[i] >= c->n_wires) {
+            return -5;
+        }
+    }
+    for (gc_wire_id i = 0; i < c->n_outputs; ++i) {
+        if (c->output_wires[i] >= c->n_wires) {
+            return -5;
+        }
+    }
+
+    uint8_t *read_later = (uint8_t *)calloc(((size_t)c->n_wires + 7) / 8, 1);
+    m->retire = (uint8_t *)calloc(c->n_gates + c->n_inputs + 1, 1);
+    if (!read_later || !m->retire || gc_slot_table_alloc(m, 16) != 0) {
+        free(read_later);
+        gc_slot_map_free(m);
+        return -2;
+    }
+
+#define GC_READ_LATER(w) ((read_later[(w) / 8] >> ((w) % 8)) & 1u)
+#define GC_SET_READ(w)   (read_later[(w) / 8] |= (uint8_t)(1u << ((w) % 8)))
+    // outputs are pinned: never retired
+    for (gc_wire_id i = 0; i < c->n_outputs; ++i) {
+        GC_SET_READ(c->output_wires[i]);
+    }
+    // walking backwards, the first read of a wire seen is its last one
+    for (size_t gi = c->n_gates; gi-- > 0;) {
+        const gc_gate *g = &c->gates[gi];
+        if (g->type != GC_GATE_NOT) {
+            if (!GC_READ_LATER(g->in1)) {
+                m->retire[gi] |= GC_RETIRE_IN1;
+                GC_SET_READ(g->in1);
+            }
+        }
+        if (!GC_READ_LATER(g->in0)) {
+            m->retire[gi] |= GC_RETIRE_IN0;
+            GC_SET_READ(g->in0);
+        }
+    }
+    // with every read marked, what is left was never read
+    for (size_t gi = 0; gi < c->n_gates; ++gi) {
+        if (!GC_READ_LATER(c->gates[gi].out)) {
+            m->retire[gi] |= GC_RETIRE_OUT;
+        }
+    }
+    for (gc_wire_id i = 0; i < c->n_inputs; ++i) {
+        if (!GC_READ_LATER(c->input_wires[i])) {
+            m->retire[c->n_gates + i] = GC_RETIRE_OUT;
+        }
+    }
+#undef GC_READ_LATER
+#undef GC_SET_READ
+
+    free(read_later);
+    return 0;
+}
+
+// a redefined wire keeps its slot. GC_SLOT_NONE if the table or free list
+// cannot grow; only the dry run grows them, the real pass reuses its sizes.
+static gc_wire_id gc_slot_acquire(gc_slot_map *m, gc_wire_id w) {
+    size_t i = gc_slot_find(m, w);
+    if (m->wire[i] != GC_SLOT_NONE) {
+        return m->slot[i];
+    }
+    if (2 * (m->n_live + 1) > m->mask + 1) {
+        if (gc_slot_table_grow(m) != 0) {
+            return GC_SLOT_NONE;
+        }
+        i = gc_slot_find(m, w);
+    }
+    gc_wire_id s;
+    if (m->n_free > 0) {
+        s = m->free_slots[--m->n_free];
+    } else {
+        s = (gc_wire_id)m->n_slots++;
+    }
+    m->wire[i] = w;
+    m->slot[i] = s;
+    ++m->n_live;
+    return s;
+}
+
+// backward-shift deletion keeps every probe chain unbroken
+static int gc_slot_release(gc_slot_map *m, gc_wire_id w) {
+    size_t i = gc_slot_find(m, w);
+    if (m->wire[i] == GC_SLOT_NONE) {
+        return 0;
+    }
+    if (m->n_free == m->free_cap) {
+        const size_t cap = m->free_cap ? 2 * m->free_cap : 16;
+        gc_wire_id *grown = (gc_wire_id *)realloc(m->free_slots, cap * sizeof(gc_wire_id));
+        if (!grown) {
+            return -2;
+        }
+        m->free_slots = grown;
+        m->free_cap = cap;
+    }
+    m->free_slots[m->n_free++] = m->slot[i];
+    --m->n_live;
+
+    for (size_t j = (i + 1) & m->mask; m->wire[j] != GC_SLOT_NONE; j = (j + 1) & m->mask) {
+        const size_t home = gc_slot_hash(m, m->wire[j]);
+        // j's entry may fill the hole at i unless its home lies in (i, j]
+        const int stays = (i <= j) ? (home > i && home <= j) : (home > i || home <= j);
+        if (!stays) {
+            m->wire[i] = m->wire[j];
+            m->slot[i] = m->slot[j];
+            i = j;
+        }
+    }
+    m->wire[i] = GC_SLOT_NONE;
+    return 0;
+}
+
+// retires the operands whose last reader was gate gi, and the output if
+// nothing ever reads it
+static int gc_slot_after_gate(gc_slot_map *m, size_t gi, const gc_gate *g) {
+    const unsigned f = m->retire[gi];
+    int rc = 0;
+    if (f & GC_RETIRE_IN0) {
+        rc |= gc_slot_release(m, g->in0);
+    }
+    if (f & GC_RETIRE_IN1) {
+        rc |= gc_slot_release(m, g->in1);
+    }
+    if (f & GC_RETIRE_OUT) {
+        rc |= gc_slot_release(m, g->out);
+    }
+    return rc;
+}
+
+static int gc_slot_after_inputs(gc_slot_map *m, const gc_circuit *c) {
+    int rc = 0;
+    for (gc_wire_id i = 0; i < c->n_inputs; ++i) {
+        if (m->retire[c->n_gates + i]) {
+            rc |= gc_slot_release(m, c->input_wires[i]);
+        }
+    }
+    return rc;
+}
+
+// integer-only dry run of the assignment, sizes the label array, slot table
+// and free list up front so they never have to be grown (and leave stale
+// label copies behind) in the real pass
+static int gc_slot_map_plan(gc_slot_map *m, const gc_circuit *c, size_t *peak) {
+    for (gc_wire_id i = 0; i < c->n_inputs; ++i) {
+        if (gc_slot_acquire(m, c->input_wires[i]) == GC_SLOT_NONE) {
+            return -2;
+        }
+    }
+    if (gc_slot_after_inputs(m, c) != 0) {
+        return -2;
+    }
+
+    for (size_t gi = 0; gi < c->n_gates; ++gi) {
+        const gc_gate *g = &c->gates[gi];
+        if (gc_slot_get(m, g->in0) == GC_SLOT_NONE ||
+            (g->type != GC_GATE_NOT && gc_slot_get(m, g->in1) == GC_SLOT_NONE)) {
+            return -6;
+        }
+        if (gc_slot_acquire(m, g->out) == GC_SLOT_NONE || gc_slot_after_gate(m, gi, g) != 0) {
+            return -2;
+        }
+    }
+
+    *peak = m->n_slots ? m->n_slots : 1;
+    gc_slot_map_reset(m);
+    return 0;
+}
+
+// shared prologue of both ends: chunk rounding, topology checks, slot plan
+// and the two buffers. on failure everything is released.
+static int gc_stream_begin(
+    const gc_circuit *plain,
+    size_t            per_gate,
+    size_t           *chunk_labels,
+    gc_slot_map      *m,
+    size_t           *n_live,
+    gc_label        **labels,
+    gc_label        **chunk
+) {
+    if (*chunk_labels == 0) {
+        *chunk_labels = GC_STREAM_DEFAULT_CHUNK;
+    }
+    *chunk_labels -= *chunk_labels % per_gate;
+    if (*chunk_labels == 0) {
+        *chunk_labels = per_gate;
+    }
+
+    int rc = gc_slot_map_init(m, plain);
+    if (rc != 0) {
+        return rc;
+    }
+    rc = gc_slot_map_plan(m, plain, n_live);
+    if (rc != 0) {
+        gc_slot_map_free(m);
+        return rc;
+    }
+
+    *labels = (gc_label *)malloc(*n_live * sizeof(gc_label));
+    *chunk  = (gc_label *)malloc(*chunk_labels * sizeof(gc_label));
+    if (!*labels || !*chunk) {
+        free(*labels);
+        free(*chunk);
+        gc_slot_map_free(m);
+        return -2;
+    }
+    return 0;
+}
+
+int gc_garble_stream(
+    const gc_circuit *plain,
+    gc_garble_mode    mode,
+    const uint8_t    *seed,
+    size_t            chunk_labels,
+    gc_table_sink     sink,
+    void             *user,
+    gc_label         *input_labels0,
+    gc_label         *output_labels0,
+    gc_label         *delta_out,
+    gc_stream_stats  *stats
+) {
+    if (!plain || !sink || !input_labels0 || !output_labels0 || !delta_out) {
+        return -1;
+    }
+    if (mode != GC_GARBLE_CLASSIC && mode != GC_GARBLE_HALF_GATES) {
+        return -1;
+    }
+
+    const size_t per_gate = gc_table_size(mode);
+    gc_slot_map m;
+    size_t n_live = 0;
+    gc_label *labels = NULL;
+    gc_label *chunk = NULL;
+    int rc = gc_stream_begin(plain, per_gate, &chunk_labels, &m, &n_live, &labels, &chunk);
+    if (rc != 0) {
+        return rc;
+    }
+
+    gc_garble_keys keys;
+    if (gc_garble_keys_init(&keys, seed) != 0) {
+        rc = -8;
+        goto cleanup;
+    }
+    const gc_label *delta = &keys.delta;
+    size_t n_buffered = 0;
+    size_t n_ct = 0;
+    size_t n_chunks = 0;
+
+    for (gc_wire_id i = 0; i < plain->n_inputs; ++i) {
+        gc_wire_id w = plain->input_wires[i];
+        gc_derive_label0(&keys, w, &labels[gc_slot_acquire(&m, w)]);
+        input_labels0[i] = labels[gc_slot_get(&m, w)];
+    }
+    gc_slot_after_inputs(&m, plain);
+    *delta_out = *delta;
+
+    for (size_t gi = 0; gi < plain->n_gates; ++gi) {
+        const gc_gate *g = &plain->gates[gi];
+        const gc_label *a = &labels[gc_slot_get(&m, g->in0)];
+        const gc_label *b = (g->type != GC_GATE_NOT) ? &labels[gc_slot_get(&m, g->in1)] : NULL;
+        gc_label *c = &labels[gc_slot_acquire(&m, g->out)];
+
+        switch (g->type) {
+        case GC_GATE_XOR:
+            gc_label_xor(a, b, c);
+            break;
+        case GC_GATE_NOT:
+            gc_label_xor(a, delta, c);
+            break;
+        case GC_GATE_AND:
+            if (mode == GC_GARBLE_HALF_GATES) {
+                gc_garble_and_half(delta, gi, a, b, &chunk[n_buffered], c);
+            } else {
+                // c may share a slot with a redefined operand, so derive the
+                // output label only once the table inputs are read
+                gc_label Wc0;
+                gc_derive_label0(&keys, g->out, &Wc0);
+                gc_garble_and_classic(delta, gi, a, b, &Wc0, &chunk[n_buffered]);
+                *c = Wc0;
+            }
+            n_buffered += per_gate;
+            n_ct += per_gate;
+            if (n_buffered == chunk_labels) {
+                if (sink(user, chunk, n_buffered) != 0) {
+                    rc = -7;
+                    goto cleanup;
+                }
+                n_buffered = 0;
+                ++n_chunks;
+            }
+            break;
+        default:
+            rc = -4;
+            goto cleanup;
+        }
+
+        gc_slot_after_gate(&m, gi, g);
+    }
+
+    if (n_buffered > 0) {
+        if (sink(user, chunk, n_buffered) != 0) {
+            rc = -7;
+            goto cleanup;
+        }
+        ++n_chunks;
+    }
+
+    for (gc_wire_id i = 0; i < plain->n_outputs; ++i) {
+        output_labels0[i] = labels[gc_slot_get(&m, plain->output_wires[i])];
+    }
+
+    if (stats) {
+        stats->peak_live_labels = n_live;
+        stats->chunk_labels     = chunk_labels;
+        stats->n_chunks         = n_chunks;
+        stats->num_ciphertexts  = n_ct;
+    }
+    rc = 0;
+
+cleanup:
+    gc_garble_keys_wipe(&keys);
+    gc_secure_memzero(labels, n_live * sizeof(gc_label));
+    free(labels);
+    free(chunk);
+    gc_slot_map_free(&m);
+    return rc;
+}
+
+int gc_eval_stream(
+    const gc_circuit *plain,
+    gc_garble_mode    mode,
+    size_t            chunk_labels,
+    gc_table_source   source,
+    void             *user,
+    const gc_label   *input_labels,
+    gc_label         *output_labels,
+    gc_stream_stats  *stats
+) {
+    if (!plain || !source || !input_labels || !output_labels) {
+        return -1;
+    }
+    if (mode != GC_GARBLE_CLASSIC && mode != GC_GARBLE_HALF_GATES) {
+        return -1;
+    }
+
+    const size_t per_gate = gc_table_size(mode);
+    gc_slot_map m;
+    size_t n_live = 0;
+    gc_label *labels = NULL;
+    gc_label *chunk = NULL;
+    int rc = gc_stream_begin(plain, per_gate, &chunk_labels, &m, &n_live, &labels, &chunk);
+    if (rc != 0) {
+        return rc;
+    }
+
+    size_t n_remaining = 0;
+    for (size_t gi = 0; gi < plain->n_gates; ++gi) {
+        if (plain->gates[gi].type == GC_GATE_AND) {
+            n_remaining += per_gate;
+        }
+    }
+    const size_t n_ct = n_remaining;
+
+    size_t pos = 0;
+    size_t n_avail = 0;
+    size_t n_chunks = 0;
+
+    for (gc_wire_id i = 0; i < plain->n_inputs; ++i) {
+        labels[gc_slot_acquire(&m, plain->input_wires[i])] = input_labels[i];
+    }
+    gc_slot_after_inputs(&m, plain);
+
+    for (size_t gi = 0; gi < plain->n_gates; ++gi) {
+        const gc_gate *g = &plain->gates[gi];
+        const gc_label *a = &labels[gc_slot_get(&m, g->in0)];
+        const gc_label *b = (g->type != GC_GATE_NOT) ? &labels[gc_slot_get(&m, g->in1)] : NULL;
+        gc_label *c = &labels[gc_slot_acquire(&m, g->out)];
+
+        switch (g->type) {
+        case GC_GATE_XOR:
+            gc_label_xor(a, b, c);
+            break;
+        case GC_GATE_NOT:
+            *c = *a;
+            break;
+        case GC_GATE_AND:
+            if (pos == n_avail) {
+                n_avail = (n_remaining < chunk_labels) ? n_remaining : chunk_labels;
+                if (source(user, chunk, n_avail) != 0) {
+                    rc = -7;
+                    goto cleanup;
+                }
+                n_remaining -= n_avail;
+                pos = 0;
+                ++n_chunks;
+            }
+            gc_eval_and_gate(mode, gi, a, b, &chunk[pos], c);
+            pos += per_gate;
+            break;
+        default:
+            rc = -4;
+            goto cleanup;
+        }
+
+        gc_slot_after_gate(&m, gi, g);
+    }
+
+    for (gc_wire_id i = 0; i < plain->n_outputs; ++i) {
+        output_labels[i] = labels[gc_slot_get(&m, plain->output_wires[i])];
+    }
+
+    if (stats) {
+        stats->peak_live_labels = n_live;
+        stats->chunk_labels     = chunk_labels;
+        stats->n_chunks         = n_chunks;
+        stats->num_ciphertexts  = n_ct;
+    }
+    rc = 0;
+
+cleanup:
+    gc_secure_memzero(labels, n_live * sizeof(gc_label));
+    free(labels);
+    free(chunk);
+    gc_slot_map_free(&m);
+    return rc;
+}
+
+int gc_stream_decode_outputs(
+    gc_wire_id      n_outputs,
+    const gc_label *output_labels,
+    const gc_label *output_labels0,
+    const gc_label *delta,
+    uint8_t        *outputs_bits
+) {
+    if (!output_labels || !output_labels0 || !delta || !outputs_bits) {
+        return -1;
+    }
+
+    for (gc_wire_id i = 0; i < n_outputs; ++i) {
+        uint8_t diff0 = 0, diff1 = 0;
+        for (size_t j = 0; j < GC_LABEL_BYTES; ++j) {
+            uint8_t x = (uint8_t)(output_labels[i].b[j] ^ output_labels0[i].b[j]);
+            diff0 |= x;
+            diff1 |= (uint8_t)(x ^ delta->b[j]);
+        }
+        if (diff0 == 0) {
+            outputs_bits[i] = 0;
+        } else if (diff1 == 0) {
+            outputs_bits[i] = 1;
+        } else {
+            return -2;
+        }
+    }
+    return 0;
+}
+
+int gc_stream_decode_info(
+    gc_wire_id      n_outputs,
+    const gc_label *output_labels0,
+    uint8_t        *decode_bits
+) {
+    if (!output_labels0 || !decode_bits) {
+        return -1;
+    }
+
+    for (gc_wire_id i = 0; i < n_outputs; ++i) {
+        decode_bits[i] = gc_permute_bit(&output_labels0[i]);
+    }
+    return 0;
+}
+
+int gc_stream_decode_bits(
+    gc_wire_id      n_outputs,
+    const gc_label *output_labels,
+    const uint8_t  *decode_bits,
+    uint8_t        *outputs_bits
+) {
+    if (!output_labels || !decode_bits || !outputs_bits) {
+        return -1;
+    }
+
+    for (gc_wire_id i = 0; i < n_outputs; ++i) {
+        outputs_bits[i] = (uint8_t)(gc_permute_bit(&output_labels[i]) ^ (decode_bits[i] & 1u));
+    }
+    return 0;
+}
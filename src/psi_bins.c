@@ -0,0 +1,181 @@
+#include "psi_bins.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "blake3.h"
+
+// 1.27 bins per element of A keeps three-way cuckoo hashing below its load
+// threshold with room to spare
+#define PSI_BINS_PER_ELEM_NUM 127
+#define PSI_BINS_PER_ELEM_DEN 100
+
+// evictions before the element being carried goes to the stash
+#define PSI_BINS_MAX_KICKS 512
+
+static const uint8_t PSI_BINS_KEY[BLAKE3_KEY_LEN] = {
+    'p', 's', 'i', '-', 'c', 'u', 'c', 'k', 'o', 'o', '-', 'b', 'i', 'n', 's', '-',
+    'k', 'e', 'y', 'e', 'd', '-', 'b', 'y', '-', 'b', 'l', 'a', 'k', 'e', '3', 0
+};
+
+// the element's PSI_BINS_HASHES bins. a bin may repeat; callers that care
+// skip the repeats.
+static void psi_bins_hash(const uint8_t *e, size_t elem_bytes, size_t n_bins,
+                          uint32_t out[PSI_BINS_HASHES]) {
+    uint8_t digest[8 * PSI_BINS_HASHES];
+    blake3_hasher hasher;
+    blake3_hasher_init_keyed(&hasher, PSI_BINS_KEY);
+    blake3_hasher_update(&hasher, e, elem_bytes);
+    blake3_hasher_finalize(&hasher, digest, sizeof(digest));
+
+    for (int i = 0; i < PSI_BINS_HASHES; ++i) {
+        uint64_t w;
+        memcpy(&w, digest + 8 * i, 8);
+        // top 32 bits scaled into [0, n_bins), n_bins < 2^32
+        out[i] = (uint32_t)(((w >> 32) * (uint64_t)n_bins) >> 32);
+    }
+}
+
+// random-walk insertion: take a free bin if the carried element has one,
+// otherwise evict the occupant of one of its bins and carry that instead
+static void psi_bins_cuckoo(psi_bins *bins, const uint32_t *hashes_a, size_t count_a) {
+    uint64_t rng = 0x853c49e6748fea9bull;
+
+    for (size_t i = 0; i < count_a; ++i) {
+        uint32_t carry = (uint32_t)i;
+        size_t kicks = 0;
+        for (;;) {
+            const uint32_t *h = hashes_a + (size_t)carry * PSI_BINS_HASHES;
+            int placed = 0;
+            for (int j = 0; j < PSI_BINS_HASHES; ++j) {
+                if (bins->bin_a[h[j]] == PSI_BINS_EMPTY) {
+                    bins->bin_a[h[j]] = carry;
+                    placed = 1;
+                    break;
+                }
+            }
+            if (placed) {
+                break;
+            }
+            if (kicks++ == PSI_BINS_MAX_KICKS) {
+                bins->stash[bins->n_stash++] = carry;
+                break;
+            }
+
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            uint32_t bin = h[rng % PSI_BINS_HASHES];
+            uint32_t evicted = bins->bin_a[bin];
+            bins->bin_a[bin] = carry;
+            carry = evicted;
+        }
+    }
+}
+
+// the distinct bins among h, in place; returns how many
+static int psi_bins_distinct(uint32_t h[PSI_BINS_HASHES]) {
+    int n = 0;
+    for (int j = 0; j < PSI_BINS_HASHES; ++j) {
+        int seen = 0;
+        for (int i = 0; i < n; ++i) {
+            seen |= h[i] == h[j];
+        }
+        if (!seen) {
+            h[n++] = h[j];
+        }
+    }
+    return n;
+}
+
+int psi_bins_build(
+    psi_bins      *bins,
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes
+) {
+    if (!bins) {
+        return -1;
+    }
+    memset(bins, 0, sizeof(*bins));
+    if ((!a && count_a) || (!b && count_b) || elem_bytes == 0) {
+        return -1;
+    }
+    if (count_a >= UINT32_MAX / 2 || count_b >= UINT32_MAX) {
+        return -2;
+    }
+
+    size_t n_bins = (count_a * PSI_BINS_PER_ELEM_NUM + PSI_BINS_PER_ELEM_DEN - 1) /
+                    PSI_BINS_PER_ELEM_DEN;
+    if (n_bins == 0) {
+        n_bins = 1;
+    }
+    bins->n_bins  = n_bins;
+    bins->bin_a   = (uint32_t *)malloc(n_bins * sizeof(uint32_t));
+    bins->stash   = (uint32_t *)malloc((count_a ? count_a : 1) * sizeof(uint32_t));
+    bins->start_b = (size_t *)calloc(n_bins + 1, sizeof(size_t));
+    uint32_t *hashes = (uint32_t *)malloc(((count_a > count_b ? count_a : count_b) + 1) *
+                                          PSI_BINS_HASHES * sizeof(uint32_t));
+    if (!bins->bin_a || !bins->stash || !bins->start_b || !hashes) {
+        free(hashes);
+        psi_bins_free(bins);
+        return -3;
+    }
+
+    for (size_t i = 0; i < n_bins; ++i) {
+        bins->bin_a[i] = PSI_BINS_EMPTY;
+    }
+    for (size_t i = 0; i < count_a; ++i) {
+        psi_bins_hash(a + i * elem_bytes, elem_bytes, n_bins, hashes + i * PSI_BINS_HASHES);
+    }
+    psi_bins_cuckoo(bins, hashes, count_a);
+
+    // B: count per bin into start_b[i + 1], prefix sums, then fill
+    size_t total = 0;
+    for (size_t j = 0; j < count_b; ++j) {
+        uint32_t *h = hashes + j * PSI_BINS_HASHES;
+        psi_bins_hash(b + j * elem_bytes, elem_bytes, n_bins, h);
+        int n = psi_bins_distinct(h);
+        // marks the unused slots so the fill pass knows n
+        for (int i = n; i < PSI_BINS_HASHES; ++i) {
+            h[i] = PSI_BINS_EMPTY;
+        }
+        for (int i = 0; i < n; ++i) {
+            ++bins->start_b[h[i] + 1];
+        }
+        total += (size_t)n;
+    }
+    for (size_t i = 1; i <= n_bins; ++i) {
+        bins->start_b[i] += bins->start_b[i - 1];
+    }
+
+    bins->items_b = (uint32_t *)malloc((total ? total : 1) * sizeof(uint32_t));
+    if (!bins->items_b) {
+        free(hashes);
+        psi_bins_free(bins);
+        return -3;
+    }
+    // fill using start_b[i] as bin i's cursor, then shift back
+    for (size_t j = 0; j < count_b; ++j) {
+        const uint32_t *h = hashes + j * PSI_BINS_HASHES;
+        for (int i = 0; i < PSI_BINS_HASHES && h[i] != PSI_BINS_EMPTY; ++i) {
+            bins->items_b[bins->start_b[h[i]]++] = (uint32_t)j;
+        }
+    }
+    memmove(bins->start_b + 1, bins->start_b, n_bins * sizeof(size_t));
+    bins->start_b[0] = 0;
+
+    free(hashes);
+    return 0;
+}
+
+void psi_bins_free(psi_bins *bins) {
+    if (!bins) return;
+    free(bins->bin_a);
+    free(bins->stash);
+    free(bins->start_b);
+    free(bins->items_b);
+    memset(bins, 0, sizeof(*bins));
+}
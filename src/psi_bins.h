@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// hashing-to-bins for circuit PSI: A is cuckoo-hashed, at most one element
+// per bin, and B is simple-hashed into every bin any of its hash functions
+// picks, so an element of A that occurs in B meets it in A's bin. only
+// same-bin pairs then need comparing, plus the stash (elements of A the
+// cuckoo table could not place) against all of B.
+//
+// bins come from keyed BLAKE3 of the element bytes, one per hash function.
+
+#define PSI_BINS_HASHES 3
+#define PSI_BINS_EMPTY  UINT32_MAX
+
+typedef struct {
+    size_t    n_bins;
+    uint32_t *bin_a;    // n_bins entries: index into A, or PSI_BINS_EMPTY
+    uint32_t *stash;    // indices into A left over by the cuckoo table
+    size_t    n_stash;
+    size_t   *start_b;  // n_bins + 1 entries: bin i holds items_b[start_b[i], start_b[i + 1])
+    uint32_t *items_b;  // indices into B, bin by bin
+} psi_bins;
+
+// returns 0, -1 on bad arguments, -2 if a count does not fit the 32-bit
+// indices, -3 on allocation failure. psi_bins_free is safe after a failure.
+int psi_bins_build(
+    psi_bins      *bins,
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes
+);
+
+void psi_bins_free(psi_bins *bins);
+
+#ifdef __cplusplus
+}
+#endif
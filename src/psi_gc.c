@@ -1,239 +1,630 @@
 #include "psi_gc.h"
 #include "gc_core.h"
+#include "gc_pool.h"
+#include "psi_bins.h"
+#include "psi_join.h"
 
 #include <stdlib.h>
 #include <string.h>
 
+// the comparison circuit is a membership test of one element of A against
+// m elements of B (m = 1 in pairwise mode, the bin width in cuckoo mode),
+// on the low k bits of each element (all elem_bits unless sigma is set).
+// it is built for the m and k a call's counts need and kept while later
+// calls need no more; a call needing fewer bits feeds zeros to the rest.
 struct psi_gc_ctx {
-    size_t max_elems;
-    size_t elem_bits;
+    size_t      max_elems;
+    size_t      elem_bits;
+    psi_gc_mode mode;
+    size_t      block_elems;
+    size_t      sigma;              // 0: compare every bit
+
+    size_t              m;          // 0 until a circuit is built
+    size_t              k;
+    gc_circuit         *plain;      // NULL with m set: too wide, compare in the clear
+    gc_garbled_circuit *gc;         // reused garbling when pool_cap == 0
+
+    gc_garbled_circuit **pool;      // fresh garblings, one per compute call
+    size_t               pool_cap;
+    size_t               pool_len;
+
+    gc_evaluator *ev;
+    gc_label     *labels_a;         // count_a * k of the largest call so far
+    size_t        labels_a_cap;
+    gc_label     *labels_block;     // m * k
+    uint8_t      *hits;             // max_elems bits, bit i of hits[i / 8]
+
+    gc_pool *workers;               // NULL: single-threaded joins
 };
 
-static int psi_gc_compute_with_gc_y(
-    psi_gc_ctx    *ctx,
-    const uint8_t *inputs_a,
-    const uint8_t *inputs_b,
-    size_t         count,
-    uint8_t       *out_mask
-);
+// blocks of at most block_elems, balanced so the last one is never much
+// shorter than the others. bins are cut into blocks of exactly block_elems
+// whatever the count, so cuckoo mode keeps one circuit.
+static size_t psi_block_size(const psi_gc_ctx *ctx, size_t count) {
+    if (ctx->mode == PSI_GC_MODE_PAIRWISE) {
+        return 1;
+    }
+    if (ctx->mode == PSI_GC_MODE_CUCKOO) {
+        return ctx->block_elems;
+    }
+    size_t n_blocks = (count + ctx->block_elems - 1) / ctx->block_elems;
+    return (count + n_blocks - 1) / n_blocks;
+}
 
-static void psi_compute_naive(
-    const uint8_t *inputs_a,
-    const uint8_t *inputs_b,
-    size_t         count,
-    size_t         elem_bytes,
-    uint8_t       *out_mask
-);
+static void psi_gc_drop_pool(psi_gc_ctx *ctx) {
+    for (size_t i = 0; i < ctx->pool_len; ++i) {
+        gc_garbled_free(ctx->pool[i]);
+    }
+    ctx->pool_len = 0;
+}
+
+static void psi_gc_drop_circuit(psi_gc_ctx *ctx) {
+    psi_gc_drop_pool(ctx);
+    gc_garbled_free(ctx->gc);
+    gc_circuit_free(ctx->plain);
+    free(ctx->labels_block);
+    ctx->gc = NULL;
+    ctx->plain = NULL;
+    ctx->labels_block = NULL;
+    ctx->m = 0;
+    ctx->k = 0;
+}
+
+// bits of each element the circuit compares for these counts
+static size_t psi_gc_width(const psi_gc_ctx *ctx, size_t count_a, size_t count_b) {
+    if (ctx->sigma == 0) {
+        return ctx->elem_bits;
+    }
+    size_t k = psi_gc_digest_bits(count_a, count_b, ctx->sigma);
+    return (k < ctx->elem_bits) ? k : ctx->elem_bits;
+}
+
+// builds the circuit for blocks of m compared on k bits, and the scratch
+// sized for it. a built circuit with wider blocks or more bits serves
+// too: short blocks are padded anyway, surplus bits are zero on both
+// sides, and keeping it keeps the pre-garbled pool.
+static int psi_gc_build(psi_gc_ctx *ctx, size_t m, size_t k) {
+    if (ctx->m == m && ctx->k == k) {
+        return 0;
+    }
+    if (ctx->plain && k <= ctx->k && m <= ctx->m) {
+        return 0;
+    }
+    psi_gc_drop_circuit(ctx);
+
+    if (!ctx->ev) {
+        ctx->ev = gc_evaluator_create(0);
+        if (!ctx->ev) {
+            return -3;
+        }
+    }
+
+    ctx->m = m;
+    ctx->k = k;
+    // B may repeat elements, so the OR tree cannot assume distinct
+    if (k <= GC_WIRE_ID_MAX / (m + 1)) {
+        ctx->plain = gc_circuit_member((gc_wire_id)k, (gc_wire_id)m, 0);
+    }
+    if (!ctx->plain) {
+        return 0;
+    }
+
+    ctx->labels_block = (gc_label *)malloc(m * k * sizeof(gc_label));
+    if (!ctx->labels_block) {
+        psi_gc_drop_circuit(ctx);
+        return -3;
+    }
+    return 0;
+}
 
 psi_gc_ctx *psi_gc_create(size_t max_elems, size_t elem_bits) {
     if (max_elems == 0 || elem_bits == 0) {
         return NULL;
     }
 
-    psi_gc_ctx *ctx = (psi_gc_ctx *)malloc(sizeof(psi_gc_ctx));
+    psi_gc_ctx *ctx = (psi_gc_ctx *)calloc(1, sizeof(psi_gc_ctx));
     if (!ctx) {
         return NULL;
     }
 
-    ctx->max_elems = max_elems;
-    ctx->elem_bits = elem_bits;
+    ctx->max_elems   = max_elems;
+    ctx->elem_bits   = elem_bits;
+    ctx->mode        = PSI_GC_MODE_CUCKOO;
+    ctx->block_elems = PSI_GC_DEFAULT_BIN;
+    ctx->hits        = (uint8_t *)malloc((max_elems + 7) / 8);
+    if (!ctx->hits) {
+        free(ctx);
+        return NULL;
+    }
     return ctx;
 }
 
-void psi_gc_destroy(psi_gc_ctx *ctx) {
+int psi_gc_set_mode(psi_gc_ctx *ctx, psi_gc_mode mode, size_t block_elems) {
     if (!ctx) {
-        return;
+        return -1;
     }
-    free(ctx);
+    if (mode != PSI_GC_MODE_BLOCK && mode != PSI_GC_MODE_PAIRWISE &&
+        mode != PSI_GC_MODE_CUCKOO) {
+        return -2;
+    }
+
+    if (block_elems == 0) {
+        block_elems = (mode == PSI_GC_MODE_CUCKOO) ? PSI_GC_DEFAULT_BIN : PSI_GC_DEFAULT_BLOCK;
+    }
+    ctx->mode        = mode;
+    ctx->block_elems = block_elems;
+    psi_gc_drop_circuit(ctx);
+    return 0;
 }
 
-int psi_gc_prepare_circuit(psi_gc_ctx *ctx) {
+static size_t psi_ceil_log2(size_t n) {
+    size_t bits = 0;
+    while (bits < sizeof(size_t) * 8 && ((size_t)1 << bits) < n) {
+        ++bits;
+    }
+    return bits;
+}
+
+size_t psi_gc_digest_bits(size_t count_a, size_t count_b, size_t sigma) {
+    return sigma + psi_ceil_log2(count_a) + psi_ceil_log2(count_b);
+}
+
+int psi_gc_set_sigma(psi_gc_ctx *ctx, size_t sigma) {
     if (!ctx) {
         return -1;
     }
 
+    ctx->sigma = sigma;
+    psi_gc_drop_circuit(ctx);
     return 0;
 }
 
-int psi_gc_compute(
-    psi_gc_ctx    *ctx,
-    const uint8_t *inputs_a,
-    const uint8_t *inputs_b,
-    size_t         count,
-    uint8_t       *out_mask
-) {
-    if (!ctx || !inputs_a || !inputs_b || !out_mask) {
+int psi_gc_set_threads(psi_gc_ctx *ctx, size_t n_threads) {
+    if (!ctx) {
         return -1;
     }
 
-    if (count == 0) {
-        return 0;
+    gc_pool_destroy(ctx->workers);
+    ctx->workers = NULL;
+    if (n_threads != 1) {
+        ctx->workers = gc_pool_create(n_threads);
+        if (!ctx->workers) {
+            return -3;
+        }
     }
+    return 0;
+}
 
-    if (count > ctx->max_elems) {
-        return -2;
+int psi_gc_set_pregarbled(psi_gc_ctx *ctx, size_t n) {
+    if (!ctx) {
+        return -1;
     }
 
-    return psi_gc_compute_with_gc_y(ctx, inputs_a, inputs_b, count, out_mask);
+    psi_gc_drop_pool(ctx);
+    gc_garbled_circuit **pool = NULL;
+    if (n > 0) {
+        pool = (gc_garbled_circuit **)realloc(ctx->pool, n * sizeof(*pool));
+        if (!pool) {
+            return -3;
+        }
+    } else {
+        free(ctx->pool);
+    }
+    ctx->pool     = pool;
+    ctx->pool_cap = n;
+    gc_garbled_free(ctx->gc);
+    ctx->gc = NULL;
+    return 0;
 }
 
-int psi_hash_only_compute(
-    psi_gc_ctx    *ctx,
-    const uint8_t *inputs_a,
-    const uint8_t *inputs_b,
-    size_t         count,
-    uint8_t       *out_mask
-) {
-    if (!ctx || !inputs_a || !inputs_b || !out_mask) {
+int psi_gc_pregarble(psi_gc_ctx *ctx) {
+    if (!ctx) {
         return -1;
     }
-    if (count == 0) {
+    if (ctx->m == 0) {
+        return -2;
+    }
+    if (!ctx->plain) {
         return 0;
     }
-    if (count > ctx->max_elems) {
-        return -2;
+
+    if (ctx->pool_cap == 0) {
+        if (!ctx->gc && gc_garble(ctx->plain, &ctx->gc) != 0) {
+            return -4;
+        }
+        return 1;
+    }
+    while (ctx->pool_len < ctx->pool_cap) {
+        gc_garbled_circuit *gc = NULL;
+        if (gc_garble(ctx->plain, &gc) != 0) {
+            return -4;
+        }
+        ctx->pool[ctx->pool_len++] = gc;
     }
+    return (int)ctx->pool_len;
+}
 
-    const size_t elem_bits  = ctx->elem_bits;
-    const size_t elem_bytes = (elem_bits + 7u) / 8u;
+size_t psi_gc_pregarbled_ready(const psi_gc_ctx *ctx) {
+    return ctx ? ctx->pool_len : 0;
+}
 
-    psi_compute_naive(inputs_a, inputs_b, count, elem_bytes, out_mask);
-    return 0;
+void psi_gc_destroy(psi_gc_ctx *ctx) {
+    if (!ctx) {
+        return;
+    }
+    psi_gc_drop_circuit(ctx);
+    free(ctx->pool);
+    gc_evaluator_destroy(ctx->ev);
+    free(ctx->labels_a);
+    free(ctx->hits);
+    gc_pool_destroy(ctx->workers);
+    free(ctx);
 }
 
-static gc_circuit *build_eq_circuit_bits(size_t elem_bits) {
-    if (elem_bits == 0 || elem_bits > 512) {
-        return NULL;
+int psi_gc_prepare_circuit(psi_gc_ctx *ctx) {
+    if (!ctx) {
+        return -1;
     }
 
-    const uint16_t k = (uint16_t)elem_bits;
-    const uint16_t n_inputs = (uint16_t)(2 * k);
+    int rc = psi_gc_build(ctx, psi_block_size(ctx, ctx->max_elems),
+                          psi_gc_width(ctx, ctx->max_elems, ctx->max_elems));
+    if (rc != 0) {
+        return rc;
+    }
+    rc = psi_gc_pregarble(ctx);
+    return (rc < 0) ? rc : 0;
+}
 
-    const uint16_t base_xor = (uint16_t)(2 * k);
-    const uint16_t base_eq  = (uint16_t)(3 * k);
-    const uint16_t base_acc = (uint16_t)(4 * k);
-    const uint16_t out_wire = (uint16_t)(base_acc + (k > 1 ? (k - 2) : 0));
+// room for n labels of A. sized by the call's count_a and the circuit's
+// k rather than max_elems and elem_bits, so a small A against a large B
+// holds labels for the small side only, at the truncated width; a wider
+// circuit or a larger A reallocates. the old contents are not kept.
+static int psi_gc_reserve_a(psi_gc_ctx *ctx, size_t n) {
+    if (n <= ctx->labels_a_cap) {
+        return 0;
+    }
+    free(ctx->labels_a);
+    ctx->labels_a = (gc_label *)malloc(n * sizeof(gc_label));
+    ctx->labels_a_cap = ctx->labels_a ? n : 0;
+    return ctx->labels_a ? 0 : -3;
+}
 
-    const uint16_t n_wires =
-        (uint16_t)((k == 1)
-            ? (4 * k + 1)
-            : (4 * k + (k - 1)));
+// the garbling for one compute call: the reused one, or a fresh one from
+// the pool (garbled now if the pool ran dry) that the caller frees
+static gc_garbled_circuit *psi_gc_take_garbling(psi_gc_ctx *ctx) {
+    if (ctx->pool_cap == 0) {
+        if (!ctx->gc && gc_garble(ctx->plain, &ctx->gc) != 0) {
+            return NULL;
+        }
+        return ctx->gc;
+    }
+    if (ctx->pool_len > 0) {
+        return ctx->pool[--ctx->pool_len];
+    }
+    gc_garbled_circuit *gc = NULL;
+    return (gc_garble(ctx->plain, &gc) == 0) ? gc : NULL;
+}
 
-    const size_t n_gates = (size_t)(k + k + (k > 1 ? (k - 1) : 1));
+// input labels for count elements of elem_bytes each, k labels per
+// element back to back: element e's bit i goes on input
+// first + e * stride + i (stride 0 when every element feeds the same
+// inputs). only the low bits bits are read; inputs past them get 0.
+// computed once per garbling so the comparison loops do no per-bit work.
+static void psi_encode_labels(
+    const gc_garbled_circuit *gc,
+    size_t                    first,
+    size_t                    stride,
+    const uint8_t            *elems,
+    size_t                    count,
+    size_t                    elem_bytes,
+    size_t                    k,
+    size_t                    bits,
+    gc_label                 *out
+) {
+    for (size_t e = 0; e < count; ++e) {
+        const uint8_t *bytes = elems + e * elem_bytes;
+        for (size_t i = 0; i < k; ++i) {
+            gc_wire_id w = gc->input_wires[first + e * stride + i];
+            uint8_t bit = (i < bits) ? (bytes[i / 8] >> (i % 8)) & 1u : 0u;
+            out[e * k + i] = bit ? gc->wire_labels1[w] : gc->wire_labels0[w];
+        }
+    }
+}
 
-    gc_circuit *c = (gc_circuit *)calloc(1, sizeof(gc_circuit));
-    if (!c) return NULL;
+static uint8_t psi_bit_get(const uint8_t *bits, size_t i) {
+    return (bits[i / 8] >> (i % 8)) & 1u;
+}
 
-    c->n_wires   = n_wires;
-    c->n_inputs  = n_inputs;
-    c->n_outputs = 1;
-    c->n_gates   = n_gates;
+static void psi_bit_set(uint8_t *bits, size_t i) {
+    bits[i / 8] |= (uint8_t)(1u << (i % 8));
+}
 
-    c->input_wires  = (uint16_t *)calloc(c->n_inputs, sizeof(uint16_t));
-    c->output_wires = (uint16_t *)calloc(c->n_outputs, sizeof(uint16_t));
-    c->gates        = (gc_gate *)calloc(c->n_gates, sizeof(gc_gate));
-    if (!c->input_wires || !c->output_wires || !c->gates) {
-        gc_circuit_free(c);
-        return NULL;
+static size_t psi_popcount(const uint8_t *bits, size_t n) {
+    const size_t n_bytes = (n + 7) / 8;
+    size_t total = 0, i = 0;
+    for (; i + 8 <= n_bytes; i += 8) {
+        uint64_t w;
+        memcpy(&w, bits + i, 8);
+        total += (size_t)__builtin_popcountll(w);
     }
-
-    for (uint16_t i = 0; i < c->n_inputs; ++i) {
-        c->input_wires[i] = i;
+    for (; i < n_bytes; ++i) {
+        total += (size_t)__builtin_popcount(bits[i]);
     }
-    c->output_wires[0] = out_wire;
-
-    size_t gi = 0;
+    return total;
+}
 
-    for (uint16_t i = 0; i < k; ++i) {
-        gc_gate *g = &c->gates[gi++];
-        g->in0  = i;
-        g->in1  = (uint16_t)(k + i);
-        g->out  = (uint16_t)(base_xor + i);
-        g->type = GC_GATE_XOR;
+// one compute call's garbled comparisons. hits gets bit i for each element
+// i of A found in B. with verify, output labels are checked against both
+// of the garbler's labels; without it they are decoded from their permute
+// bit alone, which is all a count needs. with pairs, each hit is also
+// traced to an element of B and appended; failed records a failed append.
+// bits is how many low bits of each element this call compares, at most
+// the circuit's k.
+typedef struct {
+    psi_gc_ctx               *ctx;
+    const gc_garbled_circuit *gc;
+    size_t                    bits;
+    const uint8_t            *inputs_b;
+    uint8_t                  *hits;
+    int                       verify;
+    uint8_t                   decode;
+    psi_pairs                *pairs;
+    int                       failed;
+} psi_gc_run;
+
+// labels for one block of B: slot j gets element items[j] of B, or
+// element j when items is NULL. a short block is padded by repeating its
+// final element, which cannot change an OR of equalities.
+static void psi_gc_encode_block(
+    psi_gc_run     *r,
+    const uint8_t  *inputs_b,
+    const uint32_t *items,
+    size_t          len
+) {
+    psi_gc_ctx *ctx = r->ctx;
+    const size_t k = ctx->k;
+    const size_t elem_bytes = (ctx->elem_bits + 7u) / 8u;
+
+    if (!items) {
+        psi_encode_labels(r->gc, k, k, inputs_b, len, elem_bytes, k, r->bits,
+                          ctx->labels_block);
+    }
+    for (size_t j = items ? 0 : len; j < ctx->m; ++j) {
+        size_t e = (j < len) ? j : len - 1;
+        if (items) {
+            e = items[e];
+        }
+        psi_encode_labels(r->gc, (j + 1) * k, 0, inputs_b + e * elem_bytes,
+                          1, elem_bytes, k, r->bits, ctx->labels_block + j * k);
     }
+}
 
-    for (uint16_t i = 0; i < k; ++i) {
-        gc_gate *g = &c->gates[gi++];
-        g->in0  = (uint16_t)(base_xor + i);
-        g->in1  = 0;
-        g->out  = (uint16_t)(base_eq + i);
-        g->type = GC_GATE_NOT;
+// element i of A against the encoded block; a failed evaluation counts as
+// no match
+static uint8_t psi_gc_eval_member(psi_gc_run *r, size_t i) {
+    psi_gc_ctx *ctx = r->ctx;
+    const size_t k = ctx->k;
+    gc_label out_label;
+    uint8_t out_bit;
+    if (gc_evaluator_eval_spans(ctx->ev, r->gc, ctx->labels_a + i * k, (gc_wire_id)k,
+                                ctx->labels_block, &out_label) != 0) {
+        return 0;
+    }
+    if (!r->verify) {
+        return (out_label.b[0] & 1u) ^ r->decode;
     }
+    return gc_decode_outputs(r->gc, &out_label, &out_bit) == 0 ? out_bit : 0;
+}
 
-    if (k == 1) {
-        gc_gate *g = &c->gates[gi++];
-        g->in0  = base_eq;
-        g->in1  = base_eq;
-        g->out  = out_wire;
-        g->type = GC_GATE_AND;
-    } else {
-        uint16_t acc = base_eq;
-        for (uint16_t i = 1; i < k; ++i) {
-            uint16_t next_eq = (uint16_t)(base_eq + i);
-            uint16_t next_acc =
-                (i == k - 1) ? out_wire : (uint16_t)(base_acc + (i - 1));
-
-            gc_gate *g = &c->gates[gi++];
-            g->in0  = acc;
-            g->in1  = next_eq;
-            g->out  = next_acc;
-            g->type = GC_GATE_AND;
-
-            acc = next_acc;
+// which of the len elements of B that element i of A just matched (items,
+// or B's elements from first on when items is NULL) is the equal one: the
+// block is halved, re-encoded and evaluated again until one is left, so
+// log2(m) more evaluations per hit
+static uint32_t psi_gc_locate(
+    psi_gc_run     *r,
+    size_t          i,
+    const uint32_t *items,
+    size_t          first,
+    size_t          len
+) {
+    const size_t elem_bytes = (r->ctx->elem_bits + 7u) / 8u;
+    while (len > 1) {
+        size_t half = len / 2;
+        psi_gc_encode_block(r, items ? r->inputs_b : r->inputs_b + first * elem_bytes,
+                            items, half);
+        if (psi_gc_eval_member(r, i)) {
+            len = half;
+            continue;
+        }
+        if (items) {
+            items += half;
+        } else {
+            first += half;
         }
+        len -= half;
     }
+    return items ? items[0] : (uint32_t)first;
+}
 
-    return c;
+// records a hit on element i of A against the block just evaluated.
+// returns 1 if tracing it to a pair overwrote the block's labels.
+static int psi_gc_hit(
+    psi_gc_run     *r,
+    size_t          i,
+    const uint32_t *items,
+    size_t          first,
+    size_t          len
+) {
+    psi_bit_set(r->hits, i);
+    if (!r->pairs) {
+        return 0;
+    }
+    uint32_t j = psi_gc_locate(r, i, items, first, len);
+    if (psi_pairs_push(r->pairs, (uint32_t)i, j) != 0) {
+        r->failed = 1;
+    }
+    return len > 1;
 }
 
-static void fill_bit_inputs(
-    uint8_t       *inputs,
-    const uint8_t *bytes_a,
-    const uint8_t *bytes_b,
-    size_t         elem_bits
+// blocks are the outer loop so B's labels are encoded once per block, in
+// one pass over B; each element of A not yet found then costs one
+// evaluation and one decode per block. with subset, only those elements
+// of A take part.
+static void psi_gc_compare_blocks(
+    psi_gc_run     *r,
+    const uint32_t *subset,
+    size_t          n,
+    const uint8_t  *inputs_b,
+    size_t          count_b
 ) {
-    const size_t elem_bytes = (elem_bits + 7u) / 8u;
-    const size_t k = elem_bits;
+    const size_t elem_bytes = (r->ctx->elem_bits + 7u) / 8u;
+    const size_t m = r->ctx->m;
+
+    for (size_t start = 0; start < count_b; start += m) {
+        size_t len = (count_b - start < m) ? count_b - start : m;
+        psi_gc_encode_block(r, inputs_b + start * elem_bytes, NULL, len);
+        for (size_t s = 0; s < n; ++s) {
+            size_t i = subset ? subset[s] : s;
+            if (!psi_bit_get(r->hits, i) && psi_gc_eval_member(r, i) &&
+                psi_gc_hit(r, i, NULL, start, len)) {
+                psi_gc_encode_block(r, inputs_b + start * elem_bytes, NULL, len);
+            }
+        }
+    }
+}
 
-    for (size_t i = 0; i < k; ++i) {
-        size_t byte_idx = i / 8;
-        size_t bit_idx  = i % 8;
+// each element of A is compared only with the elements of B sharing its
+// cuckoo bin, m at a time; the stash, usually empty, goes against all of B
+static int psi_gc_compare_bins(
+    psi_gc_run    *r,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b
+) {
+    const size_t elem_bytes = (r->ctx->elem_bits + 7u) / 8u;
+    const size_t m = r->ctx->m;
 
-        uint8_t bit_a = 0;
-        uint8_t bit_b = 0;
+    psi_bins bins;
+    if (psi_bins_build(&bins, inputs_a, count_a, inputs_b, count_b, elem_bytes) != 0) {
+        psi_bins_free(&bins);
+        return -3;
+    }
 
-        if (byte_idx < elem_bytes) {
-            bit_a = (bytes_a[byte_idx] >> bit_idx) & 1u;
-            bit_b = (bytes_b[byte_idx] >> bit_idx) & 1u;
+    for (size_t bin = 0; bin < bins.n_bins; ++bin) {
+        const uint32_t i = bins.bin_a[bin];
+        if (i == PSI_BINS_EMPTY) {
+            continue;
         }
+        const uint32_t *items = bins.items_b + bins.start_b[bin];
+        const size_t n = bins.start_b[bin + 1] - bins.start_b[bin];
+        for (size_t start = 0; start < n && !psi_bit_get(r->hits, i); start += m) {
+            size_t len = (n - start < m) ? n - start : m;
+            psi_gc_encode_block(r, inputs_b, items + start, len);
+            if (psi_gc_eval_member(r, i)) {
+                psi_gc_hit(r, i, items + start, 0, len);
+            }
+        }
+    }
+    psi_gc_compare_blocks(r, bins.stash, bins.n_stash, inputs_b, count_b);
 
-        inputs[i]        = bit_a;
-        inputs[k + i]    = bit_b;
+    psi_bins_free(&bins);
+    return 0;
+}
+
+static int psi_gc_check_asym(
+    const psi_gc_ctx *ctx,
+    const uint8_t    *inputs_a,
+    size_t            count_a,
+    const uint8_t    *inputs_b,
+    size_t            count_b,
+    const void       *out
+) {
+    if (!ctx || (!inputs_a && count_a) || (!inputs_b && count_b) || (!out && count_a)) {
+        return -1;
+    }
+    if (count_a > ctx->max_elems || count_b > ctx->max_elems) {
+        return -2;
     }
+    return 0;
 }
 
-static void psi_compute_naive(
+// the garbled engines, or the hash join when there is no circuit, into
+// hits (count_a bits, cleared here) and pairs if given (cleared too)
+static int psi_gc_compute_bits(
+    psi_gc_ctx    *ctx,
     const uint8_t *inputs_a,
+    size_t         count_a,
     const uint8_t *inputs_b,
-    size_t         count,
-    size_t         elem_bytes,
+    size_t         count_b,
+    uint8_t       *hits,
+    int            verify,
+    psi_pairs     *pairs
+) {
+    memset(hits, 0, (count_a + 7) / 8);
+    psi_pairs_clear(pairs);
+    if (count_a == 0 || count_b == 0) {
+        return 0;
+    }
+
+    const size_t bits = psi_gc_width(ctx, count_a, count_b);
+    int rc = psi_gc_build(ctx, psi_block_size(ctx, count_b), bits);
+    if (rc != 0) {
+        return rc;
+    }
+    const size_t elem_bytes = (ctx->elem_bits + 7u) / 8u;
+    if (ctx->plain && psi_gc_reserve_a(ctx, count_a * ctx->k) != 0) {
+        return -3;
+    }
+    gc_garbled_circuit *gc = ctx->plain ? psi_gc_take_garbling(ctx) : NULL;
+    if (!gc && pairs) {
+        return psi_join_pairs(inputs_a, count_a, inputs_b, count_b, elem_bytes,
+                              ctx->workers, pairs) ? -3 : 0;
+    }
+    if (!gc) {
+        return psi_join_bits(inputs_a, count_a, inputs_b, count_b, elem_bytes,
+                             ctx->workers, hits) ? -3 : 0;
+    }
+
+    psi_gc_run r = {
+        .ctx = ctx, .gc = gc, .bits = bits, .inputs_b = inputs_b, .hits = hits,
+        .verify = verify, .pairs = pairs,
+    };
+    // one output wire, so one decode bit serves every evaluation
+    gc_decode_info(gc, &r.decode);
+    psi_encode_labels(gc, 0, 0, inputs_a, count_a, elem_bytes, ctx->k, bits, ctx->labels_a);
+    if (ctx->mode == PSI_GC_MODE_CUCKOO) {
+        rc = psi_gc_compare_bins(&r, inputs_a, count_a, inputs_b, count_b);
+    } else {
+        psi_gc_compare_blocks(&r, NULL, count_a, inputs_b, count_b);
+    }
+    if (gc != ctx->gc) {
+        gc_garbled_free(gc);
+    }
+    return (rc == 0 && r.failed) ? -3 : rc;
+}
+
+int psi_gc_compute_asym(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
     uint8_t       *out_mask
 ) {
-    for (size_t i = 0; i < count; ++i) {
-        const uint8_t *ai = inputs_a + i * elem_bytes;
-        uint8_t found = 0;
-        for (size_t j = 0; j < count; ++j) {
-            const uint8_t *bj = inputs_b + j * elem_bytes;
-            if (memcmp(ai, bj, elem_bytes) == 0) {
-                found = 1;
-                break;
-            }
-        }
-        out_mask[i] = found;
+    int rc = psi_gc_check_asym(ctx, inputs_a, count_a, inputs_b, count_b, out_mask);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = psi_gc_compute_bits(ctx, inputs_a, count_a, inputs_b, count_b, ctx->hits, 1, NULL);
+    for (size_t i = 0; i < count_a && rc == 0; ++i) {
+        out_mask[i] = psi_bit_get(ctx->hits, i);
     }
+    return rc;
 }
 
-static int psi_gc_compute_with_gc_y(
+int psi_gc_compute(
     psi_gc_ctx    *ctx,
     const uint8_t *inputs_a,
     const uint8_t *inputs_b,
@@ -243,82 +634,161 @@ static int psi_gc_compute_with_gc_y(
     if (!ctx || !inputs_a || !inputs_b || !out_mask) {
         return -1;
     }
-    if (count == 0) {
-        return 0;
+    return psi_gc_compute_asym(ctx, inputs_a, count, inputs_b, count, out_mask);
+}
+
+int psi_gc_compute_packed(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    uint8_t       *out_bits
+) {
+    int rc = psi_gc_check_asym(ctx, inputs_a, count_a, inputs_b, count_b, out_bits);
+    if (rc != 0) {
+        return rc;
     }
-    if (count > ctx->max_elems) {
-        return -2;
+    return psi_gc_compute_bits(ctx, inputs_a, count_a, inputs_b, count_b, out_bits, 1, NULL);
+}
+
+int psi_gc_cardinality(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    size_t        *out_count
+) {
+    int rc = psi_gc_check_asym(ctx, inputs_a, count_a, inputs_b, count_b, out_count);
+    if (rc != 0) {
+        return rc;
+    }
+    if (!out_count) {
+        return -1;
     }
 
-    const size_t elem_bits  = ctx->elem_bits;
-    const size_t elem_bytes = (elem_bits + 7u) / 8u;
+    rc = psi_gc_compute_bits(ctx, inputs_a, count_a, inputs_b, count_b, ctx->hits, 0, NULL);
+    *out_count = (rc == 0) ? psi_popcount(ctx->hits, count_a) : 0;
+    return rc;
+}
 
-    gc_circuit *plain = build_eq_circuit_bits(elem_bits);
-    if (!plain) {
-        psi_compute_naive(inputs_a, inputs_b, count, elem_bytes, out_mask);
-        return 0;
+int psi_gc_compute_pairs(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    psi_pairs     *out_pairs
+) {
+    int rc = psi_gc_check_asym(ctx, inputs_a, count_a, inputs_b, count_b, out_pairs);
+    if (rc != 0) {
+        return rc;
     }
-
-    gc_garbled_circuit *gc = NULL;
-    if (gc_garble(plain, &gc) != 0 || !gc) {
-        gc_circuit_free(plain);
-        psi_compute_naive(inputs_a, inputs_b, count, elem_bytes, out_mask);
-        return 0;
+    if (!out_pairs) {
+        return -1;
     }
+    if (count_a >= UINT32_MAX || count_b >= UINT32_MAX) {
+        return -2;
+    }
+    return psi_gc_compute_bits(ctx, inputs_a, count_a, inputs_b, count_b, ctx->hits, 1,
+                               out_pairs);
+}
 
-    const size_t n_inputs = plain->n_inputs;
-    uint8_t *bit_inputs = (uint8_t *)calloc(n_inputs, sizeof(uint8_t));
-    gc_label *input_labels = (gc_label *)calloc(plain->n_inputs, sizeof(gc_label));
-    gc_label out_labels[1];
-    uint8_t out_bits[1];
-
-    if (!bit_inputs || !input_labels) {
-        free(bit_inputs);
-        free(input_labels);
-        gc_garbled_free(gc);
-        gc_circuit_free(plain);
-        return -3;
+int psi_hash_only_compute_asym(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    uint8_t       *out_mask
+) {
+    int rc = psi_gc_check_asym(ctx, inputs_a, count_a, inputs_b, count_b, out_mask);
+    if (rc != 0) {
+        return rc;
     }
 
-    for (size_t i = 0; i < count; ++i) {
-        const uint8_t *ai = inputs_a + i * elem_bytes;
-        uint8_t found = 0;
+    const size_t elem_bits  = ctx->elem_bits;
+    const size_t elem_bytes = (elem_bits + 7u) / 8u;
 
-        for (size_t j = 0; j < count; ++j) {
-            const uint8_t *bj = inputs_b + j * elem_bytes;
+    return psi_join_mask_parallel(inputs_a, count_a, inputs_b, count_b, elem_bytes,
+                                  ctx->workers, out_mask) ? -3 : 0;
+}
 
-            memset(bit_inputs, 0, n_inputs);
-            fill_bit_inputs(bit_inputs, ai, bj, elem_bits);
+int psi_hash_only_compute(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    const uint8_t *inputs_b,
+    size_t         count,
+    uint8_t       *out_mask
+) {
+    if (!ctx || !inputs_a || !inputs_b || !out_mask) {
+        return -1;
+    }
+    return psi_hash_only_compute_asym(ctx, inputs_a, count, inputs_b, count, out_mask);
+}
 
-            for (uint16_t k = 0; k < plain->n_inputs; ++k) {
-                uint16_t w = gc->input_wires[k];
-                uint8_t bit = bit_inputs[k] & 1u;
-                input_labels[k] = (bit == 0)
-                    ? gc->wire_labels0[w]
-                    : gc->wire_labels1[w];
-            }
+int psi_hash_only_compute_packed(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    uint8_t       *out_bits
+) {
+    int rc = psi_gc_check_asym(ctx, inputs_a, count_a, inputs_b, count_b, out_bits);
+    if (rc != 0) {
+        return rc;
+    }
 
-            if (gc_eval_garbled(gc, input_labels, out_labels) != 0) {
-                continue;
-            }
-            if (gc_decode_outputs(gc, out_labels, out_bits) != 0) {
-                continue;
-            }
+    const size_t elem_bytes = (ctx->elem_bits + 7u) / 8u;
+    return psi_join_bits(inputs_a, count_a, inputs_b, count_b, elem_bytes,
+                         ctx->workers, out_bits) ? -3 : 0;
+}
 
-            if (out_bits[0] == 1u) {
-                found = 1;
-                break;
-            }
-        }
+int psi_hash_only_cardinality(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    size_t        *out_count
+) {
+    int rc = psi_gc_check_asym(ctx, inputs_a, count_a, inputs_b, count_b, out_count);
+    if (rc != 0) {
+        return rc;
+    }
+    if (!out_count) {
+        return -1;
+    }
 
-        out_mask[i] = found;
+    rc = psi_hash_only_compute_packed(ctx, inputs_a, count_a, inputs_b, count_b, ctx->hits);
+    *out_count = (rc == 0) ? psi_popcount(ctx->hits, count_a) : 0;
+    return rc;
+}
+
+int psi_hash_only_compute_pairs(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    psi_pairs     *out_pairs
+) {
+    int rc = psi_gc_check_asym(ctx, inputs_a, count_a, inputs_b, count_b, out_pairs);
+    if (rc != 0) {
+        return rc;
+    }
+    if (!out_pairs) {
+        return -1;
+    }
+    if (count_a >= UINT32_MAX || count_b >= UINT32_MAX) {
+        return -2;
     }
 
-    free(bit_inputs);
-    free(input_labels);
-    gc_garbled_free(gc);
-    gc_circuit_free(plain);
-    return 0;
+    const size_t elem_bytes = (ctx->elem_bits + 7u) / 8u;
+    return psi_join_pairs(inputs_a, count_a, inputs_b, count_b, elem_bytes,
+                          ctx->workers, out_pairs) ? -3 : 0;
 }
 
 int gc_proto_psi_simulate(
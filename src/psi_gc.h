@@ -3,18 +3,95 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "psi_pairs.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef struct psi_gc_ctx psi_gc_ctx;
 
+// how psi_gc_compute lays out the garbled comparisons
+//   PSI_GC_MODE_BLOCK:    one membership circuit per element of A and block
+//                         of B (equalities ORed inside the circuit), so each
+//                         evaluation and decode covers a whole block
+//   PSI_GC_MODE_PAIRWISE: one equality circuit per (a, b) pair
+//   PSI_GC_MODE_CUCKOO:   A cuckoo-hashed and B simple-hashed into bins
+//                         (see psi_bins.h); each element of A is only
+//                         compared with B's elements in its bin, a block at
+//                         a time, so O(n * max bin size) equalities instead
+//                         of n^2. the stash is compared with all of B, so
+//                         the mask stays exact.
+typedef enum {
+    PSI_GC_MODE_BLOCK    = 0,
+    PSI_GC_MODE_PAIRWISE = 1,
+    PSI_GC_MODE_CUCKOO   = 2
+} psi_gc_mode;
+
+// elements of B per membership circuit when none is given
+#define PSI_GC_DEFAULT_BLOCK 256
+
+// elements of a bin per membership circuit when none is given; bins hold
+// about 2.4 elements of B on average when the sets are the same size
+#define PSI_GC_DEFAULT_BIN 4
+
+// statistical security parameter for psi_gc_set_sigma: a false match
+// with probability about 2^-40
+#define PSI_GC_DEFAULT_SIGMA 40
+
 psi_gc_ctx *psi_gc_create(size_t max_elems, size_t elem_bits);
 
 void psi_gc_destroy(psi_gc_ctx *ctx);
 
+// defaults to PSI_GC_MODE_CUCKOO. block_elems is the block size for
+// PSI_GC_MODE_BLOCK (0 for PSI_GC_DEFAULT_BLOCK) and PSI_GC_MODE_CUCKOO (0
+// for PSI_GC_DEFAULT_BIN); ignored otherwise.
+int psi_gc_set_mode(psi_gc_ctx *ctx, psi_gc_mode mode, size_t block_elems);
+
+// digest bits that keep a false match between any of count_a x count_b
+// pairs of random digests below 2^-sigma: sigma + log2(count_a) +
+// log2(count_b), each log rounded up
+size_t psi_gc_digest_bits(size_t count_a, size_t count_b, size_t sigma);
+
+// for inputs that are uniformly random digests (keyed BLAKE3 output, say):
+// with sigma > 0 the garbled path compares only the low
+// psi_gc_digest_bits(count_a, count_b, sigma) bits of each element (never
+// more than elem_bits), so the circuit needs proportionally fewer ANDs and
+// labels. a BLAKE3 XOF digest of that width is exactly those bits (see
+// psi_blake3_hash_bytes_bits). a mask entry may then be a false match with
+// probability about 2^-sigma; the hash join still compares every bit.
+// 0, the default, compares all elem_bits. a call whose counts need fewer
+// bits than the circuit holds (psi_gc_prepare_circuit sizes it for
+// max_elems on both sides) keeps the circuit and pre-garbled pool and
+// feeds zeros to the surplus inputs; one that needs more rebuilds it.
+int psi_gc_set_sigma(psi_gc_ctx *ctx, size_t sigma);
+
+// threads for the hash joins (psi_hash_only_compute, and psi_gc_compute
+// when it compares in the clear). 1, the default, joins on the calling
+// thread; 0 uses every online CPU.
+int psi_gc_set_threads(psi_gc_ctx *ctx, size_t n_threads);
+
+// builds the comparison circuit for max_elems and the scratch buffers, and
+// garbles ahead of time: fills the pre-garbled pool if one is set, otherwise
+// garbles the one circuit every compute call reuses. compute calls prepare
+// lazily; a smaller count keeps the prepared circuit, padding its shorter
+// blocks.
 int psi_gc_prepare_circuit(psi_gc_ctx *ctx);
 
+// keeps up to n garblings made ahead of time; each compute call then takes
+// a fresh one (garbling inline once the pool is empty) instead of reusing a
+// single garbling. 0, the default, turns the pool off. drops any garblings
+// already made.
+int psi_gc_set_pregarbled(psi_gc_ctx *ctx, size_t n);
+
+// tops the pool up to its size, e.g. while idle between compute calls.
+// returns the number of garblings ready, or -2 before the circuit is built.
+int psi_gc_pregarble(psi_gc_ctx *ctx);
+
+// garblings waiting in the pool. a call takes one as long as its counts
+// fit the prepared circuit (blocks no wider, the same digest width).
+size_t psi_gc_pregarbled_ready(const psi_gc_ctx *ctx);
+
 int psi_gc_compute(
     psi_gc_ctx    *ctx,
     const uint8_t *inputs_a,
@@ -31,6 +108,109 @@ int psi_hash_only_compute(
     uint8_t       *out_mask
 );
 
+// A and B of different sizes, each at most max_elems; out_mask has count_a
+// entries. psi_gc_compute and psi_hash_only_compute are these with
+// count_a = count_b = count.
+//
+// the hash join builds its table on the smaller set and streams the larger
+// one past it once. the garbled path encodes each set's labels in one
+// pass; PSI_GC_MODE_BLOCK sizes its blocks from count_b.
+int psi_gc_compute_asym(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    uint8_t       *out_mask
+);
+
+int psi_hash_only_compute_asym(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    uint8_t       *out_mask
+);
+
+// the asym calls with one bit per element of A: bit i of out_bits[i / 8],
+// (count_a + 7) / 8 bytes
+int psi_gc_compute_packed(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    uint8_t       *out_bits
+);
+
+int psi_hash_only_compute_packed(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    uint8_t       *out_bits
+);
+
+// |{i : a[i] in B}| (duplicates in A count each time). hits go to a bit
+// vector in the context and are popcounted, so no per-element output is
+// returned. the garbled path decodes each evaluation from the output
+// label's permute bit instead of a decode call.
+//
+// this is a local-API convenience, not PSI-CA: every per-element
+// membership bit is decoded in the clear on the evaluating side before
+// the count is taken, so it hides nothing that psi_gc_compute_packed
+// would reveal. a two-party deployment that must reveal only the count
+// needs the count itself garbled (an adder tree over the membership
+// outputs, decoded once), which this block-at-a-time evaluation does not
+// do.
+int psi_gc_cardinality(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    size_t        *out_count
+);
+
+int psi_hash_only_cardinality(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    size_t        *out_count
+);
+
+// sparse results: out_pairs is cleared, then gets one (index in A, index
+// in B) pair per element of A found in B, appended as each hit is found
+// rather than gathered from a mask, in no particular order. counts must
+// fit the 32-bit indices.
+//
+// the garbled engines only learn that an element of A is in a block (or
+// bin chunk) of B; a hit is traced to one element of the block by
+// evaluating halves of it again, log2 of the block size more evaluations
+// per element in the intersection. the hash join reports whichever equal
+// element of B it meets first.
+int psi_gc_compute_pairs(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    psi_pairs     *out_pairs
+);
+
+int psi_hash_only_compute_pairs(
+    psi_gc_ctx    *ctx,
+    const uint8_t *inputs_a,
+    size_t         count_a,
+    const uint8_t *inputs_b,
+    size_t         count_b,
+    psi_pairs     *out_pairs
+);
+
 int gc_proto_psi_simulate(
     const uint8_t *inputs_a_flat,
     const uint8_t *inputs_b_flat,
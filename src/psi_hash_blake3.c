@@ -64,3 +64,26 @@ void psi_blake3_hash_bytes(const uint8_t *data,
 
     blake3_hasher_finalize(&hasher, out, PSI_BLAKE3_DIGEST_LEN);
 }
+
+PSI_EMS_KEEPALIVE
+void psi_blake3_hash_bytes_bits(const uint8_t *data,
+                                size_t         len,
+                                uint8_t       *out,
+                                size_t         out_bits) {
+    if (!out || out_bits == 0) {
+        return;
+    }
+
+    blake3_hasher hasher;
+    blake3_hasher_init_keyed(&hasher, PSI_BLAKE3_DEFAULT_KEY);
+
+    if (data && len > 0) {
+        blake3_hasher_update(&hasher, data, len);
+    }
+
+    const size_t out_len = (out_bits + 7u) / 8u;
+    blake3_hasher_finalize(&hasher, out, out_len);
+    if (out_bits % 8) {
+        out[out_len - 1] &= (uint8_t)((1u << (out_bits % 8)) - 1u);
+    }
+}
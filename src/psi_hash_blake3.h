@@ -21,6 +21,16 @@ void psi_blake3_hash_bytes(const uint8_t *data,
                            size_t         len,
                            uint8_t       *out);
 
+// psi_blake3_hash_bytes at any width: out_bits bits of the keyed BLAKE3
+// XOF in (out_bits + 7) / 8 bytes, the unused high bits of the last byte
+// cleared. the XOF output does not depend on its length, so this is a
+// prefix of any longer digest of the same data (including the
+// PSI_BLAKE3_DIGEST_LEN one).
+void psi_blake3_hash_bytes_bits(const uint8_t *data,
+                                size_t         len,
+                                uint8_t       *out,
+                                size_t         out_bits);
+
 #ifdef __cplusplus
 }
 #endif
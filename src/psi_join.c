@@ -0,0 +1,629 @@
+#include "psi_join.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gc_pool.h"
+#include "psi_pairs.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PSI_JOIN_PREFETCH(p) __builtin_prefetch((p))
+#else
+#define PSI_JOIN_PREFETCH(p) ((void)(p))
+#endif
+
+#define PSI_JOIN_GROUP 16
+#define PSI_JOIN_EMPTY 0x80u
+
+// hashes of this many streamed elements are computed and their groups
+// prefetched before any of them is probed
+#define PSI_JOIN_WINDOW 16
+
+// partitions aim for this many elements on their smaller side, so a
+// partition's table and entries stay in L2; the fan-out is capped so the
+// scatter writes to few enough pages to stay in the TLB (larger inputs get
+// larger partitions)
+#define PSI_JOIN_PART_ELEMS 8192
+#define PSI_JOIN_MAX_PART_BITS 11
+
+// below this many elements in all, partitioning costs more than it saves
+#define PSI_JOIN_PARALLEL_MIN 65536
+
+#define PSI_JOIN_MISS UINT32_MAX
+
+typedef struct {
+    uint8_t  *ctrl;     // n_groups * PSI_JOIN_GROUP control bytes
+    uint32_t *slots;    // element index of each full slot
+    size_t    mask;     // n_groups - 1
+    size_t    cap;      // groups allocated
+} psi_join_table;
+
+// where hits go: one byte per element of A, or one bit (bit i of
+// bits[i / 8]). shared is set when several workers write bits, which then
+// share bytes and need atomic updates. only hits are written; the output
+// is cleared up front.
+//
+// with pairs, each hit also appends (i, j) to the worker's array; the bits
+// then only keep an element of A that several of B's elements find from
+// being paired more than once. failed is set if an append fails.
+typedef struct {
+    uint8_t   *mask;
+    uint8_t   *bits;
+    int        shared;
+    psi_pairs *pairs;   // one per worker, or NULL
+    int       *failed;
+} psi_join_out;
+
+static uint8_t psi_join_get(const psi_join_out *o, size_t i) {
+    if (o->mask) {
+        return o->mask[i];
+    }
+    uint8_t byte = o->shared ? __atomic_load_n(&o->bits[i / 8], __ATOMIC_RELAXED) : o->bits[i / 8];
+    return (byte >> (i % 8)) & 1u;
+}
+
+static void psi_join_hit(const psi_join_out *o, size_t i, uint32_t j, size_t worker) {
+    if (o->pairs && psi_pairs_push(&o->pairs[worker], (uint32_t)i, j) != 0) {
+        __atomic_store_n(o->failed, 1, __ATOMIC_RELAXED);
+    }
+    if (o->mask) {
+        o->mask[i] = 1;
+    } else if (o->shared) {
+        __atomic_fetch_or(&o->bits[i / 8], (uint8_t)(1u << (i % 8)), __ATOMIC_RELAXED);
+    } else {
+        o->bits[i / 8] |= (uint8_t)(1u << (i % 8));
+    }
+}
+
+static void psi_join_clear(const psi_join_out *o, size_t count_a) {
+    if (o->mask) {
+        memset(o->mask, 0, count_a);
+    } else {
+        memset(o->bits, 0, (count_a + 7) / 8);
+    }
+}
+
+// 64-bit words of the element (the last one zero-padded), each folded in
+// with a multiply; digests already hash well, but plain elements need the
+// mixing so structured values do not pile into a few groups
+static uint64_t psi_join_hash(const uint8_t *e, size_t elem_bytes) {
+    uint64_t h = 0x9e3779b97f4a7c15ull ^ (uint64_t)elem_bytes;
+    size_t i = 0;
+    for (; i + 8 <= elem_bytes; i += 8) {
+        uint64_t w;
+        memcpy(&w, e + i, 8);
+        h = (h ^ w) * 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 31;
+    }
+    if (i < elem_bytes) {
+        uint64_t w = 0;
+        memcpy(&w, e + i, elem_bytes - i);
+        h = (h ^ w) * 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 31;
+    }
+    h *= 0x94d049bb133111ebull;
+    return h ^ (h >> 29);
+}
+
+// the low 7 bits are the tag, the bits above pick the first group; the
+// partitioned join takes partitions from the top bits
+static size_t psi_join_group(uint64_t h, size_t mask) {
+    return (size_t)(h >> 7) & mask;
+}
+
+static uint8_t psi_join_tag(uint64_t h) {
+    return (uint8_t)(h & 0x7fu);
+}
+
+// bit i set for each control byte i of the group equal to tag, and for
+// each empty one
+static void psi_join_match(const uint8_t *ctrl, uint8_t tag, uint32_t *hits, uint32_t *empty) {
+#if defined(__SSE2__)
+    __m128i g = _mm_loadu_si128((const __m128i *)ctrl);
+    *hits  = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)tag)));
+    *empty = (uint32_t)_mm_movemask_epi8(g);
+#else
+    const uint64_t lsb = 0x0101010101010101ull;
+    const uint64_t msb = 0x8080808080808080ull;
+    *hits = 0;
+    *empty = 0;
+    for (int half = 0; half < 2; ++half) {
+        uint64_t g;
+        memcpy(&g, ctrl + 8 * half, 8);
+        // zero bytes of x; may also flag a byte above a real zero, which
+        // the caller's element compare rejects
+        uint64_t x = g ^ (lsb * tag);
+        uint64_t z = (x - lsb) & ~x & msb;
+        uint64_t e = g & msb;
+        for (int i = 0; i < 8; ++i) {
+            *hits  |= (uint32_t)((z >> (8 * i + 7)) & 1u) << (8 * half + i);
+            *empty |= (uint32_t)((e >> (8 * i + 7)) & 1u) << (8 * half + i);
+        }
+    }
+#endif
+}
+
+// groups for n entries at most 7/8 full
+static size_t psi_join_groups_for(size_t n) {
+    size_t n_groups = 1;
+    while (n_groups * PSI_JOIN_GROUP * 7 < n * 8) {
+        n_groups *= 2;
+    }
+    return n_groups;
+}
+
+static int psi_join_alloc(psi_join_table *t, size_t n) {
+    t->cap   = psi_join_groups_for(n);
+    t->ctrl  = (uint8_t *)malloc(t->cap * PSI_JOIN_GROUP);
+    t->slots = (uint32_t *)malloc(t->cap * PSI_JOIN_GROUP * sizeof(uint32_t));
+    if (!t->ctrl || !t->slots) {
+        free(t->ctrl);
+        free(t->slots);
+        t->ctrl = NULL;
+        t->slots = NULL;
+        return -3;
+    }
+    return 0;
+}
+
+static void psi_join_free(psi_join_table *t) {
+    free(t->ctrl);
+    free(t->slots);
+}
+
+// empties the table and sizes it for n entries, n at most what it was
+// allocated for
+static void psi_join_reset(psi_join_table *t, size_t n) {
+    size_t n_groups = psi_join_groups_for(n);
+    t->mask = n_groups - 1;
+    memset(t->ctrl, PSI_JOIN_EMPTY, n_groups * PSI_JOIN_GROUP);
+}
+
+// duplicates are inserted as they come; a probe stops at the first
+static void psi_join_insert(psi_join_table *t, uint64_t h, uint32_t idx) {
+    size_t g = psi_join_group(h, t->mask);
+    // triangular steps visit every group of a power-of-two table
+    for (size_t step = 1;; ++step) {
+        uint32_t hits, empty;
+        psi_join_match(t->ctrl + g * PSI_JOIN_GROUP, 0, &hits, &empty);
+        if (empty) {
+            size_t s = g * PSI_JOIN_GROUP + (size_t)__builtin_ctz(empty);
+            t->ctrl[s]  = psi_join_tag(h);
+            t->slots[s] = idx;
+            return;
+        }
+        g = (g + step) & t->mask;
+    }
+}
+
+// the index in B of an element equal to e, or PSI_JOIN_MISS
+static uint32_t psi_join_probe(
+    const psi_join_table *t,
+    const uint8_t        *e,
+    uint64_t              h,
+    const uint8_t        *b,
+    size_t                elem_bytes
+) {
+    const uint8_t tag = psi_join_tag(h);
+    size_t g = psi_join_group(h, t->mask);
+    for (size_t step = 1;; ++step) {
+        uint32_t hits, empty;
+        psi_join_match(t->ctrl + g * PSI_JOIN_GROUP, tag, &hits, &empty);
+        while (hits) {
+            size_t s = g * PSI_JOIN_GROUP + (size_t)__builtin_ctz(hits);
+            if (memcmp(b + (size_t)t->slots[s] * elem_bytes, e, elem_bytes) == 0) {
+                return t->slots[s];
+            }
+            hits &= hits - 1;
+        }
+        if (empty) {
+            return PSI_JOIN_MISS;
+        }
+        g = (g + step) & t->mask;
+    }
+}
+
+// B's element j against a table built on A: marks every equal element of
+// A, duplicates included, so the whole probe sequence is walked
+static void psi_join_mark(
+    const psi_join_table *t,
+    const uint8_t        *b,
+    uint32_t              j,
+    uint64_t              h,
+    const uint8_t        *a,
+    size_t                elem_bytes,
+    const psi_join_out   *out,
+    size_t                worker
+) {
+    const uint8_t *e = b + (size_t)j * elem_bytes;
+    const uint8_t tag = psi_join_tag(h);
+    size_t g = psi_join_group(h, t->mask);
+    for (size_t step = 1;; ++step) {
+        uint32_t hits, empty;
+        psi_join_match(t->ctrl + g * PSI_JOIN_GROUP, tag, &hits, &empty);
+        while (hits) {
+            size_t s = g * PSI_JOIN_GROUP + (size_t)__builtin_ctz(hits);
+            const uint32_t i = t->slots[s];
+            if (!psi_join_get(out, i) && memcmp(a + (size_t)i * elem_bytes, e, elem_bytes) == 0) {
+                psi_join_hit(out, i, j, worker);
+            }
+            hits &= hits - 1;
+        }
+        if (empty) {
+            return;
+        }
+        g = (g + step) & t->mask;
+    }
+}
+
+static int psi_join_check(
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes,
+    const uint8_t *out
+) {
+    if ((!a && count_a) || (!b && count_b) || (!out && count_a) || elem_bytes == 0) {
+        return -1;
+    }
+    if (count_a >= UINT32_MAX || count_b >= UINT32_MAX ||
+        count_a > SIZE_MAX / 8 || count_b > SIZE_MAX / 8) {
+        return -2;
+    }
+    return 0;
+}
+
+static int psi_join_serial(
+    const uint8_t      *a,
+    size_t              count_a,
+    const uint8_t      *b,
+    size_t              count_b,
+    size_t              elem_bytes,
+    const psi_join_out *out
+) {
+    if (count_a == 0) {
+        return 0;
+    }
+    psi_join_clear(out, count_a);
+    if (count_b == 0) {
+        return 0;
+    }
+
+    // the table goes on the smaller side and the larger one streams past
+    // it once, so a small A against a huge B costs a table of count_a
+    const int build_a = count_a < count_b;
+    const uint8_t *build = build_a ? a : b, *stream = build_a ? b : a;
+    const size_t n_build = build_a ? count_a : count_b, n_stream = build_a ? count_b : count_a;
+
+    psi_join_table t;
+    if (psi_join_alloc(&t, n_build) != 0) {
+        return -3;
+    }
+    psi_join_reset(&t, n_build);
+    for (size_t j = 0; j < n_build; ++j) {
+        psi_join_insert(&t, psi_join_hash(build + j * elem_bytes, elem_bytes), (uint32_t)j);
+    }
+
+    uint64_t hashes[PSI_JOIN_WINDOW];
+    for (size_t start = 0; start < n_stream; start += PSI_JOIN_WINDOW) {
+        size_t n = (n_stream - start < PSI_JOIN_WINDOW) ? n_stream - start : PSI_JOIN_WINDOW;
+        for (size_t i = 0; i < n; ++i) {
+            hashes[i] = psi_join_hash(stream + (start + i) * elem_bytes, elem_bytes);
+            PSI_JOIN_PREFETCH(t.ctrl + psi_join_group(hashes[i], t.mask) * PSI_JOIN_GROUP);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (build_a) {
+                psi_join_mark(&t, b, (uint32_t)(start + i), hashes[i], a, elem_bytes, out, 0);
+                continue;
+            }
+            uint32_t j = psi_join_probe(&t, a + (start + i) * elem_bytes, hashes[i], b, elem_bytes);
+            if (j != PSI_JOIN_MISS) {
+                psi_join_hit(out, start + i, j, 0);
+            }
+        }
+    }
+
+    psi_join_free(&t);
+    return 0;
+}
+
+int psi_join_mask(
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes,
+    uint8_t       *out_mask
+) {
+    int rc = psi_join_check(a, count_a, b, count_b, elem_bytes, out_mask);
+    if (rc != 0) {
+        return rc;
+    }
+    psi_join_out out = { .mask = out_mask };
+    return psi_join_serial(a, count_a, b, count_b, elem_bytes, &out);
+}
+
+// an element in its partition: the low half of its hash (tag and group
+// bits) and its index in A or B
+typedef struct {
+    uint32_t h;
+    uint32_t idx;
+} psi_join_entry;
+
+// one side's radix pass. the input is cut into n_chunks fixed chunks; hist
+// holds each chunk's count per partition, then where that chunk writes
+// into each partition.
+typedef struct {
+    const uint8_t  *elems;
+    size_t          count;
+    size_t          elem_bytes;
+    unsigned        shift;
+    size_t          n_parts;
+    size_t          n_chunks;
+    size_t         *hist;
+    psi_join_entry *out;
+} psi_join_radix;
+
+static size_t psi_join_part(uint64_t h, unsigned shift) {
+    return shift >= 64 ? 0 : (size_t)(h >> shift);
+}
+
+static void psi_join_radix_count(void *ctx, size_t begin, size_t end, size_t worker) {
+    psi_join_radix *r = (psi_join_radix *)ctx;
+    (void)worker;
+    for (size_t c = begin; c < end; ++c) {
+        size_t *hist = r->hist + c * r->n_parts;
+        size_t lo = r->count * c / r->n_chunks, hi = r->count * (c + 1) / r->n_chunks;
+        for (size_t i = lo; i < hi; ++i) {
+            ++hist[psi_join_part(psi_join_hash(r->elems + i * r->elem_bytes, r->elem_bytes), r->shift)];
+        }
+    }
+}
+
+static void psi_join_radix_scatter(void *ctx, size_t begin, size_t end, size_t worker) {
+    psi_join_radix *r = (psi_join_radix *)ctx;
+    (void)worker;
+    for (size_t c = begin; c < end; ++c) {
+        size_t *pos = r->hist + c * r->n_parts;
+        size_t lo = r->count * c / r->n_chunks, hi = r->count * (c + 1) / r->n_chunks;
+        for (size_t i = lo; i < hi; ++i) {
+            uint64_t h = psi_join_hash(r->elems + i * r->elem_bytes, r->elem_bytes);
+            r->out[pos[psi_join_part(h, r->shift)]++] = (psi_join_entry){ (uint32_t)h, (uint32_t)i };
+        }
+    }
+}
+
+// counts, turns the counts into write positions (partition-major, so each
+// partition is contiguous and chunks keep their order inside it), then
+// scatters. part_start gets n_parts + 1 entries.
+static void psi_join_radix_run(psi_join_radix *r, gc_pool *pool, size_t *part_start) {
+    memset(r->hist, 0, r->n_chunks * r->n_parts * sizeof(size_t));
+    gc_pool_for(pool, r->n_chunks, 1, psi_join_radix_count, r);
+
+    size_t pos = 0;
+    for (size_t p = 0; p < r->n_parts; ++p) {
+        part_start[p] = pos;
+        for (size_t c = 0; c < r->n_chunks; ++c) {
+            size_t n = r->hist[c * r->n_parts + p];
+            r->hist[c * r->n_parts + p] = pos;
+            pos += n;
+        }
+    }
+    part_start[r->n_parts] = pos;
+
+    gc_pool_for(pool, r->n_chunks, 1, psi_join_radix_scatter, r);
+}
+
+typedef struct {
+    const uint8_t        *a;
+    const uint8_t        *b;
+    size_t                elem_bytes;
+    const psi_join_entry *ea;
+    const psi_join_entry *eb;
+    const size_t         *start_a;
+    const size_t         *start_b;
+    psi_join_table       *tables;   // one per worker
+    const psi_join_out   *out;
+} psi_join_parts;
+
+static void psi_join_parts_run(void *ctx, size_t begin, size_t end, size_t worker) {
+    psi_join_parts *j = (psi_join_parts *)ctx;
+    psi_join_table *t = &j->tables[worker];
+    for (size_t p = begin; p < end; ++p) {
+        const psi_join_entry *eb = j->eb + j->start_b[p];
+        const psi_join_entry *ea = j->ea + j->start_a[p];
+        size_t nb = j->start_b[p + 1] - j->start_b[p];
+        size_t na = j->start_a[p + 1] - j->start_a[p];
+
+        if (na < nb) {
+            psi_join_reset(t, na);
+            for (size_t i = 0; i < na; ++i) {
+                psi_join_insert(t, ea[i].h, ea[i].idx);
+            }
+            for (size_t i = 0; i < nb; ++i) {
+                psi_join_mark(t, j->b, eb[i].idx, eb[i].h, j->a, j->elem_bytes, j->out, worker);
+            }
+            continue;
+        }
+        if (nb == 0) {
+            continue;
+        }
+        psi_join_reset(t, nb);
+        for (size_t i = 0; i < nb; ++i) {
+            psi_join_insert(t, eb[i].h, eb[i].idx);
+        }
+        for (size_t i = 0; i < na; ++i) {
+            uint32_t hit = psi_join_probe(t, j->a + (size_t)ea[i].idx * j->elem_bytes,
+                                          ea[i].h, j->b, j->elem_bytes);
+            if (hit != PSI_JOIN_MISS) {
+                psi_join_hit(j->out, ea[i].idx, hit, worker);
+            }
+        }
+    }
+}
+
+static int psi_join_partitioned(
+    const uint8_t      *a,
+    size_t              count_a,
+    const uint8_t      *b,
+    size_t              count_b,
+    size_t              elem_bytes,
+    gc_pool            *pool,
+    const psi_join_out *dst
+) {
+    const size_t n_threads = gc_pool_threads(pool);
+    if (n_threads <= 1 || count_a + count_b < PSI_JOIN_PARALLEL_MIN || count_a == 0) {
+        return psi_join_serial(a, count_a, b, count_b, elem_bytes, dst);
+    }
+    psi_join_out out = *dst;
+    out.shared = 1;
+    psi_join_clear(&out, count_a);
+    int rc = 0;
+
+    const size_t small = (count_a < count_b) ? count_a : count_b;
+    unsigned bits = 0;
+    while (bits < PSI_JOIN_MAX_PART_BITS &&
+           (small >> bits > PSI_JOIN_PART_ELEMS || ((size_t)1 << bits) < 8 * n_threads)) {
+        ++bits;
+    }
+    const size_t n_parts  = (size_t)1 << bits;
+    const size_t n_chunks = 4 * n_threads;
+
+    size_t *hist     = (size_t *)malloc(n_chunks * n_parts * sizeof(size_t));
+    size_t *start_a  = (size_t *)malloc((n_parts + 1) * sizeof(size_t));
+    size_t *start_b  = (size_t *)malloc((n_parts + 1) * sizeof(size_t));
+    psi_join_entry *ea = (psi_join_entry *)malloc(count_a * sizeof(psi_join_entry));
+    psi_join_entry *eb = (psi_join_entry *)malloc(count_b * sizeof(psi_join_entry));
+    psi_join_table *tables = (psi_join_table *)calloc(n_threads, sizeof(psi_join_table));
+    // each worker appends pairs to its own array; worker 0's is the caller's
+    // seeded before any failure can jump to done, which hands pairs[0] back
+    psi_pairs *pairs = dst->pairs ? (psi_pairs *)calloc(n_threads, sizeof(psi_pairs)) : NULL;
+    if (pairs) {
+        pairs[0]  = *dst->pairs;
+        out.pairs = pairs;
+    }
+    if (!hist || !start_a || !start_b || !ea || !eb || !tables || (dst->pairs && !pairs)) {
+        rc = -3;
+        goto done;
+    }
+
+    psi_join_radix r = { b, count_b, elem_bytes, 64u - bits, n_parts, n_chunks, hist, eb };
+    psi_join_radix_run(&r, pool, start_b);
+    r.elems = a;
+    r.count = count_a;
+    r.out   = ea;
+    psi_join_radix_run(&r, pool, start_a);
+
+    // each partition builds on its smaller side
+    size_t largest = 0;
+    for (size_t p = 0; p < n_parts; ++p) {
+        size_t na = start_a[p + 1] - start_a[p], nb = start_b[p + 1] - start_b[p];
+        size_t n = (na < nb) ? na : nb;
+        if (n > largest) {
+            largest = n;
+        }
+    }
+    for (size_t i = 0; i < n_threads; ++i) {
+        if (psi_join_alloc(&tables[i], largest) != 0) {
+            rc = -3;
+            goto done;
+        }
+    }
+
+    psi_join_parts job = { a, b, elem_bytes, ea, eb, start_a, start_b, tables, &out };
+    gc_pool_for(pool, n_parts, 1, psi_join_parts_run, &job);
+    for (size_t i = 1; pairs && i < n_threads; ++i) {
+        if (psi_pairs_append(&pairs[0], &pairs[i]) != 0) {
+            rc = -3;
+        }
+    }
+
+done:
+    if (pairs) {
+        *dst->pairs = pairs[0];
+        for (size_t i = 1; i < n_threads; ++i) {
+            psi_pairs_free(&pairs[i]);
+        }
+        free(pairs);
+    }
+    if (tables) {
+        for (size_t i = 0; i < n_threads; ++i) {
+            psi_join_free(&tables[i]);
+        }
+    }
+    free(tables);
+    free(eb);
+    free(ea);
+    free(start_b);
+    free(start_a);
+    free(hist);
+    return rc;
+}
+
+int psi_join_mask_parallel(
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes,
+    gc_pool       *pool,
+    uint8_t       *out_mask
+) {
+    int rc = psi_join_check(a, count_a, b, count_b, elem_bytes, out_mask);
+    if (rc != 0) {
+        return rc;
+    }
+    psi_join_out out = { .mask = out_mask };
+    return psi_join_partitioned(a, count_a, b, count_b, elem_bytes, pool, &out);
+}
+
+int psi_join_bits(
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes,
+    gc_pool       *pool,
+    uint8_t       *out_bits
+) {
+    int rc = psi_join_check(a, count_a, b, count_b, elem_bytes, out_bits);
+    if (rc != 0) {
+        return rc;
+    }
+    psi_join_out out = { .bits = out_bits };
+    return psi_join_partitioned(a, count_a, b, count_b, elem_bytes, pool, &out);
+}
+
+int psi_join_pairs(
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes,
+    gc_pool       *pool,
+    psi_pairs     *out_pairs
+) {
+    if (!out_pairs) {
+        return -1;
+    }
+    int rc = psi_join_check(a, count_a, b, count_b, elem_bytes, (const uint8_t *)out_pairs);
+    if (rc != 0) {
+        return rc;
+    }
+    psi_pairs_clear(out_pairs);
+    uint8_t *seen = (uint8_t *)malloc((count_a + 7) / 8 + 1);
+    if (!seen) {
+        return -3;
+    }
+
+    int failed = 0;
+    psi_join_out out = { .bits = seen, .pairs = out_pairs, .failed = &failed };
+    rc = psi_join_partitioned(a, count_a, b, count_b, elem_bytes, pool, &out);
+    free(seen);
+    return (rc == 0 && failed) ? -3 : rc;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gc_pool.h"
+#include "psi_pairs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// hash join of two flat arrays of elem_bytes-byte elements: builds an
+// open-addressing table on the smaller side, then streams the larger side
+// past it once. out_mask[i] = 1 iff a[i] occurs in b. expected
+// O(count_a + count_b) time and O(min(count_a, count_b)) memory.
+//
+// the table follows the SwissTable layout: one control byte per slot (a
+// 7-bit tag from the element's hash, or empty) in groups of 16, so a probe
+// compares a whole group of tags at once (SSE2, or 8 bytes at a time in a
+// uint64_t elsewhere) and only touches B for tag matches.
+//
+// returns 0, -1 on bad arguments, -2 if a count does not fit the 32-bit
+// element indices, -3 if the table cannot be allocated.
+int psi_join_mask(
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes,
+    uint8_t       *out_mask
+);
+
+// psi_join_mask spread over pool. both sides are radix-partitioned on the
+// top bits of the element hashes, in parallel over fixed chunks of the
+// input; each pair of partitions is then joined on its own, small enough
+// for its table to stay in cache, and hits land straight in out_mask.
+// falls back to psi_join_mask with one thread or a small B. same returns.
+int psi_join_mask_parallel(
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes,
+    gc_pool       *pool,
+    uint8_t       *out_mask
+);
+
+// psi_join_mask_parallel writing one bit per element of A, bit i of
+// out_bits[i / 8], into (count_a + 7) / 8 bytes. pool may be NULL.
+int psi_join_bits(
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes,
+    gc_pool       *pool,
+    uint8_t       *out_bits
+);
+
+// psi_join_mask_parallel returning pairs instead: out_pairs is cleared,
+// then gets one pair per element of A found in B, as the join finds them
+// (in no particular order), so a small intersection costs no pass over
+// count_a outputs. the pair's element of B is whichever equal one the join
+// met first. pool may be NULL.
+int psi_join_pairs(
+    const uint8_t *a,
+    size_t         count_a,
+    const uint8_t *b,
+    size_t         count_b,
+    size_t         elem_bytes,
+    gc_pool       *pool,
+    psi_pairs     *out_pairs
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+#include "psi_pairs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// first allocation, in pairs; the array doubles from there
+#define PSI_PAIRS_MIN_CAP 64
+
+static int psi_pairs_reserve(psi_pairs *p, size_t n) {
+    if (p->cap - p->len >= n) {
+        return 0;
+    }
+    size_t cap = p->cap ? p->cap : PSI_PAIRS_MIN_CAP;
+    while (cap - p->len < n) {
+        if (cap > SIZE_MAX / 2 / sizeof(psi_pair)) {
+            return -3;
+        }
+        cap *= 2;
+    }
+    psi_pair *items = (psi_pair *)realloc(p->items, cap * sizeof(psi_pair));
+    if (!items) {
+        return -3;
+    }
+    p->items = items;
+    p->cap   = cap;
+    return 0;
+}
+
+int psi_pairs_push(psi_pairs *p, uint32_t a, uint32_t b) {
+    if (psi_pairs_reserve(p, 1) != 0) {
+        return -3;
+    }
+    p->items[p->len].a = a;
+    p->items[p->len].b = b;
+    ++p->len;
+    return 0;
+}
+
+int psi_pairs_append(psi_pairs *dst, const psi_pairs *src) {
+    if (src->len == 0) {
+        return 0;
+    }
+    if (psi_pairs_reserve(dst, src->len) != 0) {
+        return -3;
+    }
+    memcpy(dst->items + dst->len, src->items, src->len * sizeof(psi_pair));
+    dst->len += src->len;
+    return 0;
+}
+
+void psi_pairs_clear(psi_pairs *p) {
+    if (p) {
+        p->len = 0;
+    }
+}
+
+void psi_pairs_free(psi_pairs *p) {
+    if (!p) return;
+    free(p->items);
+    memset(p, 0, sizeof(*p));
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// a sparse intersection: one pair per element of A found in B, with a
+// pair's b indexing an element of B equal to A's element a
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} psi_pair;
+
+// growable array the pairs are appended to as they are found. a
+// zero-initialised psi_pairs is empty; compute calls clear it and keep its
+// capacity, so reusing one across calls stops allocating once it has grown
+// to the largest result.
+typedef struct {
+    psi_pair *items;
+    size_t    len;
+    size_t    cap;
+} psi_pairs;
+
+// returns 0, or -3 if the array cannot grow (the pair is dropped)
+int psi_pairs_push(psi_pairs *p, uint32_t a, uint32_t b);
+
+// appends src's pairs to dst; 0 or -3
+int psi_pairs_append(psi_pairs *dst, const psi_pairs *src);
+
+void psi_pairs_clear(psi_pairs *p);
+
+void psi_pairs_free(psi_pairs *p);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+// circuit fixtures shared by the gc tests and benches
+
+#include <stdlib.h>
+
+#include "gc_core.h"
+
+// k-bit equality as built by psi_gc: XOR per bit, NOT per bit, AND chain.
+// inputs 0..k-1 are one operand, k..2k-1 the other.
+static inline gc_circuit *build_eq_chain(gc_wire_id k) {
+    gc_circuit *c = (gc_circuit *)calloc(1, sizeof(gc_circuit));
+    if (!c) return NULL;
+
+    c->n_inputs  = (gc_wire_id)(2 * k);
+    c->n_outputs = 1;
+    c->n_gates   = 3 * (size_t)k - 1;
+    c->n_wires   = (gc_wire_id)(2 * k + c->n_gates);
+    c->input_wires  = (gc_wire_id *)calloc(c->n_inputs, sizeof(gc_wire_id));
+    c->output_wires = (gc_wire_id *)calloc(1, sizeof(gc_wire_id));
+    c->gates        = (gc_gate *)calloc(c->n_gates, sizeof(gc_gate));
+    if (!c->input_wires || !c->output_wires || !c->gates) {
+        gc_circuit_free(c);
+        return NULL;
+    }
+
+    for (gc_wire_id i = 0; i < c->n_inputs; ++i) {
+        c->input_wires[i] = i;
+    }
+    gc_wire_id w = (gc_wire_id)(2 * k);
+    size_t gi = 0;
+    for (gc_wire_id i = 0; i < k; ++i) {
+        c->gates[gi++] = (gc_gate){ i, (gc_wire_id)(k + i), w, GC_GATE_XOR };
+        c->gates[gi++] = (gc_gate){ w, 0, (gc_wire_id)(w + 1), GC_GATE_NOT };
+        w = (gc_wire_id)(w + 2);
+    }
+    gc_wire_id acc = (gc_wire_id)(2 * k + 1);
+    for (gc_wire_id i = 1; i < k; ++i) {
+        c->gates[gi++] = (gc_gate){ acc, (gc_wire_id)(2 * k + 2 * i + 1), w, GC_GATE_AND };
+        acc = w++;
+    }
+    c->output_wires[0] = acc;
+    return c;
+}
+
+// n_groups independent k-bit equalities with balanced AND trees, one output
+// each: wide levels, as in comparing one element against many
+static inline gc_circuit *build_eq_trees(gc_wire_id n_groups, gc_wire_id k) {
+    gc_circuit *c = (gc_circuit *)calloc(1, sizeof(gc_circuit));
+    if (!c) return NULL;
+
+    const size_t per_group = 2 * (size_t)k + (k - 1);
+    c->n_inputs  = (gc_wire_id)(2 * k * n_groups);
+    c->n_outputs = n_groups;
+    c->n_gates   = per_group * n_groups;
+    c->n_wires   = (gc_wire_id)(c->n_inputs + c->n_gates);
+    c->input_wires  = (gc_wire_id *)calloc(c->n_inputs, sizeof(gc_wire_id));
+    c->output_wires = (gc_wire_id *)calloc(n_groups, sizeof(gc_wire_id));
+    c->gates        = (gc_gate *)calloc(c->n_gates, sizeof(gc_gate));
+    gc_wire_id *layer = (gc_wire_id *)calloc(k, sizeof(gc_wire_id));
+    if (!c->input_wires || !c->output_wires || !c->gates || !layer) {
+        free(layer);
+        gc_circuit_free(c);
+        return NULL;
+    }
+
+    for (gc_wire_id i = 0; i < c->n_inputs; ++i) {
+        c->input_wires[i] = i;
+    }
+    gc_wire_id w = c->n_inputs;
+    size_t gi = 0;
+    for (gc_wire_id g = 0; g < n_groups; ++g) {
+        gc_wire_id a = (gc_wire_id)(2 * k * g);
+        for (gc_wire_id i = 0; i < k; ++i) {
+            c->gates[gi++] = (gc_gate){ (gc_wire_id)(a + i), (gc_wire_id)(a + k + i), w, GC_GATE_XOR };
+            c->gates[gi++] = (gc_gate){ w, 0, (gc_wire_id)(w + 1), GC_GATE_NOT };
+            layer[i] = (gc_wire_id)(w + 1);
+            w = (gc_wire_id)(w + 2);
+        }
+        for (gc_wire_id n = k; n > 1; n = (gc_wire_id)((n + 1) / 2)) {
+            for (gc_wire_id i = 0; i + 1 < n; i += 2) {
+                c->gates[gi++] = (gc_gate){ layer[i], layer[i + 1], w, GC_GATE_AND };
+                layer[i / 2] = w++;
+            }
+            if (n & 1u) {
+                layer[n / 2] = layer[n - 1];
+            }
+        }
+        c->output_wires[g] = layer[0];
+    }
+    free(layer);
+    return c;
+}
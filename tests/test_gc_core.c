@@ -125,11 +125,326 @@ static int test_eq_2bit(void) {
     return 0;
 }
 
+// compares gc_eval_clear_batch against gc_eval_clear on n_vectors pseudo
+// random assignments, n_vectors is deliberately not a multiple of 64 or 512
+static int check_batch_matches(const gc_circuit *c, size_t n_vectors, const char *tag) {
+    const size_t n_words = (n_vectors + 63u) / 64u;
+    uint8_t  *in_bits  = (uint8_t *)malloc(n_vectors * c->n_inputs);
+    uint8_t  *out_ref  = (uint8_t *)malloc(n_vectors * c->n_outputs);
+    uint8_t  *out_bat  = (uint8_t *)malloc(n_vectors * c->n_outputs);
+    uint64_t *in_words = (uint64_t *)malloc(n_words * c->n_inputs * sizeof(uint64_t));
+    uint64_t *out_words = (uint64_t *)malloc(n_words * c->n_outputs * sizeof(uint64_t));
+    int failed = 0;
+
+    if (!in_bits || !out_ref || !out_bat || !in_words || !out_words) {
+        fprintf(stderr, "%s: malloc failed\n", tag);
+        failed = 1;
+        goto done;
+    }
+
+    uint32_t x = 0x12345678u;
+    for (size_t i = 0; i < n_vectors * c->n_inputs; ++i) {
+        x = x * 1103515245u + 12345u;
+        in_bits[i] = (uint8_t)((x >> 16) & 1u);
+    }
+    // make sure the all-equal rows of an equality circuit show up too
+    for (size_t v = 0; v < n_vectors; v += 7) {
+        for (gc_wire_id i = 0; i < c->n_inputs / 2; ++i) {
+            in_bits[v * c->n_inputs + c->n_inputs / 2 + i] = in_bits[v * c->n_inputs + i];
+        }
+    }
+
+    for (size_t v = 0; v < n_vectors; ++v) {
+        if (gc_eval_clear(c, in_bits + v * c->n_inputs, out_ref + v * c->n_outputs) != 0) {
+            fprintf(stderr, "%s: gc_eval_clear failed v=%zu\n", tag, v);
+            failed = 1;
+            goto done;
+        }
+    }
+
+    gc_batch_pack_bits(in_bits, n_vectors, c->n_inputs, in_words);
+    int rc = gc_eval_clear_batch(c, in_words, n_words, out_words);
+    if (rc != 0) {
+        fprintf(stderr, "%s: gc_eval_clear_batch rc=%d\n", tag, rc);
+        failed = 1;
+        goto done;
+    }
+    gc_batch_unpack_bits(out_words, n_vectors, c->n_outputs, out_bat);
+
+    for (size_t i = 0; i < n_vectors * c->n_outputs; ++i) {
+        if (out_bat[i] != out_ref[i]) {
+            fprintf(stderr, "%s: mismatch at vector %zu\n", tag, i / c->n_outputs);
+            failed = 1;
+            break;
+        }
+    }
+
+done:
+    free(in_bits);
+    free(out_ref);
+    free(out_bat);
+    free(in_words);
+    free(out_words);
+    return failed;
+}
+
+static int test_batch_eval(void) {
+    gc_circuit *(*builders[])(void) = {
+        gc_circuit_and_2, gc_circuit_xor_2, gc_circuit_eq_2bit
+    };
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(builders)/sizeof(builders[0]); ++i) {
+        gc_circuit *c = builders[i]();
+        if (!c) {
+            fprintf(stderr, "test_batch_eval: builder %zu returned NULL\n", i);
+            return 1;
+        }
+        if (check_batch_matches(c, 1, "test_batch_eval") != 0 ||
+            check_batch_matches(c, 1000, "test_batch_eval") != 0) {
+            failed = 1;
+        }
+        gc_circuit_free(c);
+    }
+    return failed;
+}
+
+// exhaustive plaintext equivalence of two circuits with the same interface
+static int check_equivalent(const gc_circuit *a, const gc_circuit *b, const char *tag) {
+    uint8_t in[16];
+    uint8_t out_a[16];
+    uint8_t out_b[16];
+
+    if (a->n_inputs != b->n_inputs || a->n_outputs != b->n_outputs ||
+        a->n_inputs > 16 || a->n_outputs > 16) {
+        fprintf(stderr, "%s: interface mismatch\n", tag);
+        return 1;
+    }
+    for (uint32_t v = 0; v < (1u << a->n_inputs); ++v) {
+        for (gc_wire_id i = 0; i < a->n_inputs; ++i) {
+            in[i] = (uint8_t)((v >> i) & 1u);
+        }
+        if (gc_eval_clear(a, in, out_a) != 0 || gc_eval_clear(b, in, out_b) != 0) {
+            fprintf(stderr, "%s: gc_eval_clear failed v=%u\n", tag, v);
+            return 1;
+        }
+        for (gc_wire_id o = 0; o < a->n_outputs; ++o) {
+            if (out_a[o] != out_b[o]) {
+                fprintf(stderr, "%s: output %u differs for v=%u\n", tag, o, v);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_optimize_eq_2bit(void) {
+    gc_circuit *c = gc_circuit_eq_2bit();
+    gc_circuit *opt = NULL;
+    gc_stats before, after;
+
+    if (!c || gc_circuit_optimize(c, &opt, &before, &after) != 0 || !opt) {
+        fprintf(stderr, "optimize_eq_2bit: gc_circuit_optimize failed\n");
+        gc_circuit_free(c);
+        return 1;
+    }
+
+    int failed = check_equivalent(c, opt, "optimize_eq_2bit");
+    // already minimal: 2 XOR, 2 NOT, 1 AND over 9 wires
+    if (after.num_gates != 5 || after.num_and_gates != 1 || after.num_wires != 9 ||
+        before.num_gates != after.num_gates) {
+        fprintf(stderr, "optimize_eq_2bit: unexpected stats gates=%zu and=%zu wires=%zu\n",
+                after.num_gates, after.num_and_gates, after.num_wires);
+        failed = 1;
+    }
+
+    gc_circuit_free(opt);
+    gc_circuit_free(c);
+    return failed;
+}
+
+static int test_optimize_folds(void) {
+    // inputs x0..x2 on wires 0, 1, 5; wire numbers are deliberately sparse
+    gc_gate gates[] = {
+        {  0,  1, 10, GC_GATE_XOR },   // t = x0 ^ x1
+        { 10,  0, 11, GC_GATE_NOT },   // ~t
+        { 11, 11, 12, GC_GATE_AND },   // ~t & ~t        -> ~t
+        { 12,  0, 13, GC_GATE_NOT },   // ~~t            -> t
+        {  1,  0, 14, GC_GATE_XOR },   // x1 ^ x0        -> t (shared)
+        { 13, 14, 15, GC_GATE_XOR },   // t ^ t          -> 0
+        {  5, 15, 16, GC_GATE_AND },   // x2 & 0         -> 0
+        {  5,  5, 17, GC_GATE_AND },   // dead
+        { 16,  0, 18, GC_GATE_NOT },   // ~0             -> 1
+        { 13,  5, 19, GC_GATE_AND },   // t & x2
+        { 14,  5, 20, GC_GATE_AND },   // same as above
+        { 19, 20, 21, GC_GATE_XOR },   // 0 again
+        { 21, 19, 22, GC_GATE_XOR },   // t & x2
+    };
+    gc_wire_id inputs[] = { 0, 1, 5 };
+    gc_wire_id outputs[] = { 12, 18, 22, 16 };
+    gc_circuit c = { 23, 3, 4, inputs, outputs, sizeof(gates)/sizeof(gates[0]), gates };
+
+    gc_circuit *opt = NULL;
+    gc_stats before, after;
+    if (gc_circuit_optimize(&c, &opt, &before, &after) != 0 || !opt) {
+        fprintf(stderr, "optimize_folds: gc_circuit_optimize failed\n");
+        return 1;
+    }
+
+    int failed = check_equivalent(&c, opt, "optimize_folds");
+    // t, ~t, t & x2, plus the constant pair = 5 gates, 1 AND, 3 + 5 wires
+    if (after.num_gates != 5 || after.num_and_gates != 1 || after.num_wires != 8 ||
+        before.num_and_gates != 5 || before.num_wires != 23) {
+        fprintf(stderr, "optimize_folds: unexpected stats gates=%zu and=%zu wires=%zu\n",
+                after.num_gates, after.num_and_gates, after.num_wires);
+        failed = 1;
+    }
+    if (after.num_ciphertexts != 2 || before.num_ciphertexts != 10) {
+        fprintf(stderr, "optimize_folds: ciphertexts before=%zu after=%zu\n",
+                before.num_ciphertexts, after.num_ciphertexts);
+        failed = 1;
+    }
+
+    gc_circuit_free(opt);
+    return failed;
+}
+
+static uint32_t ceil_log2(uint32_t n) {
+    uint32_t l = 0;
+    while ((1u << l) < n) ++l;
+    return l;
+}
+
+static uint32_t count_ands(const gc_circuit *c) {
+    gc_stats st;
+    gc_circuit_stats(c, GC_GARBLE_HALF_GATES, &st);
+    return (uint32_t)st.num_and_gates;
+}
+
+// value of operand j in assignment v, k bits little-endian
+static uint32_t operand(uint32_t v, uint32_t k, uint32_t j) {
+    return (v >> (j * k)) & ((1u << k) - 1u);
+}
+
+static int test_builders(void) {
+    uint8_t in[16];
+    uint8_t out[1];
+
+    for (uint32_t k = 1; k <= 5; ++k) {
+        gc_circuit *eq = gc_circuit_eq((gc_wire_id)k);
+        gc_circuit *gt = gc_circuit_gt((gc_wire_id)k);
+        gc_circuit *lt = gc_circuit_lt((gc_wire_id)k);
+        if (!eq || !gt || !lt) {
+            fprintf(stderr, "builders: k=%u returned NULL\n", k);
+            gc_circuit_free(eq);
+            gc_circuit_free(gt);
+            gc_circuit_free(lt);
+            return 1;
+        }
+
+        int failed = 0;
+        if (count_ands(eq) != k - 1 || count_ands(gt) != 3 * k - 2 - ceil_log2(k) ||
+            count_ands(lt) != count_ands(gt)) {
+            fprintf(stderr, "builders: k=%u AND counts eq=%u gt=%u\n",
+                    k, count_ands(eq), count_ands(gt));
+            failed = 1;
+        }
+
+        for (uint32_t v = 0; v < (1u << (2 * k)) && !failed; ++v) {
+            for (uint32_t i = 0; i < 2 * k; ++i) {
+                in[i] = (uint8_t)((v >> i) & 1u);
+            }
+            uint32_t a = operand(v, k, 0), b = operand(v, k, 1);
+            const gc_circuit *cs[3] = { eq, gt, lt };
+            const uint8_t want[3] = { a == b, a > b, a < b };
+            for (size_t t = 0; t < 3; ++t) {
+                if (gc_eval_clear(cs[t], in, out) != 0 || out[0] != want[t]) {
+                    fprintf(stderr, "builders: k=%u circuit %zu a=%u b=%u got %u\n",
+                            k, t, a, b, out[0]);
+                    failed = 1;
+                }
+            }
+        }
+        gc_circuit_free(eq);
+        gc_circuit_free(gt);
+        gc_circuit_free(lt);
+        if (failed) {
+            return 1;
+        }
+    }
+
+    // membership of a 2-bit a among m 2-bit values, exhaustively
+    const uint32_t k = 2;
+    for (uint32_t m = 1; m <= 4; ++m) {
+        for (int distinct = 0; distinct <= 1; ++distinct) {
+            gc_circuit *c = gc_circuit_member((gc_wire_id)k, (gc_wire_id)m, distinct);
+            if (!c) {
+                fprintf(stderr, "builders: member m=%u returned NULL\n", m);
+                return 1;
+            }
+            uint32_t ands = m * (k - 1) + ((distinct || m == 1) ? 0 : m - 1);
+            if (count_ands(c) != ands) {
+                fprintf(stderr, "builders: member m=%u distinct=%d has %u ANDs, want %u\n",
+                        m, distinct, count_ands(c), ands);
+                gc_circuit_free(c);
+                return 1;
+            }
+
+            const uint32_t n_in = k * (m + 1);
+            for (uint32_t v = 0; v < (1u << n_in); ++v) {
+                uint32_t a = operand(v, k, 0);
+                uint8_t want = 0;
+                int dup = 0;
+                for (uint32_t j = 1; j <= m; ++j) {
+                    for (uint32_t j2 = 1; j2 < j; ++j2) {
+                        dup |= operand(v, k, j) == operand(v, k, j2);
+                    }
+                    want |= (uint8_t)(operand(v, k, j) == a);
+                }
+                if (distinct && dup) {
+                    continue;
+                }
+                for (uint32_t i = 0; i < n_in; ++i) {
+                    in[i] = (uint8_t)((v >> i) & 1u);
+                }
+                if (gc_eval_clear(c, in, out) != 0 || out[0] != want) {
+                    fprintf(stderr, "builders: member m=%u distinct=%d v=%u got %u\n",
+                            m, distinct, v, out[0]);
+                    gc_circuit_free(c);
+                    return 1;
+                }
+            }
+            gc_circuit_free(c);
+        }
+    }
+
+    // balanced trees: a 64-bit equality is XOR/NOT then 6 AND levels
+    gc_circuit *eq64 = gc_circuit_eq(64);
+    gc_levels lv;
+    if (!eq64 || gc_levelize(eq64, &lv) != 0 || lv.n_levels != 2 + 6) {
+        fprintf(stderr, "builders: eq64 is not log depth\n");
+        gc_circuit_free(eq64);
+        return 1;
+    }
+    gc_levels_free(&lv);
+    gc_circuit_free(eq64);
+
+    if (gc_circuit_eq(0) || gc_circuit_gt(0) || gc_circuit_member(4, 0, 0)) {
+        fprintf(stderr, "builders: empty operands accepted\n");
+        return 1;
+    }
+    return 0;
+}
+
 int main(void) {
     int failed = 0;
     if (test_and_2() != 0) failed = 1;
     if (test_xor_2() != 0) failed = 1;
     if (test_eq_2bit() != 0) failed = 1;
+    if (test_batch_eval() != 0) failed = 1;
+    if (test_optimize_eq_2bit() != 0) failed = 1;
+    if (test_optimize_folds() != 0) failed = 1;
+    if (test_builders() != 0) failed = 1;
 
     if (failed) {
         fprintf(stderr, "gc_core tests FAILED\n");
@@ -0,0 +1,157 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "gc_core.h"
+#include "gc_pool.h"
+
+#include "test_circuits.h"
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+typedef struct {
+    const gc_circuit *plain;
+    size_t            n_circuits;
+    int               rc;
+} worker_job;
+
+static void *worker_main(void *arg) {
+    worker_job *job = (worker_job *)arg;
+    for (size_t i = 0; i < job->n_circuits; ++i) {
+        gc_garbled_circuit *gc = NULL;
+        if (gc_garble(job->plain, &gc) != 0) {
+            job->rc = 1;
+            return NULL;
+        }
+        gc_garbled_free(gc);
+    }
+    return NULL;
+}
+
+// garbles n_circuits independent 128-bit equality circuits split evenly
+// over 1, 2, 4, ... threads; scaling should be close to linear up to the
+// number of cores since garblings share no state. then garbles and
+// evaluates one wide circuit with gc_garble_parallel / a gc_pool.
+// usage: test_gc_garble_mt_bench [n_circuits] [max_threads]
+int main(int argc, char **argv) {
+    size_t n_circuits = 4096;
+    if (argc > 1) {
+        n_circuits = (size_t)strtoull(argv[1], NULL, 10);
+    }
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc > 2) {
+        n_cpus = strtol(argv[2], NULL, 10);
+    }
+    if (n_cpus < 1) {
+        n_cpus = 1;
+    }
+
+    gc_circuit *plain = build_eq_chain(128);
+    if (!plain) {
+        fprintf(stderr, "failed to build circuit\n");
+        return 1;
+    }
+
+    printf("Concurrent garbling benchmark (%zu eq128 circuits, up to %ld threads):\n",
+           n_circuits, n_cpus);
+
+    double base = 0.0;
+    for (long t = 1; t <= n_cpus; t *= 2) {
+        pthread_t *th = (pthread_t *)calloc((size_t)t, sizeof(pthread_t));
+        worker_job *jobs = (worker_job *)calloc((size_t)t, sizeof(worker_job));
+        if (!th || !jobs) {
+            free(th);
+            free(jobs);
+            gc_circuit_free(plain);
+            return 1;
+        }
+
+        double t0 = now_ms();
+        for (long i = 0; i < t; ++i) {
+            jobs[i].plain = plain;
+            jobs[i].n_circuits = n_circuits / (size_t)t + ((size_t)i < n_circuits % (size_t)t);
+            pthread_create(&th[i], NULL, worker_main, &jobs[i]);
+        }
+        int rc = 0;
+        for (long i = 0; i < t; ++i) {
+            pthread_join(th[i], NULL);
+            rc |= jobs[i].rc;
+        }
+        double t1 = now_ms();
+
+        double rate = (double)n_circuits / ((t1 - t0) / 1000.0);
+        if (t == 1) {
+            base = rate;
+        }
+        printf("  threads=%-3ld %10.0f circuits/s  speedup %.2fx%s\n",
+               t, rate, rate / base, rc ? "  (garbling failed)" : "");
+
+        free(th);
+        free(jobs);
+    }
+    gc_circuit_free(plain);
+
+    // one wide circuit split across a pool, level by level
+    gc_circuit *wide = build_eq_trees(1024, 128);
+    gc_label *in_labels = wide ? (gc_label *)malloc(wide->n_inputs * sizeof(gc_label)) : NULL;
+    gc_label *out_labels = wide ? (gc_label *)malloc(wide->n_outputs * sizeof(gc_label)) : NULL;
+    gc_evaluator *ev = gc_evaluator_create(0);
+    if (!wide || !in_labels || !out_labels || !ev) {
+        fprintf(stderr, "failed to build wide circuit\n");
+        return 1;
+    }
+    printf("Level-parallel garble/eval (1024 x eq128, %zu gates):\n", wide->n_gates);
+
+    double base_g = 0.0, base_e = 0.0;
+    for (long t = 1; t <= n_cpus; t *= 2) {
+        gc_pool *pool = gc_pool_create((size_t)t);
+        gc_garbled_circuit *gc = NULL;
+        gc_levels lv;
+
+        double t0 = now_ms();
+        int rc = gc_garble_parallel(wide, GC_GARBLE_HALF_GATES, NULL, pool, &gc);
+        double t1 = now_ms();
+        if (rc != 0 || gc_levelize_garbled(gc, &lv) != 0) {
+            fprintf(stderr, "garbling failed\n");
+            gc_garbled_free(gc);
+            gc_pool_destroy(pool);
+            break;
+        }
+        for (gc_wire_id i = 0; i < wide->n_inputs; ++i) {
+            in_labels[i] = gc->wire_labels0[gc->input_wires[i]];
+        }
+        double t2 = now_ms();
+        rc = gc_evaluator_eval_parallel(ev, gc, &lv, pool, in_labels, out_labels);
+        double t3 = now_ms();
+
+        double g_rate = (double)wide->n_gates / ((t1 - t0) / 1000.0);
+        double e_rate = (double)wide->n_gates / ((t3 - t2) / 1000.0);
+        if (t == 1) {
+            base_g = g_rate;
+            base_e = e_rate;
+        }
+        printf("  threads=%-3ld garble %10.0f gates/s (%.2fx)  eval %10.0f gates/s (%.2fx)%s\n",
+               t, g_rate, g_rate / base_g, e_rate, e_rate / base_e,
+               rc ? "  (eval failed)" : "");
+
+        gc_levels_free(&lv);
+        gc_garbled_free(gc);
+        gc_pool_destroy(pool);
+    }
+
+    gc_evaluator_destroy(ev);
+    free(out_labels);
+    free(in_labels);
+    gc_circuit_free(wide);
+    return 0;
+}
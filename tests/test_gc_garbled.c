@@ -1,9 +1,59 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "gc_core.h"
 
+#include "test_circuits.h"
+
+// evaluates gc on every input assignment and compares against gc_eval_clear
+static int check_garbled_exhaustive(
+    const gc_circuit         *plain,
+    const gc_garbled_circuit *gc,
+    const char               *tag
+) {
+    uint8_t in_bits[16];
+    uint8_t out_bits_clear[16];
+    uint8_t out_bits_garbled[16];
+    gc_label in_labels[16];
+    gc_label out_labels[16];
+
+    if (plain->n_inputs > 16 || plain->n_outputs > 16) {
+        fprintf(stderr, "%s: circuit too wide for exhaustive check\n", tag);
+        return 1;
+    }
+
+    for (uint32_t v = 0; v < (1u << plain->n_inputs); ++v) {
+        for (gc_wire_id j = 0; j < plain->n_inputs; ++j) {
+            in_bits[j] = (uint8_t)((v >> j) & 1u);
+            gc_wire_id w = gc->input_wires[j];
+            in_labels[j] = in_bits[j] ? gc->wire_labels1[w] : gc->wire_labels0[w];
+        }
+
+        if (gc_eval_clear(plain, in_bits, out_bits_clear) != 0) {
+            fprintf(stderr, "%s: gc_eval_clear failed v=%u\n", tag, v);
+            return 1;
+        }
+        if (gc_eval_garbled(gc, in_labels, out_labels) != 0) {
+            fprintf(stderr, "%s: gc_eval_garbled failed v=%u\n", tag, v);
+            return 1;
+        }
+        if (gc_decode_outputs(gc, out_labels, out_bits_garbled) != 0) {
+            fprintf(stderr, "%s: gc_decode_outputs failed v=%u\n", tag, v);
+            return 1;
+        }
+        for (gc_wire_id j = 0; j < plain->n_outputs; ++j) {
+            if (out_bits_garbled[j] != out_bits_clear[j]) {
+                fprintf(stderr, "%s: mismatch v=%u out=%u: gc=%u, clear=%u\n",
+                        tag, v, j, out_bits_garbled[j], out_bits_clear[j]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
 static int test_garbled_and_2(void) {
     gc_circuit *plain = gc_circuit_and_2();
     if (!plain) {
@@ -44,8 +94,8 @@ static int test_garbled_and_2(void) {
 
         // we gotta build input labels
         // use wire_labels0/1 according to input bits
-        for (uint16_t j = 0; j < gc->n_inputs; ++j) {
-            uint16_t w = gc->input_wires[j];
+        for (gc_wire_id j = 0; j < gc->n_inputs; ++j) {
+            gc_wire_id w = gc->input_wires[j];
             uint8_t bit = in_bits[j] & 1u;
             in_labels[j] = (bit == 0)
                 ? gc->wire_labels0[w]
@@ -117,8 +167,8 @@ static int test_garbled_xor_2(void) {
             return 1;
         }
 
-        for (uint16_t j = 0; j < gc->n_inputs; ++j) {
-            uint16_t w = gc->input_wires[j];
+        for (gc_wire_id j = 0; j < gc->n_inputs; ++j) {
+            gc_wire_id w = gc->input_wires[j];
             uint8_t bit = in_bits[j] & 1u;
             in_labels[j] = (bit == 0)
                 ? gc->wire_labels0[w]
@@ -187,8 +237,8 @@ static int test_garbled_eq_2bit(void) {
                 return 1;
             }
 
-            for (uint16_t j = 0; j < gc->n_inputs; ++j) {
-                uint16_t w = gc->input_wires[j];
+            for (gc_wire_id j = 0; j < gc->n_inputs; ++j) {
+                gc_wire_id w = gc->input_wires[j];
                 uint8_t bit = in_bits[j] & 1u;
                 in_labels[j] = (bit == 0)
                     ? gc->wire_labels0[w]
@@ -244,8 +294,8 @@ static int test_stats_eq_2bit(void) {
         st.num_xor_gates != 2 ||
         st.num_not_gates != 2 ||
         st.num_and_gates != 1 ||
-        st.num_ciphertexts != 12 ||
-        st.ciphertext_bytes != 12 * GC_LABEL_BYTES) {
+        st.num_ciphertexts != 2 ||
+        st.ciphertext_bytes != 2 * GC_LABEL_BYTES) {
         fprintf(stderr, "stats_eq_2bit: unexpected stats: " 
             "gates=%zu (AND=%zu,XOR=%zu,NOT=%zu) ciphertexts=%zu bytes=%zu\n", 
             st.num_gates, st.num_and_gates, st.num_xor_gates, st.num_not_gates, st.num_ciphertexts, st.ciphertext_bytes);
@@ -259,12 +309,565 @@ static int test_stats_eq_2bit(void) {
     return 0;
 }
 
+static int test_classic_mode(void) {
+    gc_circuit *(*builders[])(void) = {
+        gc_circuit_and_2, gc_circuit_xor_2, gc_circuit_eq_2bit
+    };
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(builders)/sizeof(builders[0]) && !failed; ++i) {
+        gc_circuit *plain = builders[i]();
+        gc_garbled_circuit *gc = NULL;
+        if (!plain || gc_garble_with_mode(plain, GC_GARBLE_CLASSIC, &gc) != 0 || !gc) {
+            fprintf(stderr, "classic_mode: setup failed for circuit %zu\n", i);
+            gc_circuit_free(plain);
+            return 1;
+        }
+        if (check_garbled_exhaustive(plain, gc, "classic_mode") != 0) {
+            failed = 1;
+        }
+
+        if (builders[i] == gc_circuit_eq_2bit) {
+            gc_stats st;
+            gc_compute_stats(gc, &st);
+            if (st.num_ciphertexts != 4 || st.ciphertext_bytes != 4 * GC_LABEL_BYTES) {
+                fprintf(stderr, "classic_mode: eq_2bit ciphertexts=%zu, expected 4\n",
+                        st.num_ciphertexts);
+                failed = 1;
+            }
+        }
+
+        gc_garbled_free(gc);
+        gc_circuit_free(plain);
+    }
+    return failed;
+}
+
+static int test_half_gates_and_chain(void) {
+    // x0 & x1 & x2 & (x0 ^ x3), with ANDs feeding ANDs and XORs
+    gc_gate gates[] = {
+        { 0, 1, 4, GC_GATE_AND },
+        { 4, 2, 5, GC_GATE_AND },
+        { 0, 3, 6, GC_GATE_XOR },
+        { 5, 6, 7, GC_GATE_AND },
+    };
+    gc_wire_id inputs[] = { 0, 1, 2, 3 };
+    gc_wire_id outputs[] = { 5, 7 };
+    gc_circuit plain = { 8, 4, 2, inputs, outputs, 4, gates };
+
+    gc_garbled_circuit *gc = NULL;
+    if (gc_garble_with_mode(&plain, GC_GARBLE_HALF_GATES, &gc) != 0 || !gc) {
+        fprintf(stderr, "half_gates_and_chain: gc_garble failed\n");
+        return 1;
+    }
+    int failed = check_garbled_exhaustive(&plain, gc, "half_gates_and_chain");
+    gc_garbled_free(gc);
+    return failed;
+}
+
+static int test_free_not(void) {
+    // NOT(NOT(x0)) & NOT(x1), output also taps the inner NOT
+    gc_gate gates[] = {
+        { 0, 0, 2, GC_GATE_NOT },
+        { 2, 0, 3, GC_GATE_NOT },
+        { 1, 0, 4, GC_GATE_NOT },
+        { 3, 4, 5, GC_GATE_AND },
+    };
+    gc_wire_id inputs[] = { 0, 1 };
+    gc_wire_id outputs[] = { 5, 2 };
+    gc_circuit plain = { 6, 2, 2, inputs, outputs, 4, gates };
+
+    gc_garble_mode modes[] = { GC_GARBLE_CLASSIC, GC_GARBLE_HALF_GATES };
+    for (size_t m = 0; m < 2; ++m) {
+        gc_garbled_circuit *gc = NULL;
+        if (gc_garble_with_mode(&plain, modes[m], &gc) != 0 || !gc) {
+            fprintf(stderr, "free_not: gc_garble failed mode=%zu\n", m);
+            return 1;
+        }
+        int failed = check_garbled_exhaustive(&plain, gc, "free_not");
+
+        gc_stats st;
+        gc_compute_stats(gc, &st);
+        size_t expected = (modes[m] == GC_GARBLE_HALF_GATES) ? 2u : 4u;
+        if (st.num_not_gates != 3 || st.num_ciphertexts != expected) {
+            fprintf(stderr, "free_not: NOT=%zu ciphertexts=%zu, expected 3 and %zu\n",
+                    st.num_not_gates, st.num_ciphertexts, expected);
+            failed = 1;
+        }
+
+        gc_garbled_free(gc);
+        if (failed) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ~1M gates over well over 65,535 wires, checked against gc_eval_clear on
+// a handful of random input vectors
+static int test_wide_circuit(void) {
+    const gc_wire_id n_inputs = 64;
+    const size_t n_gates = (size_t)1 << 20;
+    const gc_wire_id n_outputs = 32;
+
+    gc_circuit c;
+    c.n_wires = (gc_wire_id)(n_inputs + n_gates);
+    c.n_inputs = n_inputs;
+    c.n_outputs = n_outputs;
+    c.n_gates = n_gates;
+    c.input_wires = (gc_wire_id *)malloc(n_inputs * sizeof(gc_wire_id));
+    c.output_wires = (gc_wire_id *)malloc(n_outputs * sizeof(gc_wire_id));
+    c.gates = (gc_gate *)malloc(n_gates * sizeof(gc_gate));
+
+    gc_label *in_labels = (gc_label *)malloc(n_inputs * sizeof(gc_label));
+    gc_label out_labels[32];
+    uint8_t in_bits[64];
+    uint8_t out_clear[32];
+    uint8_t out_garbled[32];
+    gc_garbled_circuit *gc = NULL;
+    int failed = 0;
+
+    if (!c.input_wires || !c.output_wires || !c.gates || !in_labels) {
+        fprintf(stderr, "wide_circuit: malloc failed\n");
+        failed = 1;
+        goto done;
+    }
+
+    for (gc_wire_id i = 0; i < n_inputs; ++i) {
+        c.input_wires[i] = i;
+    }
+    // each gate reads one recent wire and one random earlier wire, so the
+    // values stay mixed and long-range wire indices are exercised
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    for (size_t gi = 0; gi < n_gates; ++gi) {
+        gc_wire_id out = (gc_wire_id)(n_inputs + gi);
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        gc_gate *g = &c.gates[gi];
+        g->in0 = (gc_wire_id)(out - 1 - (x % 8 < out ? x % 8 : 0));
+        g->in1 = (gc_wire_id)((x >> 8) % out);
+        g->out = out;
+        g->type = (gi % 3 == 0) ? GC_GATE_AND : ((gi % 7 == 0) ? GC_GATE_NOT : GC_GATE_XOR);
+    }
+    for (gc_wire_id i = 0; i < n_outputs; ++i) {
+        c.output_wires[i] = (gc_wire_id)(c.n_wires - 1 - 1000 * i);
+    }
+
+    if (gc_garble(&c, &gc) != 0 || !gc) {
+        fprintf(stderr, "wide_circuit: gc_garble failed\n");
+        failed = 1;
+        goto done;
+    }
+
+    gc_stats st;
+    gc_compute_stats(gc, &st);
+    if (st.num_gates != n_gates || st.num_wires != c.n_wires ||
+        st.num_ciphertexts != 2 * st.num_and_gates) {
+        fprintf(stderr, "wide_circuit: unexpected stats gates=%zu wires=%zu\n",
+                st.num_gates, st.num_wires);
+        failed = 1;
+        goto done;
+    }
+
+    for (int trial = 0; trial < 4 && !failed; ++trial) {
+        for (gc_wire_id i = 0; i < n_inputs; ++i) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            in_bits[i] = (uint8_t)(x & 1u);
+            in_labels[i] = in_bits[i] ? gc->wire_labels1[i] : gc->wire_labels0[i];
+        }
+        if (gc_eval_clear(&c, in_bits, out_clear) != 0 ||
+            gc_eval_garbled(gc, in_labels, out_labels) != 0 ||
+            gc_decode_outputs(gc, out_labels, out_garbled) != 0) {
+            fprintf(stderr, "wide_circuit: evaluation failed trial %d\n", trial);
+            failed = 1;
+            break;
+        }
+        for (gc_wire_id o = 0; o < n_outputs; ++o) {
+            if (out_clear[o] != out_garbled[o]) {
+                fprintf(stderr, "wide_circuit: mismatch trial %d output %u\n", trial, o);
+                failed = 1;
+                break;
+            }
+        }
+    }
+
+done:
+    gc_garbled_free(gc);
+    free(c.input_wires);
+    free(c.output_wires);
+    free(c.gates);
+    free(in_labels);
+    return failed;
+}
+
+static int check_packed_exhaustive(
+    const gc_circuit         *plain,
+    const gc_garbled_circuit *gc,
+    const gc_packed_circuit  *pc,
+    const char               *tag
+) {
+    uint8_t in_bits[16];
+    uint8_t out_clear[16];
+    uint8_t out_packed[16];
+    gc_label in_labels[16];
+    gc_label out_labels[16];
+
+    for (uint32_t v = 0; v < (1u << plain->n_inputs); ++v) {
+        for (gc_wire_id j = 0; j < plain->n_inputs; ++j) {
+            in_bits[j] = (uint8_t)((v >> j) & 1u);
+            gc_wire_id w = gc->input_wires[j];
+            in_labels[j] = in_bits[j] ? gc->wire_labels1[w] : gc->wire_labels0[w];
+        }
+        if (gc_eval_clear(plain, in_bits, out_clear) != 0 ||
+            gc_eval_packed(pc, in_labels, out_labels) != 0 ||
+            gc_packed_decode_outputs(pc, out_labels, out_packed) != 0) {
+            fprintf(stderr, "%s: evaluation failed v=%u\n", tag, v);
+            return 1;
+        }
+        for (gc_wire_id j = 0; j < plain->n_outputs; ++j) {
+            if (out_packed[j] != out_clear[j]) {
+                fprintf(stderr, "%s: mismatch v=%u\n", tag, v);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_packed_layout(void) {
+    gc_garble_mode modes[] = { GC_GARBLE_CLASSIC, GC_GARBLE_HALF_GATES };
+    int failed = 0;
+
+    for (size_t m = 0; m < 2 && !failed; ++m) {
+        gc_circuit *plain = gc_circuit_eq_2bit();
+        gc_garbled_circuit *gc = NULL;
+        gc_packed_circuit *pc = NULL;
+        if (!plain || gc_garble_with_mode(plain, modes[m], &gc) != 0 ||
+            gc_pack_garbled(gc, &pc) != 0) {
+            fprintf(stderr, "packed_layout: setup failed mode=%zu\n", m);
+            failed = 1;
+        } else {
+            failed = check_packed_exhaustive(plain, gc, pc, "packed_layout");
+            if (pc->n_ciphertexts != (modes[m] == GC_GARBLE_HALF_GATES ? 2u : 4u)) {
+                fprintf(stderr, "packed_layout: n_ciphertexts=%zu\n", pc->n_ciphertexts);
+                failed = 1;
+            }
+        }
+        gc_packed_free(pc);
+        gc_garbled_free(gc);
+        gc_circuit_free(plain);
+    }
+    return failed;
+}
+
+// footprint of the 128-bit equality circuit in both layouts, plus a spot
+// check that the packed form agrees on equal and unequal inputs
+static int test_packed_footprint_eq128(void) {
+    const gc_wire_id k = 128;
+    gc_circuit *plain = build_eq_chain(k);
+    gc_garbled_circuit *gc = NULL;
+    gc_packed_circuit *pc = NULL;
+    gc_label *in_labels = (gc_label *)malloc(2 * k * sizeof(gc_label));
+    int failed = 0;
+
+    if (!plain || !in_labels || gc_garble(plain, &gc) != 0 || gc_pack_garbled(gc, &pc) != 0) {
+        fprintf(stderr, "packed_footprint_eq128: setup failed\n");
+        failed = 1;
+        goto done;
+    }
+
+    size_t full = gc_garbled_bytes(gc);
+    size_t packed = gc_packed_bytes(pc);
+    printf("eq128 footprint: gc_garbled_circuit=%zu bytes, gc_packed_circuit=%zu bytes (%.1f%%)\n",
+           full, packed, 100.0 * (double)packed / (double)full);
+    if (packed * 3 > full) {
+        fprintf(stderr, "packed_footprint_eq128: packed layout not at least 3x smaller\n");
+        failed = 1;
+    }
+
+    for (int equal = 0; equal < 2 && !failed; ++equal) {
+        for (gc_wire_id i = 0; i < k; ++i) {
+            uint8_t a = (uint8_t)((i * 37u) & 1u);
+            uint8_t b = (equal || i != 77) ? a : (uint8_t)(a ^ 1u);
+            in_labels[i]     = a ? gc->wire_labels1[i] : gc->wire_labels0[i];
+            in_labels[k + i] = b ? gc->wire_labels1[k + i] : gc->wire_labels0[k + i];
+        }
+        gc_label out_label;
+        uint8_t bit = 0xff;
+        if (gc_eval_packed(pc, in_labels, &out_label) != 0 ||
+            gc_packed_decode_outputs(pc, &out_label, &bit) != 0 || bit != (uint8_t)equal) {
+            fprintf(stderr, "packed_footprint_eq128: wrong result for equal=%d\n", equal);
+            failed = 1;
+        }
+    }
+
+done:
+    free(in_labels);
+    gc_packed_free(pc);
+    gc_garbled_free(gc);
+    gc_circuit_free(plain);
+    return failed;
+}
+
+// one evaluator across circuits of different sizes and both layouts, with
+// the buffer growing and being wiped in between
+static int test_evaluator_reuse(void) {
+    gc_circuit *small = gc_circuit_eq_2bit();
+    gc_circuit *big = build_eq_chain(64);
+    gc_garbled_circuit *gs = NULL, *gb = NULL;
+    gc_packed_circuit *pb = NULL;
+    gc_evaluator *ev = gc_evaluator_create(0);
+    gc_label in_labels[128];
+    int failed = 0;
+
+    if (!small || !big || !ev || gc_garble(small, &gs) != 0 || gc_garble(big, &gb) != 0 ||
+        gc_pack_garbled(gb, &pb) != 0) {
+        fprintf(stderr, "evaluator_reuse: setup failed\n");
+        failed = 1;
+        goto done;
+    }
+
+    for (int round = 0; round < 3 && !failed; ++round) {
+        for (uint32_t v = 0; v < 16 && !failed; ++v) {
+            uint8_t bits[4], expect, got;
+            gc_label out;
+            for (gc_wire_id j = 0; j < 4; ++j) {
+                bits[j] = (uint8_t)((v >> j) & 1u);
+                gc_wire_id w = gs->input_wires[j];
+                in_labels[j] = bits[j] ? gs->wire_labels1[w] : gs->wire_labels0[w];
+            }
+            if (gc_eval_clear(small, bits, &expect) != 0 ||
+                gc_evaluator_eval(ev, gs, in_labels, &out) != 0 ||
+                gc_decode_outputs(gs, &out, &got) != 0 || got != expect) {
+                fprintf(stderr, "evaluator_reuse: eq_2bit mismatch v=%u\n", v);
+                failed = 1;
+            }
+        }
+
+        for (int equal = 0; equal < 2 && !failed; ++equal) {
+            for (gc_wire_id i = 0; i < 64; ++i) {
+                uint8_t a = (uint8_t)((i * 13u) & 1u);
+                uint8_t b = (equal || i != 9) ? a : (uint8_t)(a ^ 1u);
+                in_labels[i]      = a ? gb->wire_labels1[i] : gb->wire_labels0[i];
+                in_labels[64 + i] = b ? gb->wire_labels1[64 + i] : gb->wire_labels0[64 + i];
+            }
+            gc_label out_full, out_packed;
+            uint8_t bit_full = 0xff, bit_packed = 0xff;
+            if (gc_evaluator_eval(ev, gb, in_labels, &out_full) != 0 ||
+                gc_evaluator_eval_packed(ev, pb, in_labels, &out_packed) != 0 ||
+                gc_decode_outputs(gb, &out_full, &bit_full) != 0 ||
+                gc_packed_decode_outputs(pb, &out_packed, &bit_packed) != 0 ||
+                bit_full != (uint8_t)equal || bit_packed != (uint8_t)equal) {
+                fprintf(stderr, "evaluator_reuse: eq64 wrong result round=%d\n", round);
+                failed = 1;
+            }
+
+            // the same inputs as two spans, split unevenly
+            gc_label out_spans;
+            if (gc_evaluator_eval_spans(ev, gb, in_labels, 37, in_labels + 37, &out_spans) != 0 ||
+                memcmp(out_spans.b, out_full.b, GC_LABEL_BYTES) != 0) {
+                fprintf(stderr, "evaluator_reuse: spans differ round=%d\n", round);
+                failed = 1;
+            }
+        }
+        gc_evaluator_wipe(ev);
+    }
+
+done:
+    gc_evaluator_destroy(ev);
+    gc_packed_free(pb);
+    gc_garbled_free(gb);
+    gc_garbled_free(gs);
+    gc_circuit_free(big);
+    gc_circuit_free(small);
+    return failed;
+}
+
+typedef struct {
+    gc_label *buf;
+    size_t    n;
+    size_t    cap;
+    size_t    max_call;
+    size_t    calls_left;   // sink fails once this hits zero
+} stream_collector;
+
+static int collect_tables(void *user, const gc_label *ct, size_t n_ct) {
+    stream_collector *sc = (stream_collector *)user;
+    if (sc->calls_left == 0) {
+        return 1;
+    }
+    --sc->calls_left;
+    if (sc->n + n_ct > sc->cap) {
+        return 1;
+    }
+    memcpy(sc->buf + sc->n, ct, n_ct * sizeof(gc_label));
+    sc->n += n_ct;
+    if (n_ct > sc->max_call) {
+        sc->max_call = n_ct;
+    }
+    return 0;
+}
+
+// from the same seed, the streamed tables and labels must be exactly what
+// gc_garble_seeded + pack give
+static int test_stream_garble(void) {
+    gc_garble_mode modes[] = { GC_GARBLE_CLASSIC, GC_GARBLE_HALF_GATES };
+    const gc_wire_id k = 128;
+    uint8_t seed[GC_GARBLE_SEED_BYTES];
+    for (size_t i = 0; i < sizeof(seed); ++i) {
+        seed[i] = (uint8_t)(0x5a ^ i);
+    }
+    int failed = 0;
+
+    for (size_t m = 0; m < 2 && !failed; ++m) {
+        gc_circuit *plain = build_eq_chain(k);
+        gc_garbled_circuit *gc = NULL;
+        gc_packed_circuit *pc = NULL;
+        stream_collector sc = { 0 };
+        gc_label *in0 = (gc_label *)malloc(2 * k * sizeof(gc_label));
+        gc_label out0, delta;
+        gc_stream_stats st;
+
+        if (!plain || !in0 || gc_garble_seeded(plain, modes[m], seed, &gc) != 0 ||
+            gc_pack_garbled(gc, &pc) != 0) {
+            fprintf(stderr, "stream_garble: setup failed mode=%zu\n", m);
+            failed = 1;
+            goto next;
+        }
+        sc.cap = pc->n_ciphertexts;
+        sc.buf = (gc_label *)malloc(sc.cap * sizeof(gc_label));
+        sc.calls_left = SIZE_MAX;
+
+        // 7 labels: not a multiple of either table size
+        if (!sc.buf || gc_garble_stream(plain, modes[m], seed, 7, collect_tables, &sc,
+                                        in0, &out0, &delta, &st) != 0) {
+            fprintf(stderr, "stream_garble: gc_garble_stream failed mode=%zu\n", m);
+            failed = 1;
+            goto next;
+        }
+        if (sc.n != pc->n_ciphertexts ||
+            memcmp(sc.buf, pc->ciphertexts, sc.n * sizeof(gc_label)) != 0) {
+            fprintf(stderr, "stream_garble: table stream differs mode=%zu\n", m);
+            failed = 1;
+        }
+        size_t per_gate = (modes[m] == GC_GARBLE_HALF_GATES) ? 2u : 4u;
+        if (sc.max_call != st.chunk_labels || st.chunk_labels % per_gate != 0) {
+            fprintf(stderr, "stream_garble: chunk of %zu labels\n", sc.max_call);
+            failed = 1;
+        }
+        for (gc_wire_id i = 0; i < 2 * k; ++i) {
+            if (memcmp(&in0[i], &gc->wire_labels0[gc->input_wires[i]], sizeof(gc_label)) != 0) {
+                fprintf(stderr, "stream_garble: input label %u differs\n", (unsigned)i);
+                failed = 1;
+                break;
+            }
+        }
+        gc_label d;
+        for (size_t i = 0; i < GC_LABEL_BYTES; ++i) {
+            d.b[i] = (uint8_t)(gc->wire_labels0[0].b[i] ^ gc->wire_labels1[0].b[i]);
+        }
+        if (memcmp(&out0, &pc->output_labels0[0], sizeof(gc_label)) != 0 ||
+            memcmp(&delta, &d, sizeof(gc_label)) != 0) {
+            fprintf(stderr, "stream_garble: output label or delta differs\n");
+            failed = 1;
+        }
+        printf("stream eq128 mode=%zu: %zu ciphertexts in %zu chunks, peak %zu live labels of %u wires\n",
+               m, st.num_ciphertexts, st.n_chunks, st.peak_live_labels, (unsigned)plain->n_wires);
+        if (st.peak_live_labels * 2 > plain->n_wires) {
+            fprintf(stderr, "stream_garble: peak live labels not bounded\n");
+            failed = 1;
+        }
+
+        // a failing sink aborts the garbling
+        sc.n = 0;
+        sc.calls_left = 1;
+        if (gc_garble_stream(plain, modes[m], NULL, 8, collect_tables, &sc,
+                             in0, &out0, &delta, NULL) == 0) {
+            fprintf(stderr, "stream_garble: sink failure not reported\n");
+            failed = 1;
+        }
+
+    next:
+        free(sc.buf);
+        free(in0);
+        gc_packed_free(pc);
+        gc_garbled_free(gc);
+        gc_circuit_free(plain);
+    }
+    return failed;
+}
+
+static int label_eq(const gc_label *a, const gc_label *b) {
+    return memcmp(a, b, sizeof(gc_label)) == 0;
+}
+
+// fresh garblings get independent delta and labels, a fixed seed
+// reproduces a garbling, and permute bits are not tied to plaintext values
+static int test_garble_randomness(void) {
+    gc_circuit *plain = build_eq_chain(64);
+    gc_garbled_circuit *g1 = NULL, *g2 = NULL, *s1 = NULL, *s2 = NULL;
+    uint8_t seed[GC_GARBLE_SEED_BYTES] = { 1, 2, 3 };
+    int failed = 0;
+
+    if (!plain || gc_garble(plain, &g1) != 0 || gc_garble(plain, &g2) != 0 ||
+        gc_garble_seeded(plain, GC_GARBLE_HALF_GATES, seed, &s1) != 0 ||
+        gc_garble_seeded(plain, GC_GARBLE_HALF_GATES, seed, &s2) != 0) {
+        fprintf(stderr, "garble_randomness: setup failed\n");
+        failed = 1;
+        goto done;
+    }
+
+    gc_label d1, d2;
+    for (size_t i = 0; i < GC_LABEL_BYTES; ++i) {
+        d1.b[i] = (uint8_t)(g1->wire_labels0[0].b[i] ^ g1->wire_labels1[0].b[i]);
+        d2.b[i] = (uint8_t)(g2->wire_labels0[0].b[i] ^ g2->wire_labels1[0].b[i]);
+    }
+    if (label_eq(&d1, &d2) || label_eq(&g1->wire_labels0[0], &g2->wire_labels0[0])) {
+        fprintf(stderr, "garble_randomness: two garblings share delta or labels\n");
+        failed = 1;
+    }
+
+    for (gc_wire_id w = 0; w < plain->n_wires; ++w) {
+        if (!label_eq(&s1->wire_labels0[w], &s2->wire_labels0[w]) ||
+            !label_eq(&s1->wire_labels1[w], &s2->wire_labels1[w])) {
+            fprintf(stderr, "garble_randomness: seeded garbling not reproducible\n");
+            failed = 1;
+            break;
+        }
+    }
+
+    unsigned ones = 0;
+    for (gc_wire_id i = 0; i < plain->n_inputs; ++i) {
+        ones += g1->wire_labels0[g1->input_wires[i]].b[0] & 1u;
+    }
+    if (ones == 0 || ones == plain->n_inputs) {
+        fprintf(stderr, "garble_randomness: permute bits of L0 are constant\n");
+        failed = 1;
+    }
+
+done:
+    gc_garbled_free(s2);
+    gc_garbled_free(s1);
+    gc_garbled_free(g2);
+    gc_garbled_free(g1);
+    gc_circuit_free(plain);
+    return failed;
+}
+
 int main(void) {
     int failed = 0;
     if (test_garbled_and_2() != 0) failed = 1;
     if (test_garbled_xor_2() != 0) failed = 1;
     if (test_garbled_eq_2bit() != 0) failed = 1;
     if (test_stats_eq_2bit() != 0) failed = 1;
+    if (test_classic_mode() != 0) failed = 1;
+    if (test_half_gates_and_chain() != 0) failed = 1;
+    if (test_free_not() != 0) failed = 1;
+    if (test_wide_circuit() != 0) failed = 1;
+    if (test_packed_layout() != 0) failed = 1;
+    if (test_packed_footprint_eq128() != 0) failed = 1;
+    if (test_stream_garble() != 0) failed = 1;
+    if (test_evaluator_reuse() != 0) failed = 1;
+    if (test_garble_randomness() != 0) failed = 1;
 
     if (failed) {
         fprintf(stderr, "gc_garbled tests FAILED\n");
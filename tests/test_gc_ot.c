@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+#include <signal.h>
+
+#include "gc_channel.h"
+#include "gc_ot.h"
+
+static uint64_t rng_next(uint64_t *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+static void fill_labels(gc_label *l, size_t n, uint64_t seed) {
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < GC_LABEL_BYTES; j += 8) {
+            uint64_t v = rng_next(&seed);
+            memcpy(l[i].b + j, &v, 8);
+        }
+    }
+}
+
+static uint8_t get_bit(const uint8_t *bits, size_t i) {
+    return (bits[i / 8] >> (i % 8)) & 1u;
+}
+
+// base OTs: the sender runs on its own thread
+
+typedef struct {
+    gc_channel *ch;
+    size_t      n;
+    gc_label   *out0;
+    gc_label   *out1;
+    int         rc;
+} base_sender_job;
+
+static void *base_sender_main(void *arg) {
+    base_sender_job *job = (base_sender_job *)arg;
+    job->rc = gc_base_ot_send(job->ch, job->n, job->out0, job->out1);
+    return NULL;
+}
+
+static int test_base_ot(void) {
+    const size_t n = 200;
+    gc_channel a, b;
+    gc_label *out0 = (gc_label *)malloc(n * sizeof(gc_label));
+    gc_label *out1 = (gc_label *)malloc(n * sizeof(gc_label));
+    gc_label *out = (gc_label *)malloc(n * sizeof(gc_label));
+    uint8_t choices[25];
+    int failed = 0;
+
+    if (!out0 || !out1 || !out || gc_channel_mem_pair(&a, &b, 0) != 0) {
+        fprintf(stderr, "base_ot: setup failed\n");
+        free(out0);
+        free(out1);
+        free(out);
+        return 1;
+    }
+    uint64_t seed = 0x9e3779b97f4a7c15ull;
+    for (size_t i = 0; i < sizeof(choices); ++i) {
+        choices[i] = (uint8_t)rng_next(&seed);
+    }
+
+    base_sender_job job = { &a, n, out0, out1, -1 };
+    pthread_t th;
+    pthread_create(&th, NULL, base_sender_main, &job);
+    int rc = gc_base_ot_recv(&b, n, choices, out);
+    pthread_join(th, NULL);
+
+    if (rc != 0 || job.rc != 0) {
+        fprintf(stderr, "base_ot: recv %d send %d\n", rc, job.rc);
+        failed = 1;
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            const gc_label *want = get_bit(choices, i) ? &out1[i] : &out0[i];
+            const gc_label *other = get_bit(choices, i) ? &out0[i] : &out1[i];
+            if (memcmp(out[i].b, want->b, GC_LABEL_BYTES) != 0 ||
+                memcmp(out[i].b, other->b, GC_LABEL_BYTES) == 0) {
+                fprintf(stderr, "base_ot: mismatch at %zu\n", i);
+                failed = 1;
+                break;
+            }
+        }
+    }
+
+    gc_channel_close(&a);
+    gc_channel_close(&b);
+    free(out0);
+    free(out1);
+    free(out);
+    return failed;
+}
+
+// IKNP: the sender runs on its own thread, sets up once and then makes
+// one send per entry of counts
+
+typedef struct {
+    gc_channel     *ch;
+    const size_t   *counts;
+    size_t          n_calls;
+    const gc_label *m0;
+    const gc_label *m1;       // NULL: the xor form with delta
+    const gc_label *delta;
+    int             rc;
+} ext_sender_job;
+
+static void *ext_sender_main(void *arg) {
+    ext_sender_job *job = (ext_sender_job *)arg;
+    gc_ot_sender *s = gc_ot_sender_create();
+    job->rc = s ? gc_ot_sender_setup(s, job->ch) : -3;
+    size_t off = 0;
+    for (size_t c = 0; c < job->n_calls && job->rc == 0; ++c) {
+        job->rc = job->m1
+            ? gc_ot_send(s, job->ch, job->m0 + off, job->m1 + off, job->counts[c])
+            : gc_ot_send_xor(s, job->ch, job->m0 + off, job->delta, job->counts[c]);
+        off += job->counts[c];
+    }
+    gc_ot_sender_destroy(s);
+    return NULL;
+}
+
+// counts[] OTs per call over a fresh in-memory or socketpair channel
+static int run_ext(const char *name, int use_socket, int xor_form,
+                   const size_t *counts, size_t n_calls) {
+    size_t n = 0;
+    for (size_t c = 0; c < n_calls; ++c) {
+        n += counts[c];
+    }
+    gc_channel a, b;
+    gc_label *m0 = (gc_label *)malloc(n * sizeof(gc_label));
+    gc_label *m1 = (gc_label *)malloc(n * sizeof(gc_label));
+    gc_label *out = (gc_label *)malloc(n * sizeof(gc_label));
+    uint8_t *choices = (uint8_t *)malloc(n / 8 + 1);
+    gc_label delta;
+    int failed = 0;
+
+    int ch_rc = use_socket ? gc_channel_socketpair(&a, &b) : gc_channel_mem_pair(&a, &b, 0);
+    if (!m0 || !m1 || !out || !choices || ch_rc != 0) {
+        fprintf(stderr, "%s: setup failed\n", name);
+        if (ch_rc == 0) {
+            gc_channel_close(&a);
+            gc_channel_close(&b);
+        }
+        free(m0);
+        free(m1);
+        free(out);
+        free(choices);
+        return 1;
+    }
+
+    fill_labels(m0, n, 1);
+    fill_labels(&delta, 1, 2);
+    if (xor_form) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < GC_LABEL_BYTES; ++j) {
+                m1[i].b[j] = (uint8_t)(m0[i].b[j] ^ delta.b[j]);
+            }
+        }
+    } else {
+        fill_labels(m1, n, 3);
+    }
+    uint64_t seed = 0x0123456789abcdefull ^ n;
+    for (size_t i = 0; i < n / 8 + 1; ++i) {
+        choices[i] = (uint8_t)rng_next(&seed);
+    }
+
+    ext_sender_job job = { &a, counts, n_calls, m0, xor_form ? NULL : m1, &delta, -1 };
+    pthread_t th;
+    pthread_create(&th, NULL, ext_sender_main, &job);
+
+    gc_ot_receiver *r = gc_ot_receiver_create();
+    int rc = r ? gc_ot_receiver_setup(r, &b) : -3;
+    size_t off = 0;
+    for (size_t c = 0; c < n_calls && rc == 0; ++c) {
+        // the offsets are multiples of 8, so each call's choices start on a byte
+        rc = gc_ot_recv(r, &b, choices + off / 8, counts[c], out + off);
+        off += counts[c];
+    }
+    gc_ot_receiver_destroy(r);
+    if (rc != 0) {
+        // let a sender blocked on us fail rather than hang the join
+        gc_channel_close(&b);
+    }
+    pthread_join(th, NULL);
+
+    if (rc != 0 || job.rc != 0) {
+        fprintf(stderr, "%s: recv %d send %d\n", name, rc, job.rc);
+        failed = 1;
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            const gc_label *want = get_bit(choices, i) ? &m1[i] : &m0[i];
+            if (memcmp(out[i].b, want->b, GC_LABEL_BYTES) != 0) {
+                fprintf(stderr, "%s: wrong label at %zu\n", name, i);
+                failed = 1;
+                break;
+            }
+        }
+        // past the base OTs, each OT costs 16 bytes up (rounded up to
+        // whole 128-OT blocks per batch) and 32 down
+        if (a.bytes_sent != b.bytes_received || a.bytes_received != b.bytes_sent ||
+            a.bytes_received < 16 * (uint64_t)n || a.bytes_sent < 32 * (uint64_t)n) {
+            fprintf(stderr, "%s: byte counters off\n", name);
+            failed = 1;
+        }
+    }
+
+    gc_channel_close(&a);
+    gc_channel_close(&b);
+    free(m0);
+    free(m1);
+    free(out);
+    free(choices);
+    return failed;
+}
+
+static int test_ext(void) {
+    int failed = 0;
+    const size_t one_block[] = { 128 };
+    const size_t ragged[] = { 1000, 8, 333 };
+    // more than one GC_OT_BATCH in a call, with a partial last batch
+    const size_t big[] = { (size_t)GC_OT_BATCH * 2 + 517 };
+
+    if (run_ext("ext_mem_one_block", 0, 0, one_block, 1) != 0) failed = 1;
+    if (run_ext("ext_mem_ragged", 0, 0, ragged, 3) != 0) failed = 1;
+    if (run_ext("ext_mem_ragged_xor", 0, 1, ragged, 3) != 0) failed = 1;
+    if (run_ext("ext_socket_big_xor", 1, 1, big, 1) != 0) failed = 1;
+    if (run_ext("ext_mem_big", 0, 0, big, 1) != 0) failed = 1;
+    return failed;
+}
+
+static int test_errors(void) {
+    int failed = 0;
+    gc_channel a, b;
+    gc_label l;
+    uint8_t choice = 1;
+
+    gc_ot_receiver *r = gc_ot_receiver_create();
+    gc_ot_sender *s = gc_ot_sender_create();
+    if (!r || !s || gc_channel_mem_pair(&a, &b, 64) != 0) {
+        fprintf(stderr, "ot_errors: setup failed\n");
+        gc_ot_receiver_destroy(r);
+        gc_ot_sender_destroy(s);
+        return 1;
+    }
+
+    if (gc_ot_recv(r, &b, &choice, 1, &l) != -1 || gc_ot_send_xor(s, &a, &l, &l, 1) != -1) {
+        fprintf(stderr, "ot_errors: extension ran without setup\n");
+        failed = 1;
+    }
+    if (gc_ot_recv(r, &b, NULL, 1, &l) != -1 || gc_ot_send(s, &a, &l, NULL, 1) != -1) {
+        fprintf(stderr, "ot_errors: null arguments accepted\n");
+        failed = 1;
+    }
+
+    // a peer that is gone fails the setup instead of blocking it
+    gc_channel_close(&a);
+    if (gc_ot_receiver_setup(r, &b) != -4) {
+        fprintf(stderr, "ot_errors: setup against a closed peer did not fail\n");
+        failed = 1;
+    }
+    gc_channel_close(&b);
+
+    gc_ot_receiver_destroy(r);
+    gc_ot_sender_destroy(s);
+    return failed;
+}
+
+int main(void) {
+    // a closed socket should fail the send, not kill the test
+    signal(SIGPIPE, SIG_IGN);
+
+    int failed = 0;
+    if (test_base_ot() != 0) failed = 1;
+    if (test_ext() != 0) failed = 1;
+    if (test_errors() != 0) failed = 1;
+
+    if (failed) {
+        fprintf(stderr, "gc_ot tests FAILED\n");
+        return 1;
+    }
+    printf("gc_ot tests PASSED\n");
+    return 0;
+}
@@ -0,0 +1,179 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <pthread.h>
+#include <signal.h>
+
+#include "gc_channel.h"
+#include "gc_ot.h"
+#include "psi_gc.h"
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static void fill_random(uint8_t *buf, size_t len, uint64_t *state) {
+    uint64_t x = *state;
+    for (size_t i = 0; i < len; i += 8) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        memcpy(buf + i, &x, (len - i < 8) ? len - i : 8);
+    }
+    *state = x;
+}
+
+typedef struct {
+    gc_channel     *ch;
+    const gc_label *m0;
+    gc_label        delta;
+    size_t          n;
+    double          setup_ms;
+    int             rc;
+} sender_job;
+
+static void *sender_main(void *arg) {
+    sender_job *job = (sender_job *)arg;
+    gc_ot_sender *s = gc_ot_sender_create();
+    double t0 = now_ms();
+    job->rc = s ? gc_ot_sender_setup(s, job->ch) : -3;
+    job->setup_ms = now_ms() - t0;
+    if (job->rc == 0) {
+        job->rc = gc_ot_send_xor(s, job->ch, job->m0, &job->delta, job->n);
+    }
+    gc_ot_sender_destroy(s);
+    return NULL;
+}
+
+typedef struct {
+    double   setup_ms;
+    double   ext_ms;
+    uint64_t up_bytes;      // receiver to sender
+    uint64_t down_bytes;
+} ot_run;
+
+// n free-XOR OTs, the form a garbler's input labels take, with the sender
+// on a second thread
+static int run_ots(int use_socket, size_t n, ot_run *res) {
+    gc_channel a, b;
+    gc_label *m0 = (gc_label *)malloc(n * sizeof(gc_label));
+    gc_label *out = (gc_label *)malloc(n * sizeof(gc_label));
+    uint8_t *choices = (uint8_t *)malloc(n / 8 + 1);
+    int ch_rc = use_socket ? gc_channel_socketpair(&a, &b) : gc_channel_mem_pair(&a, &b, 0);
+    if (!m0 || !out || !choices || ch_rc != 0) {
+        if (ch_rc == 0) {
+            gc_channel_close(&a);
+            gc_channel_close(&b);
+        }
+        free(m0);
+        free(out);
+        free(choices);
+        return -3;
+    }
+    uint64_t state = 0x243f6a8885a308d3ull ^ n;
+    fill_random((uint8_t *)m0, n * sizeof(gc_label), &state);
+    fill_random(choices, n / 8 + 1, &state);
+
+    sender_job job = { &a, m0, { { 0 } }, n, 0.0, -1 };
+    fill_random(job.delta.b, GC_LABEL_BYTES, &state);
+    pthread_t th;
+    pthread_create(&th, NULL, sender_main, &job);
+
+    gc_ot_receiver *r = gc_ot_receiver_create();
+    double t0 = now_ms();
+    int rc = r ? gc_ot_receiver_setup(r, &b) : -3;
+    double t1 = now_ms();
+    const uint64_t base_up = b.bytes_sent;
+    const uint64_t base_down = b.bytes_received;
+    if (rc == 0) {
+        rc = gc_ot_recv(r, &b, choices, n, out);
+    }
+    double t2 = now_ms();
+    gc_ot_receiver_destroy(r);
+    if (rc != 0) {
+        gc_channel_close(&b);
+    }
+    pthread_join(th, NULL);
+
+    res->setup_ms   = t1 - t0;
+    res->ext_ms     = t2 - t1;
+    res->up_bytes   = b.bytes_sent - base_up;
+    res->down_bytes = b.bytes_received - base_down;
+
+    gc_channel_close(&a);
+    gc_channel_close(&b);
+    free(m0);
+    free(out);
+    free(choices);
+    return rc != 0 ? rc : job.rc;
+}
+
+// OT extension throughput for 1M labels up to max_labels, in memory and
+// over a socketpair, then the input-label transfer a GC-PSI call of count
+// elements per side would need next to the time of the call itself: one
+// OT per evaluator input bit, count * psi_gc_digest_bits labels.
+// usage: test_gc_ot_bench [max_labels]
+int main(int argc, char **argv) {
+    size_t max_labels = 10000000;
+    if (argc > 1) {
+        max_labels = (size_t)strtoull(argv[1], NULL, 10);
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("IKNP OT extension (%d base OTs, batches of %u):\n", GC_OT_BASE, GC_OT_BATCH);
+    for (size_t n = 1000000; n <= max_labels; n *= 10) {
+        for (int use_socket = 0; use_socket < 2; ++use_socket) {
+            ot_run res;
+            int rc = run_ots(use_socket, n, &res);
+            printf("  labels=%-10zu %-10s setup %8.3f ms  extend %10.3f ms  %6.2f M OTs/s"
+                   "  up %7.1f MB  down %7.1f MB%s\n",
+                   n, use_socket ? "socketpair" : "memory", res.setup_ms, res.ext_ms,
+                   (double)n / (res.ext_ms * 1000.0), (double)res.up_bytes / 1.0e6,
+                   (double)res.down_bytes / 1.0e6, rc ? "  (failed)" : "");
+        }
+    }
+
+    printf("GC-PSI input transfer (sigma %d, in memory) vs psi_gc_compute:\n",
+           PSI_GC_DEFAULT_SIGMA);
+    const size_t elem_bytes = 16;
+    uint64_t state = 0x13198a2e03707344ull;
+    for (size_t count = 1000; count <= 100000; count *= 10) {
+        const size_t k = psi_gc_digest_bits(count, count, PSI_GC_DEFAULT_SIGMA);
+        const size_t labels = count * k;
+
+        ot_run res;
+        int rc = run_ots(0, labels, &res);
+
+        uint8_t *A = (uint8_t *)malloc(count * elem_bytes);
+        uint8_t *B = (uint8_t *)malloc(count * elem_bytes);
+        uint8_t *mask = (uint8_t *)malloc(count);
+        psi_gc_ctx *ctx = psi_gc_create(count, elem_bytes * 8);
+        double compute_ms = -1.0;
+        if (A && B && mask && ctx && psi_gc_set_sigma(ctx, PSI_GC_DEFAULT_SIGMA) == 0) {
+            fill_random(A, count * elem_bytes, &state);
+            fill_random(B, count * elem_bytes, &state);
+            double t0 = now_ms();
+            if (psi_gc_compute(ctx, A, B, count, mask) == 0) {
+                compute_ms = now_ms() - t0;
+            }
+        }
+        psi_gc_destroy(ctx);
+        free(A);
+        free(B);
+        free(mask);
+
+        printf("  count=%-8zu k=%-3zu labels=%-9zu OT %10.3f ms (+%.3f ms setup)"
+               "  %7.1f MB  compute %10.3f ms%s\n",
+               count, k, labels, res.ext_ms, res.setup_ms,
+               (double)(res.up_bytes + res.down_bytes) / 1.0e6, compute_ms,
+               rc ? "  (OT failed)" : "");
+    }
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gc_core.h"
+#include "gc_pool.h"
+
+#include "test_circuits.h"
+
+typedef struct {
+    uint64_t *per_item;
+    size_t    n_workers;
+    int       bad_worker;
+} pool_check;
+
+static void mark_items(void *ctx, size_t begin, size_t end, size_t worker) {
+    pool_check *pc = (pool_check *)ctx;
+    if (worker >= pc->n_workers) {
+        pc->bad_worker = 1;
+    }
+    for (size_t i = begin; i < end; ++i) {
+        pc->per_item[i] += i + 1;
+    }
+}
+
+// every item is visited exactly once, for sizes around the thread count
+static int test_pool_for(void) {
+    size_t sizes[] = { 1, 3, 7, 64, 1000, 100003 };
+    int failed = 0;
+
+    gc_pool *pool = gc_pool_create(4);
+    if (!pool) {
+        fprintf(stderr, "pool_for: gc_pool_create failed\n");
+        return 1;
+    }
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && !failed; ++s) {
+        for (size_t grain = 0; grain < 3 && !failed; ++grain) {
+            pool_check pc = { (uint64_t *)calloc(sizes[s], sizeof(uint64_t)),
+                              gc_pool_threads(pool), 0 };
+            if (!pc.per_item) {
+                failed = 1;
+                break;
+            }
+            gc_pool_for(pool, sizes[s], grain, mark_items, &pc);
+            for (size_t i = 0; i < sizes[s]; ++i) {
+                if (pc.per_item[i] != i + 1) {
+                    fprintf(stderr, "pool_for: n=%zu grain=%zu item %zu visited wrong\n",
+                            sizes[s], grain, i);
+                    failed = 1;
+                    break;
+                }
+            }
+            if (pc.bad_worker) {
+                fprintf(stderr, "pool_for: worker index out of range\n");
+                failed = 1;
+            }
+            free(pc.per_item);
+        }
+    }
+
+    gc_pool_destroy(pool);
+    return failed;
+}
+
+static int test_levelize(void) {
+    int failed = 0;
+    const gc_wire_id k = 16;
+    gc_circuit *chain = build_eq_chain(k);
+    gc_circuit *trees = build_eq_trees(8, k);
+    gc_levels lv;
+
+    // XORs, then NOTs, then k - 1 ANDs one after the other
+    if (!chain || gc_levelize(chain, &lv) != 0 || lv.n_levels != k + 1 ||
+        lv.level_start[1] != k || lv.level_start[2] != 2 * (size_t)k) {
+        fprintf(stderr, "levelize: eq chain levels wrong\n");
+        failed = 1;
+    }
+    gc_levels_free(&lv);
+
+    // XOR, NOT, then log2(k) AND layers
+    if (!trees || gc_levelize(trees, &lv) != 0 || lv.n_levels != 6 ||
+        lv.level_start[lv.n_levels] != trees->n_gates) {
+        fprintf(stderr, "levelize: eq tree levels wrong\n");
+        failed = 1;
+    } else {
+        // every gate lands after the gates producing its inputs
+        size_t *pos = (size_t *)calloc(trees->n_wires, sizeof(size_t));
+        for (size_t l = 0; pos && l < lv.n_levels; ++l) {
+            for (size_t i = lv.level_start[l]; i < lv.level_start[l + 1]; ++i) {
+                pos[trees->gates[lv.order[i]].out] = l + 1;
+            }
+        }
+        for (size_t l = 0; pos && l < lv.n_levels && !failed; ++l) {
+            for (size_t i = lv.level_start[l]; i < lv.level_start[l + 1]; ++i) {
+                const gc_gate *g = &trees->gates[lv.order[i]];
+                if (pos[g->in0] > l || (g->type != GC_GATE_NOT && pos[g->in1] > l)) {
+                    fprintf(stderr, "levelize: gate %zu before its inputs\n", lv.order[i]);
+                    failed = 1;
+                    break;
+                }
+            }
+        }
+        free(pos);
+    }
+    gc_levels_free(&lv);
+
+    // a wire written twice cannot be scheduled by level
+    if (chain) {
+        chain->gates[chain->n_gates - 1].out = chain->gates[0].out;
+        if (gc_levelize(chain, &lv) != -6) {
+            fprintf(stderr, "levelize: double assignment accepted\n");
+            failed = 1;
+        }
+        gc_levels_free(&lv);
+    }
+
+    gc_circuit_free(trees);
+    gc_circuit_free(chain);
+    return failed;
+}
+
+// with the same seed the parallel garbler must reproduce the sequential
+// one exactly, and parallel evaluation must decode to the right values
+static int check_parallel(gc_circuit *plain, gc_pool *pool, gc_garble_mode mode, const char *tag) {
+    uint8_t seed[GC_GARBLE_SEED_BYTES] = { 9, 8, 7 };
+    gc_garbled_circuit *seq = NULL, *par = NULL;
+    gc_evaluator *ev = gc_evaluator_create(0);
+    gc_label *in_labels = (gc_label *)malloc(plain->n_inputs * sizeof(gc_label));
+    gc_label *out_seq = (gc_label *)malloc(plain->n_outputs * sizeof(gc_label));
+    gc_label *out_par = (gc_label *)malloc(plain->n_outputs * sizeof(gc_label));
+    uint8_t *in_bits = (uint8_t *)malloc(plain->n_inputs);
+    uint8_t *expect = (uint8_t *)malloc(plain->n_outputs);
+    uint8_t *got = (uint8_t *)malloc(plain->n_outputs);
+    gc_levels lv;
+    memset(&lv, 0, sizeof(lv));
+    int failed = 0;
+
+    if (!ev || !in_labels || !out_seq || !out_par || !in_bits || !expect || !got ||
+        gc_garble_seeded(plain, mode, seed, &seq) != 0 ||
+        gc_garble_parallel(plain, mode, seed, pool, &par) != 0) {
+        fprintf(stderr, "%s: setup failed\n", tag);
+        failed = 1;
+        goto done;
+    }
+
+    if (memcmp(seq->wire_labels0, par->wire_labels0, seq->n_wires * sizeof(gc_label)) != 0 ||
+        memcmp(seq->wire_labels1, par->wire_labels1, seq->n_wires * sizeof(gc_label)) != 0 ||
+        memcmp(seq->gates, par->gates, seq->n_gates * sizeof(gc_garbled_gate)) != 0) {
+        fprintf(stderr, "%s: parallel garbling differs from sequential\n", tag);
+        failed = 1;
+        goto done;
+    }
+
+    gc_levelize_garbled(par, &lv);
+    for (int round = 0; round < 4 && !failed; ++round) {
+        for (gc_wire_id i = 0; i < plain->n_inputs; ++i) {
+            // equal halves in round 0, sparse differences afterwards
+            uint32_t x = (uint32_t)(i * 2654435761u) >> 7;
+            in_bits[i] = (uint8_t)(x & 1u);
+        }
+        if (round > 0) {
+            for (gc_wire_id i = (gc_wire_id)round; i < plain->n_inputs; i += 97) {
+                in_bits[i] ^= 1u;
+            }
+        }
+        for (gc_wire_id i = 0; i < plain->n_inputs; ++i) {
+            gc_wire_id w = par->input_wires[i];
+            in_labels[i] = in_bits[i] ? par->wire_labels1[w] : par->wire_labels0[w];
+        }
+        if (gc_eval_clear(plain, in_bits, expect) != 0 ||
+            gc_evaluator_eval(ev, par, in_labels, out_seq) != 0 ||
+            gc_evaluator_eval_parallel(ev, par, round & 1 ? NULL : &lv, pool,
+                                       in_labels, out_par) != 0 ||
+            gc_decode_outputs(par, out_par, got) != 0) {
+            fprintf(stderr, "%s: evaluation failed round=%d\n", tag, round);
+            failed = 1;
+            break;
+        }
+        if (memcmp(out_seq, out_par, plain->n_outputs * sizeof(gc_label)) != 0 ||
+            memcmp(expect, got, plain->n_outputs) != 0) {
+            fprintf(stderr, "%s: wrong outputs round=%d\n", tag, round);
+            failed = 1;
+        }
+    }
+
+done:
+    gc_levels_free(&lv);
+    free(got);
+    free(expect);
+    free(in_bits);
+    free(out_par);
+    free(out_seq);
+    free(in_labels);
+    gc_evaluator_destroy(ev);
+    gc_garbled_free(par);
+    gc_garbled_free(seq);
+    return failed;
+}
+
+static int test_parallel_garble_eval(void) {
+    int failed = 0;
+    gc_pool *pool = gc_pool_create(4);
+    gc_circuit *wide = build_eq_trees(256, 32);     // 256 to 8192 gates per level
+    gc_circuit *narrow = build_eq_chain(64);        // falls back to sequential
+
+    if (!pool || !wide || !narrow) {
+        fprintf(stderr, "parallel_garble_eval: setup failed\n");
+        failed = 1;
+    } else {
+        if (check_parallel(wide, pool, GC_GARBLE_HALF_GATES, "parallel wide half") != 0) failed = 1;
+        if (check_parallel(wide, pool, GC_GARBLE_CLASSIC, "parallel wide classic") != 0) failed = 1;
+        if (check_parallel(narrow, pool, GC_GARBLE_HALF_GATES, "parallel narrow") != 0) failed = 1;
+    }
+
+    gc_circuit_free(narrow);
+    gc_circuit_free(wide);
+    gc_pool_destroy(pool);
+    return failed;
+}
+
+int main(void) {
+    int failed = 0;
+    if (test_pool_for() != 0) failed = 1;
+    if (test_levelize() != 0) failed = 1;
+    if (test_parallel_garble_eval() != 0) failed = 1;
+
+    if (failed) {
+        fprintf(stderr, "gc_parallel tests FAILED\n");
+        return 1;
+    }
+    printf("gc_parallel tests PASSED\n");
+    return 0;
+}
@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "gc_core.h"
+
+#include "test_circuits.h"
+
+static int write_all(int fd, const void *buf, size_t len) {
+    const uint8_t *p = (const uint8_t *)buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n <= 0) {
+            return 1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int read_all(int fd, void *buf, size_t len) {
+    uint8_t *p = (uint8_t *)buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0) {
+            return 1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// garbler side. the evaluator's input labels stand in for what OT would
+// deliver; they go down the pipe ahead of the first table chunk.
+typedef struct {
+    const gc_circuit *plain;
+    gc_garble_mode    mode;
+    size_t            chunk_labels;
+    const uint8_t    *in_bits;
+    int               fd;
+    int               sent_inputs;
+    gc_label         *in0;
+    gc_label          out0;
+    gc_label          delta;
+    gc_stream_stats   stats;
+    int               rc;
+} garbler_job;
+
+static int pipe_sink(void *user, const gc_label *ct, size_t n_ct) {
+    garbler_job *job = (garbler_job *)user;
+    if (!job->sent_inputs) {
+        for (gc_wire_id i = 0; i < job->plain->n_inputs; ++i) {
+            gc_label l = job->in0[i];
+            if (job->in_bits[i]) {
+                for (size_t j = 0; j < GC_LABEL_BYTES; ++j) {
+                    l.b[j] ^= job->delta.b[j];
+                }
+            }
+            if (write_all(job->fd, &l, sizeof(l)) != 0) {
+                return 1;
+            }
+        }
+        job->sent_inputs = 1;
+    }
+    return write_all(job->fd, ct, n_ct * sizeof(gc_label));
+}
+
+static void *garbler_main(void *arg) {
+    garbler_job *job = (garbler_job *)arg;
+    job->rc = gc_garble_stream(job->plain, job->mode, NULL, job->chunk_labels, pipe_sink, job,
+                               job->in0, &job->out0, &job->delta, &job->stats);
+    close(job->fd);
+    return NULL;
+}
+
+static int pipe_source(void *user, gc_label *ct, size_t n_ct) {
+    return read_all(*(int *)user, ct, n_ct * sizeof(gc_label));
+}
+
+// garbles and evaluates k-bit equality concurrently on two threads joined
+// by a pipe, with different chunk sizes on the two ends
+static int run_pipe(gc_wire_id k, gc_garble_mode mode, int equal,
+                    size_t garbler_chunk, size_t eval_chunk) {
+    gc_circuit *plain = build_eq_chain(k);
+    uint8_t *in_bits = (uint8_t *)malloc(2 * (size_t)k);
+    gc_label *in0 = (gc_label *)malloc(2 * (size_t)k * sizeof(gc_label));
+    gc_label *in_labels = (gc_label *)malloc(2 * (size_t)k * sizeof(gc_label));
+    int fds[2] = { -1, -1 };
+    int failed = 0;
+
+    if (!plain || !in_bits || !in0 || !in_labels || pipe(fds) != 0) {
+        fprintf(stderr, "stream_pipe: setup failed\n");
+        failed = 1;
+        goto done;
+    }
+
+    for (gc_wire_id i = 0; i < k; ++i) {
+        in_bits[i] = (uint8_t)(((i * 29u + 3u) >> 2) & 1u);
+        in_bits[k + i] = (equal || i != k / 3) ? in_bits[i] : (uint8_t)(in_bits[i] ^ 1u);
+    }
+
+    garbler_job job;
+    memset(&job, 0, sizeof(job));
+    job.plain = plain;
+    job.mode = mode;
+    job.chunk_labels = garbler_chunk;
+    job.in_bits = in_bits;
+    job.fd = fds[1];
+    job.in0 = in0;
+
+    pthread_t th;
+    if (pthread_create(&th, NULL, garbler_main, &job) != 0) {
+        fprintf(stderr, "stream_pipe: pthread_create failed\n");
+        close(fds[1]);
+        failed = 1;
+        goto done;
+    }
+
+    gc_label out_label;
+    gc_stream_stats st;
+    int rc = read_all(fds[0], in_labels, 2 * (size_t)k * sizeof(gc_label));
+    if (rc == 0) {
+        rc = gc_eval_stream(plain, mode, eval_chunk, pipe_source, &fds[0],
+                            in_labels, &out_label, &st);
+    }
+    // unblocks the garbler if evaluation stopped early
+    close(fds[0]);
+    fds[0] = -1;
+    pthread_join(th, NULL);
+
+    uint8_t bit = 0xff, decode = 0xff, eval_bit = 0xff;
+    if (rc != 0 || job.rc != 0 ||
+        gc_stream_decode_outputs(1, &out_label, &job.out0, &job.delta, &bit) != 0) {
+        fprintf(stderr, "stream_pipe: k=%u mode=%d eval rc=%d garble rc=%d\n",
+                (unsigned)k, (int)mode, rc, job.rc);
+        failed = 1;
+    } else if (bit != (uint8_t)equal) {
+        fprintf(stderr, "stream_pipe: k=%u mode=%d equal=%d decoded %u\n",
+                (unsigned)k, (int)mode, equal, bit);
+        failed = 1;
+    } else if (gc_stream_decode_info(1, &job.out0, &decode) != 0 ||
+               gc_stream_decode_bits(1, &out_label, &decode, &eval_bit) != 0 ||
+               eval_bit != bit) {
+        fprintf(stderr, "stream_pipe: decode bits disagree with the garbler's decoding\n");
+        failed = 1;
+    } else if (st.num_ciphertexts != job.stats.num_ciphertexts ||
+               st.peak_live_labels != job.stats.peak_live_labels) {
+        fprintf(stderr, "stream_pipe: garbler and evaluator disagree on the stream\n");
+        failed = 1;
+    }
+
+done:
+    if (fds[0] >= 0) {
+        close(fds[0]);
+    }
+    free(in_labels);
+    free(in0);
+    free(in_bits);
+    gc_circuit_free(plain);
+    return failed;
+}
+
+static int test_stream_pipe(void) {
+    gc_garble_mode modes[] = { GC_GARBLE_CLASSIC, GC_GARBLE_HALF_GATES };
+    int failed = 0;
+    for (size_t m = 0; m < 2; ++m) {
+        for (int equal = 0; equal < 2; ++equal) {
+            if (run_pipe(128, modes[m], equal, 64, 6) != 0) failed = 1;
+            if (run_pipe(128, modes[m], equal, 5, 0) != 0) failed = 1;
+        }
+    }
+    // long enough that the pipe buffer fills and the garbler has to block
+    if (run_pipe(1u << 16, GC_GARBLE_HALF_GATES, 1, 0, 256) != 0) failed = 1;
+    return failed;
+}
+
+// an evaluator whose source runs dry must fail rather than read past it
+typedef struct {
+    const gc_label *ct;
+    size_t          n;
+} mem_source;
+
+static int read_mem(void *user, gc_label *ct, size_t n_ct) {
+    mem_source *src = (mem_source *)user;
+    if (n_ct > src->n) {
+        return 1;
+    }
+    memcpy(ct, src->ct, n_ct * sizeof(gc_label));
+    src->ct += n_ct;
+    src->n -= n_ct;
+    return 0;
+}
+
+static int test_stream_truncated(void) {
+    gc_circuit *plain = gc_circuit_eq_2bit();
+    gc_garbled_circuit *gc = NULL;
+    gc_packed_circuit *pc = NULL;
+    int failed = 0;
+
+    if (!plain || gc_garble(plain, &gc) != 0 || gc_pack_garbled(gc, &pc) != 0) {
+        fprintf(stderr, "stream_truncated: setup failed\n");
+        failed = 1;
+        goto done;
+    }
+
+    gc_label in_labels[4];
+    gc_label out_label;
+    for (gc_wire_id i = 0; i < 4; ++i) {
+        in_labels[i] = gc->wire_labels0[gc->input_wires[i]];
+    }
+
+    mem_source full = { pc->ciphertexts, pc->n_ciphertexts };
+    uint8_t bit = 0xff;
+    if (gc_eval_stream(plain, GC_GARBLE_HALF_GATES, 0, read_mem, &full, in_labels, &out_label, NULL) != 0 ||
+        gc_packed_decode_outputs(pc, &out_label, &bit) != 0 || bit != 1) {
+        fprintf(stderr, "stream_truncated: full stream did not evaluate\n");
+        failed = 1;
+    }
+
+    mem_source short_src = { pc->ciphertexts, pc->n_ciphertexts - 1 };
+    if (gc_eval_stream(plain, GC_GARBLE_HALF_GATES, 0, read_mem, &short_src, in_labels, &out_label, NULL) == 0) {
+        fprintf(stderr, "stream_truncated: short stream accepted\n");
+        failed = 1;
+    }
+
+done:
+    gc_packed_free(pc);
+    gc_garbled_free(gc);
+    gc_circuit_free(plain);
+    return failed;
+}
+
+int main(void) {
+    // a closed pipe should fail the write, not kill the test
+    signal(SIGPIPE, SIG_IGN);
+
+    int failed = 0;
+    if (test_stream_pipe() != 0) failed = 1;
+    if (test_stream_truncated() != 0) failed = 1;
+
+    if (failed) {
+        fprintf(stderr, "gc_stream tests FAILED\n");
+        return 1;
+    }
+    printf("gc_stream tests PASSED\n");
+    return 0;
+}
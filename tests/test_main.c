@@ -5,6 +5,9 @@
 
 #include "psi_gc.h"
 #include "psi_hash_blake3.h"
+#include "psi_bins.h"
+#include "psi_join.h"
+#include "gc_pool.h"
 
 #define HASH_BYTES PSI_BLAKE3_DIGEST_LEN
 
@@ -50,6 +53,29 @@ static int check_mask(const uint8_t *mask, const uint8_t *expected, size_t count
     return 1;
 }
 
+// every pair joins equal elements, and each element of A marked in ref
+// has exactly one pair
+static int check_pairs(const psi_pairs *pairs, const uint8_t *a, size_t na, const uint8_t *b,
+                       size_t nb, size_t elem_bytes, const uint8_t *ref) {
+    uint8_t *seen = (uint8_t *)calloc(na + 1, 1);
+    size_t expected = 0;
+    int bad = !seen;
+    for (size_t p = 0; p < pairs->len && !bad; ++p) {
+        const psi_pair *q = &pairs->items[p];
+        bad = q->a >= na || q->b >= nb || seen[q->a] ||
+              memcmp(a + (size_t)q->a * elem_bytes, b + (size_t)q->b * elem_bytes, elem_bytes) != 0;
+        if (!bad) {
+            seen[q->a] = 1;
+        }
+    }
+    for (size_t i = 0; i < na; ++i) {
+        expected += ref[i];
+    }
+    bad = bad || pairs->len != expected;
+    free(seen);
+    return bad;
+}
+
 static int run_random_like_test(psi_gc_ctx *ctx) {
     if (!ctx) {
         fprintf(stderr, "FAIL: ctx is NULL in random-like test\n");
@@ -105,6 +131,500 @@ static int run_random_like_test(psi_gc_ctx *ctx) {
     return failed ? 1 : 0;
 }
 
+// both modes, block sizes that divide count and ones that leave a tail
+// block, with repeated elements in B and elements not a multiple of 8 bits
+static int run_mode_tests(void) {
+    const size_t count = 37;
+    const size_t elem_bits = 20;
+    const size_t elem_bytes = 3;
+
+    uint8_t flat_a[37 * 3], flat_b[37 * 3], mask[37], ref[37];
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t a = (uint32_t)(i * 7 % 50) * 0x1357u;
+        uint32_t b = (uint32_t)(i * 3 % 29) * 0x1357u;
+        for (size_t j = 0; j < elem_bytes; ++j) {
+            flat_a[i * elem_bytes + j] = (uint8_t)(a >> (8 * j));
+            flat_b[i * elem_bytes + j] = (uint8_t)(b >> (8 * j));
+        }
+        // the unused top nibble must not matter
+        flat_a[i * elem_bytes + 2] &= 0x0f;
+        flat_b[i * elem_bytes + 2] &= 0x0f;
+    }
+    compute_reference_mask(flat_a, flat_b, count, elem_bytes, ref);
+
+    const struct { psi_gc_mode mode; size_t block; } cases[] = {
+        { PSI_GC_MODE_PAIRWISE, 0 },
+        { PSI_GC_MODE_BLOCK, 0 },
+        { PSI_GC_MODE_BLOCK, 1 },
+        { PSI_GC_MODE_BLOCK, 8 },
+        { PSI_GC_MODE_BLOCK, 37 },
+        { PSI_GC_MODE_CUCKOO, 0 },
+        { PSI_GC_MODE_CUCKOO, 1 },
+        { PSI_GC_MODE_CUCKOO, 3 },
+    };
+
+    int failed = 0;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c) {
+        psi_gc_ctx *ctx = psi_gc_create(count, elem_bits);
+        if (!ctx || psi_gc_set_mode(ctx, cases[c].mode, cases[c].block) != 0 ||
+            psi_gc_compute(ctx, flat_a, flat_b, count, mask) != 0) {
+            fprintf(stderr, "FAIL: mode test %zu did not run\n", c);
+            failed = 1;
+        } else if (!check_mask(mask, ref, count)) {
+            fprintf(stderr, "FAIL: mask mismatch in mode test %zu\n", c);
+            failed = 1;
+        }
+        psi_gc_destroy(ctx);
+    }
+
+    if (!failed) {
+        printf("PASS: mode tests\n");
+    }
+    return failed;
+}
+
+// a prepared context reused across calls of differing counts, with and
+// without a pre-garbled pool: each call takes one garbling from the pool,
+// smaller counts included, and the pool is topped up in between
+static int run_prepared_tests(void) {
+    const size_t count = 37;
+    const size_t elem_bits = 20;
+    const size_t elem_bytes = 3;
+
+    uint8_t flat_a[37 * 3], flat_b[37 * 3], mask[37], ref[37];
+    for (size_t i = 0; i < count * elem_bytes; ++i) {
+        flat_a[i] = (uint8_t)((i * 5) % 7);
+        flat_b[i] = (uint8_t)((i * 3) % 7);
+    }
+    const size_t counts[] = { 37, 37, 10, 37, 1 };
+
+    int failed = 0;
+    for (size_t pool = 0; pool <= 2; pool += 2) {
+        psi_gc_ctx *ctx = psi_gc_create(count, elem_bits);
+        if (!ctx || psi_gc_set_mode(ctx, PSI_GC_MODE_BLOCK, 8) != 0 ||
+            psi_gc_set_pregarbled(ctx, pool) != 0 ||
+            psi_gc_pregarble(ctx) != -2 ||
+            psi_gc_prepare_circuit(ctx) != 0 ||
+            psi_gc_pregarble(ctx) != (pool ? (int)pool : 1)) {
+            fprintf(stderr, "FAIL: prepare with pool %zu\n", pool);
+            psi_gc_destroy(ctx);
+            return 1;
+        }
+
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+            compute_reference_mask(flat_a, flat_b, counts[c], elem_bytes, ref);
+            if (psi_gc_compute(ctx, flat_a, flat_b, counts[c], mask) != 0 ||
+                !check_mask(mask, ref, counts[c])) {
+                fprintf(stderr, "FAIL: prepared call %zu with pool %zu\n", c, pool);
+                failed = 1;
+            }
+            if (pool && psi_gc_pregarbled_ready(ctx) != pool - 1) {
+                fprintf(stderr, "FAIL: prepared call %zu did not use the pool\n", c);
+                failed = 1;
+            }
+            psi_gc_pregarble(ctx);
+        }
+        psi_gc_destroy(ctx);
+    }
+
+    if (!failed) {
+        printf("PASS: prepared tests\n");
+    }
+    return failed;
+}
+
+// the partitioned join against the serial one, on a B large enough to be
+// partitioned, directly and through a context with threads set
+static int run_parallel_join_test(void) {
+    const size_t n = 16, count_a = 70000, count_b = 100000;
+
+    uint8_t *a = (uint8_t *)malloc(count_a * n);
+    uint8_t *b = (uint8_t *)malloc(count_b * n);
+    uint8_t *mask = (uint8_t *)malloc(count_a);
+    uint8_t *ref = (uint8_t *)malloc(count_a);
+    gc_pool *pool = gc_pool_create(4);
+    psi_gc_ctx *ctx = psi_gc_create(count_b, n * 8);
+    int failed = 0;
+    if (!a || !b || !mask || !ref || !pool || !ctx || psi_gc_set_threads(ctx, 3) != 0) {
+        fprintf(stderr, "FAIL: setup in parallel join test\n");
+        failed = 1;
+        goto done;
+    }
+
+    // 20 random bits per element, so B repeats itself and A hits often
+    for (size_t i = 0; i < count_b; ++i) {
+        memset(b + i * n, 0x5a, n);
+        uint32_t v = (uint32_t)rand() & 0xfffffu;
+        memcpy(b + i * n, &v, sizeof(v));
+    }
+    for (size_t i = 0; i < count_a; ++i) {
+        memset(a + i * n, 0x5a, n);
+        uint32_t v = (uint32_t)rand() & 0xfffffu;
+        memcpy(a + i * n, &v, sizeof(v));
+    }
+
+    if (psi_join_mask(a, count_a, b, count_b, n, ref) != 0 ||
+        psi_join_mask_parallel(a, count_a, b, count_b, n, pool, mask) != 0 ||
+        !check_mask(mask, ref, count_a)) {
+        fprintf(stderr, "FAIL: parallel join mismatch\n");
+        failed = 1;
+    }
+    // bits go through the same partitions as the mask
+    uint8_t *bits = mask;
+    if (psi_join_mask(a, count_a, b, count_b, n, ref) != 0 ||
+        psi_join_bits(a, count_a, b, count_b, n, pool, bits) != 0) {
+        fprintf(stderr, "FAIL: parallel join bits\n");
+        failed = 1;
+    }
+    for (size_t i = 0; i < count_a && !failed; ++i) {
+        if (((bits[i / 8] >> (i % 8)) & 1u) != ref[i]) {
+            fprintf(stderr, "FAIL: parallel join bits mismatch at %zu\n", i);
+            failed = 1;
+        }
+    }
+    psi_pairs pairs = { 0 };
+    if (!failed && (psi_join_pairs(a, count_a, b, count_b, n, pool, &pairs) != 0 ||
+                    check_pairs(&pairs, a, count_a, b, count_b, n, ref) != 0)) {
+        fprintf(stderr, "FAIL: parallel join pairs\n");
+        failed = 1;
+    }
+    psi_pairs_free(&pairs);
+    // the context joins count elements on each side
+    if (psi_join_mask(a, count_a, b, count_a, n, ref) != 0 ||
+        psi_hash_only_compute(ctx, a, b, count_a, mask) != 0 ||
+        !check_mask(mask, ref, count_a)) {
+        fprintf(stderr, "FAIL: threaded psi_hash_only_compute mismatch\n");
+        failed = 1;
+    }
+
+done:
+    psi_gc_destroy(ctx);
+    gc_pool_destroy(pool);
+    free(a);
+    free(b);
+    free(mask);
+    free(ref);
+    return failed;
+}
+
+// hash join against a nested loop: element sizes below, at and across a
+// 64-bit word, duplicates on both sides, more elements of B than of A and
+// enough of them to grow the table past one group
+static int run_join_tests(void) {
+    const size_t sizes[] = { 1, 3, 8, 16, 33 };
+    const size_t count_a = 300, count_b = 500;
+
+    uint8_t *a = (uint8_t *)malloc(count_a * 33);
+    uint8_t *b = (uint8_t *)malloc(count_b * 33);
+    uint8_t *mask = (uint8_t *)malloc(count_a);
+    uint8_t *ref = (uint8_t *)malloc(count_a);
+    if (!a || !b || !mask || !ref) {
+        fprintf(stderr, "FAIL: malloc in join tests\n");
+        free(a);
+        free(b);
+        free(mask);
+        free(ref);
+        return 1;
+    }
+
+    int failed = 0;
+    srand(4242);
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        const size_t n = sizes[s];
+        for (size_t i = 0; i < count_b * n; ++i) {
+            b[i] = (uint8_t)(rand() & 0x0f);
+        }
+        for (size_t i = 0; i < count_a; ++i) {
+            if (i % 3 == 0) {
+                memcpy(a + i * n, b + (size_t)(rand() % (int)count_b) * n, n);
+            } else {
+                for (size_t j = 0; j < n; ++j) {
+                    a[i * n + j] = (uint8_t)(rand() & 0x0f);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < count_a; ++i) {
+            ref[i] = 0;
+            for (size_t j = 0; j < count_b && !ref[i]; ++j) {
+                ref[i] = memcmp(a + i * n, b + j * n, n) == 0;
+            }
+        }
+        if (psi_join_mask(a, count_a, b, count_b, n, mask) != 0 ||
+            !check_mask(mask, ref, count_a)) {
+            fprintf(stderr, "FAIL: join mismatch for %zu-byte elements\n", n);
+            failed = 1;
+        }
+    }
+
+    if (psi_join_mask(a, count_a, b, 0, 16, mask) != 0 || mask[0] != 0 ||
+        psi_join_mask(a, count_a, b, count_b, 0, mask) != -1) {
+        fprintf(stderr, "FAIL: join edge cases\n");
+        failed = 1;
+    }
+
+    free(a);
+    free(b);
+    free(mask);
+    free(ref);
+    if (!failed) {
+        failed = run_parallel_join_test();
+    }
+    if (!failed) {
+        printf("PASS: join tests\n");
+    }
+    return failed;
+}
+
+// small A against a large B and the reverse, through the hash join and
+// the block and cuckoo garbled engines; the hash join builds on whichever
+// side is smaller
+// packed bits and the cardinality against a byte mask, through the
+// garbled engine or the hash join
+static int check_packed(psi_gc_ctx *ctx, int hash_only, const uint8_t *a, size_t na,
+                        const uint8_t *b, size_t nb, const uint8_t *ref) {
+    uint8_t bits[64];
+    size_t count = (size_t)-1, expected = 0;
+    memset(bits, 0xff, sizeof(bits));
+    int rc = hash_only ? psi_hash_only_compute_packed(ctx, a, na, b, nb, bits)
+                       : psi_gc_compute_packed(ctx, a, na, b, nb, bits);
+    if (rc != 0) {
+        return 1;
+    }
+    for (size_t i = 0; i < na; ++i) {
+        if (((bits[i / 8] >> (i % 8)) & 1u) != ref[i]) {
+            return 1;
+        }
+        expected += ref[i];
+    }
+    rc = hash_only ? psi_hash_only_cardinality(ctx, a, na, b, nb, &count)
+                   : psi_gc_cardinality(ctx, a, na, b, nb, &count);
+    return rc != 0 || count != expected;
+}
+
+static int run_asym_tests(void) {
+    const size_t elem_bits = 20, elem_bytes = 3, big = 400, small = 9;
+
+    uint8_t *a = (uint8_t *)malloc(big * elem_bytes);
+    uint8_t *b = (uint8_t *)malloc(big * elem_bytes);
+    uint8_t mask[400], ref[400];
+    psi_gc_ctx *ctx = psi_gc_create(big, elem_bits);
+    if (!a || !b || !ctx) {
+        fprintf(stderr, "FAIL: setup in asym tests\n");
+        free(a);
+        free(b);
+        psi_gc_destroy(ctx);
+        return 1;
+    }
+    for (size_t i = 0; i < big; ++i) {
+        uint32_t va = (uint32_t)(i * 13 % 97), vb = (uint32_t)(i * 5 % 211);
+        memcpy(a + i * elem_bytes, &va, elem_bytes);
+        memcpy(b + i * elem_bytes, &vb, elem_bytes);
+    }
+
+    const struct { size_t na, nb; } cases[] = {
+        { small, big }, { big, small }, { big, big }, { small, 0 },
+    };
+    psi_pairs pairs = { 0 };
+    int failed = 0;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c) {
+        const size_t na = cases[c].na, nb = cases[c].nb;
+        for (size_t i = 0; i < na; ++i) {
+            ref[i] = 0;
+            for (size_t j = 0; j < nb && !ref[i]; ++j) {
+                ref[i] = memcmp(a + i * elem_bytes, b + j * elem_bytes, elem_bytes) == 0;
+            }
+        }
+
+        memset(mask, 0xff, sizeof(mask));
+        if (psi_hash_only_compute_asym(ctx, a, na, b, nb, mask) != 0 ||
+            !check_mask(mask, ref, na)) {
+            fprintf(stderr, "FAIL: hash-only asym case %zu\n", c);
+            failed = 1;
+        }
+        if (psi_hash_only_compute_pairs(ctx, a, na, b, nb, &pairs) != 0 ||
+            check_pairs(&pairs, a, na, b, nb, elem_bytes, ref) != 0) {
+            fprintf(stderr, "FAIL: hash-only pairs case %zu\n", c);
+            failed = 1;
+        }
+        for (int cuckoo = 0; cuckoo <= 1; ++cuckoo) {
+            memset(mask, 0xff, sizeof(mask));
+            if (psi_gc_set_mode(ctx, cuckoo ? PSI_GC_MODE_CUCKOO : PSI_GC_MODE_BLOCK,
+                                cuckoo ? 0 : 64) != 0 ||
+                psi_gc_compute_asym(ctx, a, na, b, nb, mask) != 0 ||
+                !check_mask(mask, ref, na)) {
+                fprintf(stderr, "FAIL: gc asym case %zu (cuckoo %d)\n", c, cuckoo);
+                failed = 1;
+            }
+            if (check_packed(ctx, 0, a, na, b, nb, ref) != 0 ||
+                check_packed(ctx, 1, a, na, b, nb, ref) != 0) {
+                fprintf(stderr, "FAIL: packed/cardinality case %zu (cuckoo %d)\n", c, cuckoo);
+                failed = 1;
+            }
+            if (psi_gc_compute_pairs(ctx, a, na, b, nb, &pairs) != 0 ||
+                check_pairs(&pairs, a, na, b, nb, elem_bytes, ref) != 0) {
+                fprintf(stderr, "FAIL: gc pairs case %zu (cuckoo %d)\n", c, cuckoo);
+                failed = 1;
+            }
+        }
+    }
+    if (psi_gc_compute_asym(ctx, a, small, b, big + 1, mask) != -2 ||
+        psi_hash_only_compute_asym(ctx, a, big + 1, b, small, mask) != -2) {
+        fprintf(stderr, "FAIL: asym counts above max_elems accepted\n");
+        failed = 1;
+    }
+
+    psi_pairs_free(&pairs);
+    free(a);
+    free(b);
+    psi_gc_destroy(ctx);
+    if (!failed) {
+        printf("PASS: asym tests\n");
+    }
+    return failed;
+}
+
+// truncated digests: the width formula, the XOF prefix property, masks
+// equal to the full-width join on real digests, and a difference only
+// above the compared bits showing up as the (expected) false match
+static int run_sigma_tests(void) {
+    const size_t count = 300, elem_bytes = HASH_BYTES;
+    int failed = 0;
+
+    if (psi_gc_digest_bits(300, 500, 40) != 58 || psi_gc_digest_bits(1, 1, 40) != 40) {
+        fprintf(stderr, "FAIL: psi_gc_digest_bits\n");
+        failed = 1;
+    }
+    uint8_t full[HASH_BYTES], part[HASH_BYTES];
+    psi_blake3_hash_bytes((const uint8_t *)"xof", 3, full);
+    psi_blake3_hash_bytes_bits((const uint8_t *)"xof", 3, part, 58);
+    if (memcmp(full, part, 7) != 0 || part[7] != (full[7] & 0x03)) {
+        fprintf(stderr, "FAIL: 58-bit digest is not a prefix of the full one\n");
+        failed = 1;
+    }
+
+    uint8_t *a = (uint8_t *)malloc(count * elem_bytes);
+    uint8_t *b = (uint8_t *)malloc(count * elem_bytes);
+    uint8_t mask[300], ref[300];
+    psi_gc_ctx *ctx = psi_gc_create(count, elem_bytes * 8);
+    if (!a || !b || !ctx || psi_gc_set_sigma(ctx, PSI_GC_DEFAULT_SIGMA) != 0) {
+        fprintf(stderr, "FAIL: setup in sigma tests\n");
+        free(a);
+        free(b);
+        psi_gc_destroy(ctx);
+        return 1;
+    }
+    // every third element of A is in B
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t va = (i % 3 == 0) ? i + 1000 : i, vb = i + 1000;
+        psi_blake3_hash_bytes((const uint8_t *)&va, sizeof(va), a + i * elem_bytes);
+        psi_blake3_hash_bytes((const uint8_t *)&vb, sizeof(vb), b + i * elem_bytes);
+    }
+
+    for (int cuckoo = 0; cuckoo <= 1; ++cuckoo) {
+        memset(mask, 0xff, sizeof(mask));
+        if (psi_hash_only_compute(ctx, a, b, count, ref) != 0 ||
+            psi_gc_set_mode(ctx, cuckoo ? PSI_GC_MODE_CUCKOO : PSI_GC_MODE_BLOCK, 0) != 0 ||
+            psi_gc_compute(ctx, a, b, count, mask) != 0 || !check_mask(mask, ref, count)) {
+            fprintf(stderr, "FAIL: truncated gc mask (cuckoo %d)\n", cuckoo);
+            failed = 1;
+        }
+    }
+
+    // a[1] differs from b[0] only in its last byte, above the 58 bits. in
+    // block mode they meet (cuckoo bins hash the whole digest, so there
+    // they would not)
+    memcpy(a + elem_bytes, b, elem_bytes);
+    a[2 * elem_bytes - 1] ^= 0x80;
+    if (psi_gc_set_mode(ctx, PSI_GC_MODE_BLOCK, 0) != 0 ||
+        psi_gc_compute(ctx, a, b, count, mask) != 0 || mask[1] != 1 ||
+        psi_gc_set_sigma(ctx, 0) != 0 ||
+        psi_gc_compute(ctx, a, b, count, mask) != 0 || mask[1] != 0) {
+        fprintf(stderr, "FAIL: sigma does not truncate the comparison\n");
+        failed = 1;
+    }
+
+    // prepared for 300 x 300 (58 bits) with a pool, then called with 20 x 20
+    // (50 bits): the call takes a pooled garbling, and bit 55 is outside
+    // what it compares
+    psi_gc_destroy(ctx);
+    ctx = psi_gc_create(count, elem_bytes * 8);
+    memcpy(a + elem_bytes, b, elem_bytes);
+    a[elem_bytes + 6] ^= 0x80;
+    if (!ctx || psi_gc_set_sigma(ctx, PSI_GC_DEFAULT_SIGMA) != 0 ||
+        psi_gc_set_mode(ctx, PSI_GC_MODE_BLOCK, 0) != 0 ||
+        psi_gc_set_pregarbled(ctx, 2) != 0 || psi_gc_prepare_circuit(ctx) != 0 ||
+        psi_gc_compute(ctx, a, b, 20, mask) != 0 || psi_gc_pregarbled_ready(ctx) != 1) {
+        fprintf(stderr, "FAIL: narrower sigma call did not reuse the prepared pool\n");
+        failed = 1;
+    } else if (mask[1] != 1 || mask[2] != 0) {
+        fprintf(stderr, "FAIL: narrower sigma call compared the wrong bits\n");
+        failed = 1;
+    }
+
+    free(a);
+    free(b);
+    psi_gc_destroy(ctx);
+    if (!failed) {
+        printf("PASS: sigma tests\n");
+    }
+    return failed;
+}
+
+// every element of A lands in exactly one bin or the stash, and A made of
+// a few repeated values overflows its bins into the stash without losing
+// any match
+static int run_cuckoo_tests(void) {
+    const size_t count = 40, elem_bits = 16, elem_bytes = 2;
+
+    uint8_t a[40 * 2], b[40 * 2], mask[40], ref[40];
+    for (size_t i = 0; i < count; ++i) {
+        uint16_t va = (uint16_t)(i % 3 * 1000), vb = (uint16_t)(i * 500);
+        memcpy(a + i * elem_bytes, &va, elem_bytes);
+        memcpy(b + i * elem_bytes, &vb, elem_bytes);
+    }
+    compute_reference_mask(a, b, count, elem_bytes, ref);
+
+    int failed = 0;
+    psi_bins bins;
+    if (psi_bins_build(&bins, a, count, b, count, elem_bytes) != 0) {
+        fprintf(stderr, "FAIL: psi_bins_build\n");
+        return 1;
+    }
+    size_t seen[40] = { 0 };
+    for (size_t bin = 0; bin < bins.n_bins; ++bin) {
+        if (bins.bin_a[bin] != PSI_BINS_EMPTY) {
+            ++seen[bins.bin_a[bin]];
+        }
+    }
+    for (size_t s = 0; s < bins.n_stash; ++s) {
+        ++seen[bins.stash[s]];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        failed |= seen[i] != 1;
+    }
+    // three values, at most three bins each
+    failed |= bins.n_stash < count - 9;
+    failed |= bins.start_b[bins.n_bins] < count;
+    psi_bins_free(&bins);
+    if (failed) {
+        fprintf(stderr, "FAIL: cuckoo bins do not cover A exactly once\n");
+    }
+
+    psi_gc_ctx *ctx = psi_gc_create(count, elem_bits);
+    if (!ctx || psi_gc_set_mode(ctx, PSI_GC_MODE_CUCKOO, 2) != 0 ||
+        psi_gc_compute(ctx, a, b, count, mask) != 0 || !check_mask(mask, ref, count)) {
+        fprintf(stderr, "FAIL: mask mismatch with a stash\n");
+        failed = 1;
+    }
+    psi_gc_destroy(ctx);
+
+    if (!failed) {
+        printf("PASS: cuckoo tests\n");
+    }
+    return failed;
+}
+
 static int run_basic_tests(void) {
     const size_t max_elems = 8;
     const size_t elem_bits = HASH_BYTES * 8u;
@@ -243,5 +763,24 @@ static int run_basic_tests(void) {
 }
 
 int main(void) {
-    return run_basic_tests();
+    int failed = run_basic_tests();
+    if (run_mode_tests() != 0) {
+        failed = 1;
+    }
+    if (run_prepared_tests() != 0) {
+        failed = 1;
+    }
+    if (run_join_tests() != 0) {
+        failed = 1;
+    }
+    if (run_asym_tests() != 0) {
+        failed = 1;
+    }
+    if (run_cuckoo_tests() != 0) {
+        failed = 1;
+    }
+    if (run_sigma_tests() != 0) {
+        failed = 1;
+    }
+    return failed;
 }
@@ -39,48 +39,54 @@ int main(void) {
     fill_random(A, count * elem_bytes);
     fill_random(B, count * elem_bytes);
 
-    psi_gc_ctx *ctx = psi_gc_create(count, elem_bits);
-    if (!ctx) {
-        fprintf(stderr, "psi_bench: psi_gc_create returned NULL\n");
-        free(A);
-        free(B);
-        free(mask);
-        return 1;
-    }
-    if (psi_gc_prepare_circuit(ctx) != 0) {
-        fprintf(stderr, "psi_bench: psi_gc_prepare_circuit failed\n");
-        psi_gc_destroy(ctx);
-        free(A);
-        free(B);
-        free(mask);
-        return 1;
-    }
+    printf("PSI benchmark:\n");
+    printf("  count       = %zu\n", count);
+    printf("  elem_bytes  = %zu\n", elem_bytes);
 
-    double t0 = now_ms();
-    int rc = psi_gc_compute(ctx, A, B, count, mask);
-    double t1 = now_ms();
-    psi_gc_destroy(ctx);
+    // the sigma rows compare psi_gc_digest_bits(count, count, 40) bits
+    const struct { psi_gc_mode mode; size_t sigma; const char *name; } modes[] = {
+        { PSI_GC_MODE_CUCKOO,   0,                    "cuckoo" },
+        { PSI_GC_MODE_CUCKOO,   PSI_GC_DEFAULT_SIGMA, "cuckoo/40" },
+        { PSI_GC_MODE_BLOCK,    0,                    "block" },
+        { PSI_GC_MODE_BLOCK,    PSI_GC_DEFAULT_SIGMA, "block/40" },
+        { PSI_GC_MODE_PAIRWISE, 0,                    "pairwise" },
+    };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        psi_gc_ctx *ctx = psi_gc_create(count, elem_bits);
+        if (!ctx || psi_gc_set_mode(ctx, modes[m].mode, 0) != 0 ||
+            psi_gc_set_sigma(ctx, modes[m].sigma) != 0 ||
+            psi_gc_prepare_circuit(ctx) != 0) {
+            fprintf(stderr, "psi_bench: context setup failed\n");
+            psi_gc_destroy(ctx);
+            free(A);
+            free(B);
+            free(mask);
+            return 1;
+        }
 
-    if (rc != 0) {
-        fprintf(stderr, "psi_bench: psi_gc_compute rc=%d\n", rc);
-        free(A);
-        free(B);
-        free(mask);
-        return 1;
-    }
+        double t0 = now_ms();
+        int rc = psi_gc_compute(ctx, A, B, count, mask);
+        double t1 = now_ms();
+        psi_gc_destroy(ctx);
 
-    size_t inter = 0;
-    for (size_t i = 0; i < count; ++i) {
-        if (mask[i]) {
-            inter++;
+        if (rc != 0) {
+            fprintf(stderr, "psi_bench: psi_gc_compute rc=%d\n", rc);
+            free(A);
+            free(B);
+            free(mask);
+            return 1;
         }
-    }
 
-    printf("PSI benchmark:\n");
-    printf("  count       = %zu\n", count);
-    printf("  elem_bytes  = %zu\n", elem_bytes);
-    printf("  time_ms     = %.3f\n", t1 - t0);
-    printf("  intersection= %zu\n", inter);
+        size_t inter = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (mask[i]) {
+                inter++;
+            }
+        }
+
+        printf("  %-10s time_ms = %.3f  intersection = %zu\n",
+               modes[m].name, t1 - t0, inter);
+    }
 
     free(A);
     free(B);
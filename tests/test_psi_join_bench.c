@@ -0,0 +1,111 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <unistd.h>
+
+#include "gc_pool.h"
+#include "psi_join.h"
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+// xorshift, so filling 100M digests does not take longer than joining them
+static void fill_random(uint8_t *buf, size_t len, uint64_t *state) {
+    uint64_t x = *state;
+    for (size_t i = 0; i < len; i += 8) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        memcpy(buf + i, &x, (len - i < 8) ? len - i : 8);
+    }
+    *state = x;
+}
+
+// joins count random 16-byte digests against count others, half of A drawn
+// from B, for count = 1K, 10K, ... up to max_count. the nested loop it
+// replaced is timed too while it stays under a few seconds, and the
+// partitioned join on 2, 4, ... threads.
+// usage: test_psi_join_bench [max_count] [max_threads]
+int main(int argc, char **argv) {
+    const size_t elem_bytes = 16;
+    size_t max_count = 10000000;
+    if (argc > 1) {
+        max_count = (size_t)strtoull(argv[1], NULL, 10);
+    }
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc > 2) {
+        n_cpus = strtol(argv[2], NULL, 10);
+    }
+    if (n_cpus < 1) {
+        n_cpus = 1;
+    }
+
+    printf("Hash join benchmark (16-byte digests, half of A in B):\n");
+    uint64_t state = 0x243f6a8885a308d3ull;
+    for (size_t count = 1000; count <= max_count; count *= 10) {
+        uint8_t *A = (uint8_t *)malloc(count * elem_bytes);
+        uint8_t *B = (uint8_t *)malloc(count * elem_bytes);
+        uint8_t *mask = (uint8_t *)malloc(count);
+        if (!A || !B || !mask) {
+            fprintf(stderr, "psi_join_bench: malloc failed at %zu\n", count);
+            free(A);
+            free(B);
+            free(mask);
+            return 1;
+        }
+        fill_random(A, count * elem_bytes, &state);
+        fill_random(B, count * elem_bytes, &state);
+        for (size_t i = 0; i < count; i += 2) {
+            memcpy(A + i * elem_bytes, B + ((i * 7) % count) * elem_bytes, elem_bytes);
+        }
+
+        double t0 = now_ms();
+        int rc = psi_join_mask(A, count, B, count, elem_bytes, mask);
+        double t1 = now_ms();
+
+        size_t inter = 0;
+        for (size_t i = 0; i < count; ++i) {
+            inter += mask[i];
+        }
+        printf("  count=%-10zu join %10.3f ms  %7.1f M elems/s  intersection=%zu%s",
+               count, t1 - t0, (double)(2 * count) / ((t1 - t0) * 1000.0), inter,
+               rc ? "  (join failed)" : "");
+
+        if (count <= 10000) {
+            double t2 = now_ms();
+            for (size_t i = 0; i < count; ++i) {
+                uint8_t found = 0;
+                for (size_t j = 0; j < count && !found; ++j) {
+                    found = memcmp(A + i * elem_bytes, B + j * elem_bytes, elem_bytes) == 0;
+                }
+                mask[i] = found;
+            }
+            double t3 = now_ms();
+            printf("  nested loop %10.3f ms", t3 - t2);
+        }
+        printf("\n");
+
+        for (long t = 2; t <= n_cpus; t *= 2) {
+            gc_pool *pool = gc_pool_create((size_t)t);
+            double t4 = now_ms();
+            rc = psi_join_mask_parallel(A, count, B, count, elem_bytes, pool, mask);
+            double t5 = now_ms();
+            gc_pool_destroy(pool);
+            printf("    threads=%-3ld %10.3f ms  speedup %.2fx%s\n",
+                   t, t5 - t4, (t1 - t0) / (t5 - t4), rc ? "  (join failed)" : "");
+        }
+
+        free(A);
+        free(B);
+        free(mask);
+    }
+    return 0;
+}
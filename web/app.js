@@ -5,8 +5,8 @@
 //   - Optionally auto-generate N random items for both sides.
 //   - Hash each item with keyed BLAKE3 (via WASM) expanded to 16 bytes.
 //   - Call two PSI flavors in WASM:
-//       * psi_hash_only_compute  (naive O(n^2) memcmp PSI)
-//       * psi_gc_compute         (GC-backed equality)
+//       * psi_hash_only_compute_asym  (hash-join PSI on the digests)
+//       * psi_gc_compute_asym         (GC-backed equality)
 //   - Compare masks for consistency and show timings.
 
 // Emscripten was built with -s MODULARIZE=1, so `Module` is a factory
@@ -181,9 +181,12 @@ async function runPsiDemo() {
     return;
   }
 
-  const count = Math.min(setA.length, setB.length);
-  countUsedSpan.textContent = String(count);
-  if (countUsedGcSpan) countUsedGcSpan.textContent = String(count);
+  // The sets keep their own sizes; Alice's mask has one entry per item of A.
+  const countA = setA.length;
+  const countB = setB.length;
+  const countsText = countA + " / " + countB;
+  countUsedSpan.textContent = countsText;
+  if (countUsedGcSpan) countUsedGcSpan.textContent = countsText;
 
   btnRun.disabled = true;
     outHash.textContent = "(Running...)";
@@ -241,57 +244,38 @@ async function runPsiDemo() {
       return;
     }
 
-    const bytesA = new Uint8Array(count * elemBytes);
-    const bytesB = new Uint8Array(count * elemBytes);
-
     const encoder = new TextEncoder();
 
     // Hash each element independently with keyed BLAKE3 in WASM.
-    for (let i = 0; i < count; i++) {
-      const msgA = encoder.encode(setA[i]);
-      const msgB = encoder.encode(setB[i]);
-
-      const lenA = msgA.length;
-      const lenB = msgB.length;
-
-      let inAPtr = 0;
-      let inBPtr = 0;
-
-      if (lenA > 0) {
-        inAPtr = malloc(lenA);
-        wasm.HEAPU8.set(msgA, inAPtr);
+    const hashSet = (set) => {
+      const bytes = new Uint8Array(set.length * elemBytes);
+      const outPtr = malloc(elemBytes);
+      for (let i = 0; i < set.length; i++) {
+        const msg = encoder.encode(set[i]);
+        const len = msg.length;
+
+        let inPtr = 0;
+        if (len > 0) {
+          inPtr = malloc(len);
+          wasm.HEAPU8.set(msg, inPtr);
+        }
+
+        // Call C function: void psi_blake3_hash_bytes(uint8_t* data, size_t len, uint8_t* out)
+        blake3HashBytes(inPtr, len, outPtr);
+        bytes.set(wasm.HEAPU8.subarray(outPtr, outPtr + elemBytes), i * elemBytes);
+
+        if (inPtr) free(inPtr);
       }
+      free(outPtr);
+      return bytes;
+    };
 
-      if (lenB > 0) {
-        inBPtr = malloc(lenB);
-        wasm.HEAPU8.set(msgB, inBPtr);
-      }
-
-      const outAPtr = malloc(elemBytes);
-      const outBPtr = malloc(elemBytes);
-
-      // Call C function: void psi_blake3_hash_bytes(uint8_t* data, size_t len, uint8_t* out)
-      blake3HashBytes(inAPtr, lenA, outAPtr);
-      blake3HashBytes(inBPtr, lenB, outBPtr);
-
-      bytesA.set(
-        wasm.HEAPU8.subarray(outAPtr, outAPtr + elemBytes),
-        i * elemBytes
-      );
-      bytesB.set(
-        wasm.HEAPU8.subarray(outBPtr, outBPtr + elemBytes),
-        i * elemBytes
-      );
-
-      if (inAPtr) free(inAPtr);
-      if (inBPtr) free(inBPtr);
-      free(outAPtr);
-      free(outBPtr);
-    }
+    const bytesA = hashSet(setA);
+    const bytesB = hashSet(setB);
 
     const sizeA = bytesA.length;
     const sizeB = bytesB.length;
-    const maskBytes = count;
+    const maskBytes = countA;
 
     const ptrA = malloc(sizeA);
     const ptrB = malloc(sizeB);
@@ -304,16 +288,21 @@ async function runPsiDemo() {
     const psi_create  = wasm.cwrap("psi_gc_create", "number", ["number","number"]);
     const psi_destroy = wasm.cwrap("psi_gc_destroy", null, ["number"]);
     const psi_prepare = wasm.cwrap("psi_gc_prepare_circuit", "number", ["number"]);
-    const psi_hash    = wasm.cwrap("psi_hash_only_compute", "number",
-                                     ["number","number","number","number","number"]);
-    const psi_gc      = wasm.cwrap("psi_gc_compute", "number",
-                                     ["number","number","number","number","number"]);
+    const psi_sigma   = wasm.cwrap("psi_gc_set_sigma", "number", ["number","number"]);
+    const psi_hash    = wasm.cwrap("psi_hash_only_compute_asym", "number",
+                                     ["number","number","number","number","number","number"]);
+    const psi_gc      = wasm.cwrap("psi_gc_compute_asym", "number",
+                                     ["number","number","number","number","number","number"]);
 
-    const ctx = psi_create(count, elemBits);
+    const ctx = psi_create(Math.max(countA, countB), elemBits);
     if (!ctx) {
       throw new Error("psi_gc_create returned NULL");
     }
 
+    // The digests are uniformly random, so the GC path only needs to compare
+    // 40 + log2(countA) + log2(countB) of their bits.
+    psi_sigma(ctx, 40);
+
     const prep_rc = psi_prepare(ctx);
     if (prep_rc !== 0) {
       psi_destroy(ctx);
@@ -325,23 +314,23 @@ async function runPsiDemo() {
     const tHashStart = performance.now();
     let rcHash = 0;
     for (let i = 0; i < hashReps; i++) {
-      rcHash = psi_hash(ctx, ptrA, ptrB, count, ptrMaskHash);
+      rcHash = psi_hash(ctx, ptrA, countA, ptrB, countB, ptrMaskHash);
     }
     const tHashEnd = performance.now();
 
     if (rcHash !== 0) {
       psi_destroy(ctx);
-      throw new Error("psi_hash_only_compute failed with code " + rcHash);
+      throw new Error("psi_hash_only_compute_asym failed with code " + rcHash);
     }
 
     // GC-backed PSI
     const tGcStart = performance.now();
-    const rcGc = psi_gc(ctx, ptrA, ptrB, count, ptrMaskGc);
+    const rcGc = psi_gc(ctx, ptrA, countA, ptrB, countB, ptrMaskGc);
     const tGcEnd = performance.now();
 
     if (rcGc !== 0) {
       psi_destroy(ctx);
-      throw new Error("psi_gc_compute failed with code " + rcGc);
+      throw new Error("psi_gc_compute_asym failed with code " + rcGc);
     }
 
     const maskHash = new Uint8Array(wasm.HEAPU8.buffer, ptrMaskHash, maskBytes).slice();
@@ -355,7 +344,7 @@ async function runPsiDemo() {
 
     // Check consistency between methods.
     let mismatch = false;
-    for (let i = 0; i < count; i++) {
+    for (let i = 0; i < countA; i++) {
       if (maskHash[i] !== maskGc[i]) {
         mismatch = true;
         break;
@@ -376,7 +365,7 @@ async function runPsiDemo() {
     }
 
     const intersection = [];
-    for (let i = 0; i < count; i++) {
+    for (let i = 0; i < countA; i++) {
       if (maskHash[i] === 1) {
         intersection.push(setA[i]);
       }